@@ -0,0 +1,147 @@
+#include "arena.h"
+#include "generals.h"
+#include "assemblyStats.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* a union of the types with the strictest alignment - every allocation is aligned to its size */
+union ArenaAlignment{
+    long l;
+    double d;
+    void *p;
+};
+
+/* round a size up to a multiple of the alignment */
+#define ALIGN(size) (((size) + sizeof(union ArenaAlignment) - 1) / sizeof(union ArenaAlignment) * sizeof(union ArenaAlignment))
+
+/* the memory handed out of a block starts after its aligned header */
+#define BLOCK_DATA(block) ((char *)(block) + ALIGN(sizeof(struct ArenaBlock)))
+
+/* Input: an arena and the size of the allocation.
+ * Output: returns the allocated memory, or NULL if the allocation failed.
+ *
+ * Algorithm: round the size up to the alignment. Starting at the current block, find the first block with enough room
+ * left - after a reset, these are the blocks of the previous use of the arena. If there is none, allocate a block of
+ * ARENA_BLOCK_SIZE bytes (or of the size, if it is larger) and link it right after the current one. Then, make the
+ * block the current one and hand out the next bytes of it.
+ */
+void *arena_alloc(Arena *arena, size_t size){
+    struct ArenaBlock *block;
+    void *memory;
+
+    size = ALIGN(size);
+
+    for (block = arena->current; block != NULL && block->size - block->used < size; block = block->next);
+
+    if (block == NULL){ /* no block has enough room */
+        size_t block_size = (size > ARENA_BLOCK_SIZE) ? size : ARENA_BLOCK_SIZE;
+
+        block = (struct ArenaBlock *)counted_malloc(ALIGN(sizeof(struct ArenaBlock)) + block_size);
+        RETURN_IF_MEMORY_ALLOC_ERROR(block, NULL)
+
+        block->size = block_size;
+        block->used = 0;
+
+        if (arena->current == NULL){ /* the first block of the arena */
+            block->next = arena->blocks;
+            arena->blocks = block;
+        } else{
+            block->next = arena->current->next;
+            arena->current->next = block;
+        }
+    }
+
+    arena->current = block;
+    memory = BLOCK_DATA(block) + block->used;
+    block->used += size;
+
+    return memory;
+}
+
+/* Input: an arena, the amount of elements and the size of each.
+ * Output: returns the allocated memory, all set to zero, or NULL if the allocation failed.
+ *
+ * Algorithm: allocate the memory out of the arena, and set it to zero if the allocation succeeded.
+ */
+void *arena_calloc(Arena *arena, size_t amount, size_t size){
+    void *memory = arena_alloc(arena, amount * size);
+
+    if (memory != NULL){
+        memset(memory, 0, amount * size);
+    }
+
+    return memory;
+}
+
+/* Input: an arena, a string that is not necessarily terminated, and its length.
+ * Output: returns a terminated copy of the first length chars of the string, or NULL if the allocation failed.
+ *
+ * Algorithm: allocate room for the chars and the '\0' out of the arena, then copy the chars and terminate the copy.
+ */
+char *arena_copy_string(Arena *arena, char *s, size_t length){
+    char *copy = (char *)arena_alloc(arena, length + 1);
+    RETURN_IF_MEMORY_ALLOC_ERROR(copy, NULL)
+
+    memcpy(copy, s, length);
+    copy[length] = '\0';
+
+    return copy;
+}
+
+/* Input: an arena.
+ * Output: returns nothing.
+ *
+ * Algorithm: mark every block as unused, and make the first block the current one.
+ */
+void reset_arena(Arena *arena){
+    struct ArenaBlock *block;
+
+    for (block = arena->blocks; block != NULL; block = block->next){
+        block->used = 0;
+    }
+
+    arena->current = arena->blocks;
+}
+
+/* Input: an arena, and the amount of bytes of blocks to keep.
+ * Output: returns nothing.
+ *
+ * Algorithm: reset the arena. Count the sizes of the blocks in the order they are filled, and cut the list before the
+ * first block that doesn't fit in the amount to keep. Free the blocks from there on.
+ */
+void trim_arena(Arena *arena, size_t keep){
+    struct ArenaBlock **link = &arena->blocks, *block, *next;
+    size_t kept = 0;
+
+    reset_arena(arena);
+
+    while (*link != NULL && kept + (*link)->size <= keep){
+        kept += (*link)->size;
+        link = &(*link)->next;
+    }
+
+    for (block = *link, *link = NULL; block != NULL; block = next){
+        next = block->next;
+        free(block);
+    }
+
+    arena->current = arena->blocks;
+}
+
+/* Input: an arena.
+ * Output: returns nothing.
+ *
+ * Algorithm: free the blocks one by one, then mark the arena as empty.
+ */
+void free_arena(Arena *arena){
+    struct ArenaBlock *block = arena->blocks, *next;
+
+    while (block != NULL){
+        next = block->next;
+        free(block);
+        block = next;
+    }
+
+    arena->blocks = NULL;
+    arena->current = NULL;
+}
@@ -0,0 +1,68 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+/* the amount of bytes in a block of an arena. A larger allocation gets a block of its own */
+#define ARENA_BLOCK_SIZE 65536
+
+/* a block of an arena. The memory handed out follows the header */
+struct ArenaBlock{
+    struct ArenaBlock *next; /* the next block of the arena */
+    size_t size; /* the amount of bytes that follow the header */
+    size_t used; /* the amount of bytes already handed out */
+};
+
+/* a bump allocator: memory is handed out of large blocks, one after the other, and is never freed on its own - the
+ * whole arena is reset or freed at once. An arena filled with zeros is a valid empty arena */
+struct Arena{
+    struct ArenaBlock *blocks; /* all the blocks of the arena, in the order they are filled */
+    struct ArenaBlock *current; /* the block allocations are made from. NULL before the first allocation */
+};
+
+typedef struct Arena Arena;
+
+/* Input: an arena and the size of the allocation.
+ * Output: returns the allocated memory, or NULL if the allocation failed.
+ *
+ * This function allocates memory out of the received arena, aligned for any type. The memory is valid until the
+ * arena is reset or freed.
+ */
+void *arena_alloc(Arena *arena, size_t size);
+
+/* Input: an arena, the amount of elements and the size of each.
+ * Output: returns the allocated memory, all set to zero, or NULL if the allocation failed.
+ *
+ * This function allocates memory out of the received arena, just like calloc.
+ */
+void *arena_calloc(Arena *arena, size_t amount, size_t size);
+
+/* Input: an arena, a string that is not necessarily terminated, and its length.
+ * Output: returns a terminated copy of the first length chars of the string, or NULL if the allocation failed.
+ */
+char *arena_copy_string(Arena *arena, char *s, size_t length);
+
+/* Input: an arena.
+ * Output: returns nothing.
+ *
+ * This function releases everything allocated out of the received arena at once. The blocks are kept, so the arena
+ * may be used again without allocating them.
+ */
+void reset_arena(Arena *arena);
+
+/* Input: an arena, and the amount of bytes of blocks to keep.
+ * Output: returns nothing.
+ *
+ * This function resets the received arena, and frees its blocks beyond the first ones that hold at most the received
+ * amount of bytes - so an arena kept for later doesn't hold on to the memory of its largest use.
+ */
+void trim_arena(Arena *arena, size_t keep);
+
+/* Input: an arena.
+ * Output: returns nothing.
+ *
+ * This function frees all the blocks of the received arena. The arena is left empty, ready to be used again.
+ */
+void free_arena(Arena *arena);
+
+#endif
@@ -1,61 +1,127 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include "firstScan.h"
+#include "assemblyJobs.h"
+#include "assemblyServer.h"
+
+/* the option that sets the amount of files assembled concurrently */
+#define JOBS_OPTION "-j"
+
+/* the options that print the statistics of every file - readable, or as JSON */
+#define STATS_OPTION "--stats"
+#define JSON_STATS_OPTION "--stats=json"
+
+/* the option that builds a binary object file besides the text files */
+#define BINARY_OPTION "--binary"
+
+/* the option that builds a listing file besides the text files */
+#define LISTING_OPTION "--listing"
+
+/* the option that prints the errors and warnings as JSON objects, one per line */
+#define JSON_DIAGNOSTICS_OPTION "--diagnostics=json"
+
+/* the option that stops assembling a file once it has that many errors */
+#define MAX_ERRORS_OPTION "--max-errors"
+
+/* the option that keeps the results of the files in a cache directory, and restores the files that didn't change */
+#define CACHE_OPTION "--cache"
+
+/* the option that runs the assembler as a server, which assemblerClient sends the files to */
+#define SERVE_OPTION "--serve"
+
+#define USAGE "Usage: assembler [-j N] [--stats | --stats=json] [--binary] [--listing] [--diagnostics=json]" \
+              " [--max-errors N] [--cache DIR] file1 file2....\n" \
+              "       assembler [-j N] --serve\n"
 
 int main(int argc, char *argv[]) {
 
-    FILE *fp; /* holds the current file */
-    char *filename = (char *) malloc(sizeof(char) * MAX_FILENAME_LENGTH);
+    char **bases; /* the base filenames, in the order they are assembled */
+    int amount = 0, workers = 0, first = 1; /* first is the index of the first filename in argv */
+    int serve = 0; /* whether the files are received from the clients. The amount of workers is 0 unless -j sets it */
+    enum stats_format format = NO_STATS; /* the format to print the statistics in */
+    unsigned int outputs = 0; /* the optional output files to build */
+    unsigned int max_errors = 0; /* the amount of errors after which a file is not checked any further - no limit */
+    char *cache_dir = NULL; /* the directory of the build cache, if one was requested */
+    BuildCache cache;
 
-    /* the table to hold the different commands and their properties. Use static to automatically initialize the array */
-    Table *commands_table = (Table *)malloc(sizeof(Table));
+    for (; first < argc && argv[first][0] == '-'; first++){ /* read the options, which precede the filenames */
+        if (strcmp(argv[first], STATS_OPTION) == 0){
+            format = TEXT_STATS;
+        } else if (strcmp(argv[first], JSON_STATS_OPTION) == 0){
+            format = JSON_STATS;
+        } else if (strcmp(argv[first], SERVE_OPTION) == 0){ /* the files are received from the clients */
+            serve = 1;
+        } else if (strcmp(argv[first], CACHE_OPTION) == 0 && first + 1 < argc){
+            cache_dir = argv[++first];
+        } else if (strcmp(argv[first], BINARY_OPTION) == 0){
+            outputs |= BINARY_OBJECT_OUTPUT;
+        } else if (strcmp(argv[first], LISTING_OPTION) == 0){
+            outputs |= LISTING_OUTPUT;
+        } else if (strcmp(argv[first], JSON_DIAGNOSTICS_OPTION) == 0){
+            outputs |= JSON_DIAGNOSTICS_OUTPUT;
+        } else if (strcmp(argv[first], MAX_ERRORS_OPTION) == 0 && first + 1 < argc){
+            if (atoi(argv[++first]) < 1){
+                printf("Invalid amount of errors!\n" USAGE); /* inform the user */
+                exit(MISSING_ARGS_ERROR); /* exit the program and indicate an error */
+            }
+            max_errors = atoi(argv[first]);
+        } else if (strncmp(argv[first], JOBS_OPTION, strlen(JOBS_OPTION)) == 0){ /* given either as "-j N" or "-jN" */
+            char *value = argv[first] + strlen(JOBS_OPTION);
 
-    RETURN_IF_MEMORY_ALLOC_ERROR(filename, MEMORY_ALLOC_ERROR)
-    RETURN_IF_MEMORY_ALLOC_ERROR(commands_table, MEMORY_ALLOC_ERROR)
+            if (*value == '\0' && first + 1 < argc){ /* the amount is the next argument */
+                value = argv[++first];
+            }
 
-    /* fill the commands table with all the commands, and ensure is completed successfully */
-    if (fill_table(commands_table) != 0){
-        printf("Commands table creation failed. Terminating...\n"); /* inform the user */
-        exit(COMMANDS_TABLE_ERROR); /* exit the program and indicate an error */
+            workers = atoi(value);
+            if (workers < 1){
+                printf("Invalid amount of jobs!\n" USAGE); /* inform the user */
+                exit(MISSING_ARGS_ERROR); /* exit the program and indicate an error */
+            }
+        } else{
+            printf("Unknown option %s!\n" USAGE, argv[first]); /* inform the user */
+            exit(MISSING_ARGS_ERROR); /* exit the program and indicate an error */
+        }
     }
 
-    if (argc < 2){ /* check enough arguments were provided */
-        printf("Too few arguments!\nUsage: assembler file1 file2....\n"); /* inform the user */
+    if (serve){ /* serve as many connections at once as the amount of jobs */
+        char *path = getenv(SOCKET_ENV);
+
+        return run_server((path != NULL && *path != '\0') ? path : DEFAULT_SOCKET_PATH,
+                          (workers > 0) ? workers : DEFAULT_SERVER_WORKERS);
+    }
+
+    if (argc - first < 1){ /* check enough arguments were provided */
+        printf("Too few arguments!\n" USAGE); /* inform the user */
         exit(MISSING_ARGS_ERROR); /* exit the program and indicate an error */
     }
 
-    while (--argc){ /* assemble every file provided */
-        /* allocate memory for the filenames, ensure it succeeded */
-        char *base = (char *)malloc(sizeof(char) * strlen(argv[argc]));
-        RETURN_IF_MEMORY_ALLOC_ERROR(base, MEMORY_ALLOC_ERROR)
+    bases = (char **)malloc(sizeof(char *) * (argc - first));
+    RETURN_IF_MEMORY_ALLOC_ERROR(bases, MEMORY_ALLOC_ERROR)
 
-        strcpy(base, argv[argc]);
-        strcpy(filename, argv[argc]);
-        filename = strcat(filename, INPUT_FILE_EXT); /* construct the filename - the base provided and the necessary extension */
-        filename[strlen(filename)] = '\0'; /* mark end of string */
+    while (--argc >= first){ /* assemble the files from the last provided to the first */
+        bases[amount++] = argv[argc];
+    }
 
-        fp = fopen(filename, "r"); /* open the file in read mode */
+    if (cache_dir != NULL && open_build_cache(&cache, cache_dir) != 0){
+        cache_dir = NULL; /* assemble the files without a cache */
+    }
 
-        if (fp == NULL){ /* ensure the file was opened properly */
-            printf("Error opening file: %s\n", filename); /* inform the user */
-            continue; /* skip further processing, continue to the next file provided */
-        }
+    if (format != NO_STATS){ /* count the allocations only if they are printed */
+        enable_allocation_counting();
+    }
 
-        if (first_scan(fp, commands_table, base) != 0){ /* start the assembling process, check if errors occurred */
-            printf("Error compiling file: %s\n", filename);
-        } else{
-            printf("Compilation completed successfully for %s\n", filename);
-        }
+    if (assemble_files(bases, amount, (workers > 0) ? workers : 1, format, outputs, max_errors,
+                       (cache_dir != NULL) ? &cache : NULL) != 0){
+        printf("Memory allocation failed. Terminating...\n"); /* inform the user */
+    }
 
-        fclose(fp); /* close the file */
-        free(base); /* free the dynamically allocated variable */
+    if (cache_dir != NULL){ /* report the hit rate after the statistics of the files */
+        print_cache_stats(&cache, format, stdout);
+        close_build_cache(&cache);
     }
 
     /* free the dynamically allocated variables */
-    free_table(commands_table, 0);
-    free(commands_table);
-    free(filename);
+    free(bases);
 
     return 0;
 }
@@ -0,0 +1,199 @@
+#define _POSIX_C_SOURCE 200809L /* for sockets and getcwd */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "generals.h"
+#include "assemblyStats.h"
+#include "assemblyServer.h"
+
+/* the options of the assembler, which the client accepts as well */
+#define JOBS_OPTION "-j"
+#define STATS_OPTION "--stats"
+#define JSON_STATS_OPTION "--stats=json"
+#define BINARY_OPTION "--binary"
+#define LISTING_OPTION "--listing"
+#define JSON_DIAGNOSTICS_OPTION "--diagnostics=json"
+#define MAX_ERRORS_OPTION "--max-errors"
+
+/* the options of the client only: the directory of the output files, and a source read from the standard input */
+#define OUTPUT_DIR_OPTION "-o"
+#define STDIN_OPTION "--stdin"
+
+/* the amount of chars copied at once, from the standard input and from the server */
+#define COPY_BUFFER_SIZE 65536
+
+#define USAGE "Usage: assemblerClient [-j N] [--stats | --stats=json] [--binary] [--listing] [--diagnostics=json]" \
+              " [--max-errors N] [-o DIR] [--stdin NAME] file1 file2....\n"
+
+/* a thin client of the assembler server: it accepts the arguments of the assembler and prints exactly its messages,
+ * while the files are assembled by a running "assembler --serve". The socket is taken from ASSEMBLER_SOCKET, or
+ * DEFAULT_SOCKET_PATH. -j is accepted for compatibility - the server assembles concurrent requests concurrently. */
+
+/* Input: a pointer to the size to set.
+ * Output: returns the content of the standard input, and sets its size. Returns NULL if memory allocation failed.
+ */
+static char *read_stdin(size_t *size){
+    char *content = NULL, *grown;
+    size_t capacity = 0, read_size;
+
+    *size = 0;
+
+    do{
+        if (*size + COPY_BUFFER_SIZE > capacity){ /* make room for the next chunk */
+            capacity = 2 * capacity + COPY_BUFFER_SIZE;
+            grown = (char *)realloc(content, capacity);
+            if (grown == NULL){
+                free(content);
+                return NULL;
+            }
+            content = grown;
+        }
+
+        read_size = fread(content + *size, 1, COPY_BUFFER_SIZE, stdin);
+        *size += read_size;
+    } while (read_size > 0);
+
+    return content;
+}
+
+/* Input: the path of the socket.
+ * Output: returns a socket connected to the server, or -1 if there is no server.
+ */
+static int connect_to_server(char *path){
+    struct sockaddr_un address;
+    int fd;
+
+    if (strlen(path) >= sizeof(address.sun_path)){
+        return -1;
+    }
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path);
+
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0 && connect(fd, (struct sockaddr *)&address, sizeof(address)) != 0){
+        close(fd);
+        fd = -1;
+    }
+
+    return fd;
+}
+
+int main(int argc, char *argv[]) {
+
+    int first = 1, fd, i; /* first is the index of the first filename in argv */
+    enum stats_format format = NO_STATS; /* the format to print the statistics in */
+    unsigned int outputs = 0; /* the optional output files to build */
+    unsigned int max_errors = 0; /* the amount of errors after which a file is not checked any further */
+    char *output_dir = NULL, *stdin_name = NULL, *source = NULL, *cwd, *path = getenv(SOCKET_ENV);
+    char buffer[COPY_BUFFER_SIZE];
+    size_t source_size = 0;
+    ssize_t read_size;
+    FILE *request;
+
+    for (; first < argc && argv[first][0] == '-'; first++){ /* read the options, which precede the filenames */
+        if (strcmp(argv[first], STATS_OPTION) == 0){
+            format = TEXT_STATS;
+        } else if (strcmp(argv[first], JSON_STATS_OPTION) == 0){
+            format = JSON_STATS;
+        } else if (strcmp(argv[first], BINARY_OPTION) == 0){
+            outputs |= BINARY_OBJECT_OUTPUT;
+        } else if (strcmp(argv[first], LISTING_OPTION) == 0){
+            outputs |= LISTING_OUTPUT;
+        } else if (strcmp(argv[first], JSON_DIAGNOSTICS_OPTION) == 0){
+            outputs |= JSON_DIAGNOSTICS_OUTPUT;
+        } else if (strcmp(argv[first], MAX_ERRORS_OPTION) == 0 && first + 1 < argc){
+            if (atoi(argv[++first]) < 1){
+                printf("Invalid amount of errors!\n" USAGE); /* inform the user */
+                exit(MISSING_ARGS_ERROR); /* exit the program and indicate an error */
+            }
+            max_errors = atoi(argv[first]);
+        } else if ((strcmp(argv[first], OUTPUT_DIR_OPTION) == 0 || strcmp(argv[first], STDIN_OPTION) == 0) &&
+                   first + 1 < argc){
+            if (strcmp(argv[first], OUTPUT_DIR_OPTION) == 0){
+                output_dir = argv[++first];
+            } else{
+                stdin_name = argv[++first];
+            }
+        } else if (strncmp(argv[first], JOBS_OPTION, strlen(JOBS_OPTION)) == 0){ /* given either as "-j N" or "-jN" */
+            if (argv[first][strlen(JOBS_OPTION)] == '\0' && first + 1 < argc){ /* the amount is the next argument */
+                first++;
+            }
+        } else{
+            printf("Unknown option %s!\n" USAGE, argv[first]); /* inform the user */
+            exit(MISSING_ARGS_ERROR); /* exit the program and indicate an error */
+        }
+    }
+
+    if (argc - first < 1 && stdin_name == NULL){ /* check enough arguments were provided */
+        printf("Too few arguments!\n" USAGE); /* inform the user */
+        exit(MISSING_ARGS_ERROR); /* exit the program and indicate an error */
+    }
+
+    if (stdin_name != NULL && (source = read_stdin(&source_size)) == NULL){
+        printf("Memory allocation failed. Terminating...\n");
+        return MEMORY_ALLOC_ERROR;
+    }
+
+    if (path == NULL || *path == '\0'){
+        path = DEFAULT_SOCKET_PATH;
+    }
+
+    fd = connect_to_server(path);
+    if (fd < 0){
+        printf("No assembler server is running on %s - start one with \"assembler --serve\"\n", path);
+        free(source);
+        return 1;
+    }
+
+    request = fdopen(dup(fd), "w");
+    cwd = getcwd(buffer, sizeof(buffer));
+
+    if (request == NULL){
+        printf("Error sending the request: %s\n", strerror(errno));
+        free(source);
+        close(fd);
+        return 1;
+    }
+
+    /* send the whole request, with the files from the last provided to the first - like the assembler */
+    if (cwd != NULL){
+        fprintf(request, "%s %s\n", REQUEST_CWD, cwd);
+    }
+    fprintf(request, "%s %d %u %u\n", REQUEST_OPTIONS, (int)format, outputs, max_errors);
+    if (output_dir != NULL){
+        fprintf(request, "%s %s\n", REQUEST_OUTPUT_DIR, output_dir);
+    }
+    for (i = argc - 1; i >= first; i--){
+        fprintf(request, "%s %s\n", REQUEST_FILE, argv[i]);
+    }
+    if (stdin_name != NULL){ /* the source of the standard input is assembled last */
+        fprintf(request, "%s %lu %s\n", REQUEST_SOURCE, (unsigned long)source_size, stdin_name);
+        fwrite(source, 1, source_size, request);
+    }
+    fprintf(request, "%s\n", REQUEST_END);
+
+    fclose(request);
+    shutdown(fd, SHUT_WR); /* the request is complete */
+    free(source);
+
+    while ((read_size = read(fd, buffer, sizeof(buffer))) != 0){ /* print the messages until the server is done */
+        if (read_size < 0){
+            if (errno == EINTR){
+                continue;
+            }
+            break;
+        }
+        fwrite(buffer, 1, (size_t)read_size, stdout);
+    }
+
+    close(fd);
+
+    return 0;
+}
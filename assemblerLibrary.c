@@ -0,0 +1,106 @@
+#define _POSIX_C_SOURCE 200809L /* for open_memstream */
+
+#include "assemblerLibrary.h"
+#include "imageTools.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Input: an array of symbols of an object, its size, and an arena.
+ * Output: returns a copy of the array - and of the names of its symbols - out of the arena, or NULL if memory
+ * allocation failed.
+ */
+static ObjectSymbol *copy_symbols(ObjectSymbol *symbols, unsigned int size, Arena *arena){
+    ObjectSymbol *copy = (ObjectSymbol *)arena_alloc(arena, sizeof(ObjectSymbol) * size + 1); /* never 0 bytes */
+    unsigned int i;
+
+    RETURN_IF_MEMORY_ALLOC_ERROR(copy, NULL)
+
+    for (i = 0; i < size; i++){
+        copy[i].value = symbols[i].value;
+        copy[i].name = arena_copy_string(arena, symbols[i].name, strlen(symbols[i].name));
+        RETURN_IF_MEMORY_ALLOC_ERROR(copy[i].name, NULL)
+    }
+
+    return copy;
+}
+
+/* Input: the text of an assembly source, its length in chars, the limit of the errors and a result to fill.
+ * Output: returns 0 if the source was assembled successfully, 1 otherwise.
+ *
+ * Algorithm: the source is scanned in place, just like a mapped file. The diagnostics are collected into the result,
+ * with their arguments in its arena, and the state of the file is allocated out of an arena of its own, so that only
+ * the output is kept: on success, the first scan moves the images to the object and names its symbols after the
+ * symbols of the arena - copy the symbols to the arena of the symbols of the result, before the arena of the file is
+ * freed. Nothing but a failure to allocate the object is written to the stream of the output files, which is kept in
+ * memory - it is reported as such. If the assembling failed, nothing of the object is kept: its images are freed, and
+ * so are the symbols copied before an allocation failed.
+ */
+int assemble_buffer(const char *text, size_t size, unsigned int max_errors, AssemblyResult *result){
+    SourceFile source;
+    ObjectFile object;
+    Arena arena; /* the state of the file */
+    FILE *log;
+    char *messages = NULL;
+    size_t messages_length = 0;
+    int errors;
+
+    memset(result, 0, sizeof(AssemblyResult));
+    memset(&arena, 0, sizeof(Arena));
+    init_diagnostics(&result->diagnostics, max_errors, &result->arena);
+
+    source.data = (char *)text; /* only read */
+    source.size = size;
+    source.position = 0;
+    source.isMapped = false;
+
+    log = open_memstream(&messages, &messages_length);
+    RETURN_IF_MEMORY_ALLOC_ERROR(log, 1)
+
+    count_allocations_in(&result->stats);
+    errors = first_scan(&source, "", &result->diagnostics, log, &result->stats, &arena, 0, &object);
+    count_allocations_in(NULL);
+
+    if (errors == 0){
+        result->object = object;
+        result->object.entries = copy_symbols(object.entries, object.entries_size, &result->symbols);
+        result->object.externs = (result->object.entries != NULL) ?
+                                 copy_symbols(object.externs, object.externs_size, &result->symbols) : NULL;
+        errors = (result->object.externs == NULL);
+
+        free(object.entries);
+        free(object.externs);
+    }
+
+    free_arena(&arena);
+
+    fclose(log); /* sets the messages and their length */
+    if (errors != 0 && messages_length > 0){
+        report(&result->diagnostics, DIAG_OUT_OF_MEMORY, 0, 0, NULL, 0);
+    }
+    free(messages);
+
+    if (errors != 0){ /* the output is only kept if the assembling succeeded */
+        free_image(&result->object.code);
+        free_image(&result->object.data);
+        free_arena(&result->symbols); /* the symbols copied before an allocation failed */
+        memset(&result->object, 0, sizeof(ObjectFile));
+    }
+
+    return errors != 0;
+}
+
+/* Input: a result filled by assemble_buffer.
+ * Output: returns nothing.
+ *
+ * Algorithm: free the diagnostics and the images, which were moved out of the first scan, and the arenas holding
+ * everything else.
+ */
+void free_assembly_result(AssemblyResult *result){
+    free_diagnostics(&result->diagnostics);
+    free_image(&result->object.code);
+    free_image(&result->object.data);
+    free_arena(&result->symbols);
+    free_arena(&result->arena);
+    memset(result, 0, sizeof(AssemblyResult));
+}
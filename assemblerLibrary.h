@@ -0,0 +1,41 @@
+#ifndef ASSEMBLER_LIBRARY_H
+#define ASSEMBLER_LIBRARY_H
+
+#include <stddef.h>
+#include "arena.h"
+#include "assemblyStats.h"
+#include "binaryObject.h"
+#include "diagnostics.h"
+
+/* the API of libassembler.a: assembling a source held in memory, without touching the filesystem. Every call is
+ * independent of the others - nothing is shared between calls, so sources may be assembled on several threads at once */
+
+/* the result of assembling a source. It is owned by the caller, who releases it with free_assembly_result */
+struct AssemblyResult{
+    ObjectFile object; /* the images, the entries and the usages of the externals. Empty if the assembling failed */
+    Diagnostics diagnostics; /* the errors and warnings, in the order they were reported - print_diagnostic writes one */
+    AssemblyStats stats; /* the time of every phase, the amount of lines, words and symbols, and the allocations - only
+                          * if enable_allocation_counting was called before */
+    Arena symbols; /* holds the symbols of the object - freed as a whole if they could not all be copied */
+    Arena arena; /* holds the arguments of the diagnostics */
+};
+
+typedef struct AssemblyResult AssemblyResult;
+
+/* Input: the text of an assembly source, its length in chars, the limit of the errors (0 for none) and a result to fill.
+ * Output: returns 0 if the source was assembled successfully, 1 otherwise.
+ *
+ * This function assembles the received source - it needs not be terminated - exactly as the assembler assembles a
+ * .as file, and fills the received result with the output files in memory and the diagnostics. No file is read or
+ * written. The result is filled even if the assembling failed, and must always be released with free_assembly_result.
+ */
+int assemble_buffer(const char *text, size_t size, unsigned int max_errors, AssemblyResult *result);
+
+/* Input: a result filled by assemble_buffer.
+ * Output: returns nothing.
+ *
+ * This function frees all the memory of the received result. The result is left empty.
+ */
+void free_assembly_result(AssemblyResult *result);
+
+#endif
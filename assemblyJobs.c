@@ -0,0 +1,245 @@
+#define _POSIX_C_SOURCE 200809L /* for open_memstream */
+
+#include "assemblyJobs.h"
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+/* the state shared by the workers and the thread that prints the messages */
+struct JobQueue{
+    AssemblyJob *jobs;
+    int amount;
+    int next; /* the index of the next job to be taken by a worker */
+    enum stats_format format; /* the format to print the statistics of every file in */
+    unsigned int outputs; /* the optional output files to build for every file */
+    unsigned int max_errors; /* the limit of the errors of every file */
+    BuildCache *cache; /* the build cache, or NULL */
+    pthread_mutex_t lock; /* guards next and the done flags */
+    pthread_cond_t job_done; /* signalled whenever a job is done */
+};
+
+/* Input: an assembly source file, the filename to report, the base filename of the output files, the stream to write
+ * the messages to, the format of the statistics, the flags of the optional output files, the limit of the errors (0 for
+ * none), the build cache (NULL for none) and the arena to allocate the state of the file out of.
+ * Output: returns 0 if the file was assembled successfully, 1 otherwise.
+ *
+ * Algorithm: if there is a cache, look the source up in it - on a hit, the output files and the diagnostics are
+ * restored, and there is nothing to assemble. Otherwise, assemble the source using the first scan - counting its
+ * allocations - and print its diagnostics, in the format set in the flags. If the compilation succeeded, store it in
+ * the cache with the diagnostics themselves, which are printed again for whichever file hits the entry. Release
+ * everything it allocated out of the arena at once, keeping the blocks for the next file. Report the result, followed
+ * by the statistics if they were requested.
+ */
+int assemble_source(SourceFile *source, char *filename, char *output_base, FILE *log, enum stats_format format,
+                    unsigned int outputs, unsigned int max_errors, BuildCache *cache, Arena *arena){
+    AssemblyStats stats; /* the statistics of the file */
+    Diagnostics diagnostics; /* the errors and warnings of the file */
+    int errors = 0;
+
+    memset(&stats, 0, sizeof(AssemblyStats));
+    init_diagnostics(&diagnostics, max_errors, arena);
+    count_allocations_in(&stats); /* count the allocations made for this file */
+
+    if (cache != NULL){
+        stats.cache = restore_from_cache(cache, source, filename, output_base, outputs, log) ? CACHE_HIT : CACHE_MISS;
+    }
+
+    if (stats.cache != CACHE_HIT){
+        errors = first_scan(source, output_base, &diagnostics, log, &stats, arena, outputs, NULL); /* start the assembling process */
+        print_diagnostics(&diagnostics, filename, (outputs & JSON_DIAGNOSTICS_OUTPUT) ? JSON_DIAGNOSTICS : TEXT_DIAGNOSTICS,
+                          log);
+
+        if (cache != NULL && errors == 0){
+            store_in_cache(cache, source, output_base, outputs, stats.output_files, &diagnostics);
+        }
+        free_diagnostics(&diagnostics);
+    }
+
+    count_allocations_in(NULL);
+    reset_arena(arena); /* release the symbols of the file */
+
+    if (errors != 0){ /* check if errors occurred */
+        fprintf(log, "Error compiling file: %s\n", filename);
+    } else{
+        fprintf(log, "Compilation completed successfully for %s\n", filename);
+    }
+
+    print_stats(&stats, filename, format, log);
+
+    return errors != 0;
+}
+
+/* Input: the base filename, the stream to write the messages to, the format of the statistics, the flags of the
+ * optional output files, the limit of the errors, the build cache (NULL for none) and the arena to allocate the state
+ * of the file out of.
+ * Output: returns 0 if the file was assembled successfully, 1 otherwise.
+ *
+ * Algorithm: construct the filename - the base and the input extension, in a buffer large enough for both. Then, open
+ * the file and map it into memory, and assemble it next to the source. Finally, unmap and close the file and free the
+ * filename.
+ */
+int assemble_file(char *base, FILE *log, enum stats_format format, unsigned int outputs, unsigned int max_errors,
+                  BuildCache *cache, Arena *arena){
+    FILE *fp; /* the file to assemble */
+    SourceFile source; /* the content of the file */
+    int errors;
+    char *filename = (char *)malloc(strlen(base) + strlen(INPUT_FILE_EXT) + 1); /* room for the extension and '\0' */
+
+    RETURN_IF_MEMORY_ALLOC_ERROR(filename, 1)
+
+    strcpy(filename, base);
+    strcat(filename, INPUT_FILE_EXT); /* construct the filename - the base provided and the necessary extension */
+
+    fp = fopen(filename, "r"); /* open the file in read mode */
+
+    if (fp == NULL){ /* ensure the file was opened properly */
+        fprintf(log, "Error opening file: %s\n", filename); /* inform the user */
+        free(filename);
+        return 1;
+    }
+
+    if (open_source(&source, fp) != 0){ /* ensure the content of the file is available */
+        fprintf(log, "Error reading file: %s\n", filename); /* inform the user */
+        fclose(fp);
+        free(filename);
+        return 1;
+    }
+
+    errors = assemble_source(&source, filename, base, log, format, outputs, max_errors, cache, arena);
+
+    close_source(&source);
+    fclose(fp); /* close the file */
+    free(filename);
+
+    return errors;
+}
+
+/* Input: the job queue.
+ * Output: returns NULL.
+ *
+ * Algorithm: while there are jobs left, take the next one under the lock. Assemble its file with the messages written to
+ * a memory stream, so they can be printed later in order - using the arena of the worker, which is reused by all the
+ * files it assembles. Then, mark the job as done under the lock and signal the printing thread. Free the arena once
+ * there are no jobs left.
+ */
+static void *run_worker(void *arg){
+    struct JobQueue *queue = (struct JobQueue *)arg;
+    Arena arena = {NULL, NULL}; /* the arena of the worker - an empty one */
+    AssemblyJob *job;
+    FILE *log;
+
+    while (1){
+        pthread_mutex_lock(&queue->lock);
+        if (queue->next >= queue->amount){ /* no jobs left */
+            pthread_mutex_unlock(&queue->lock);
+            free_arena(&arena);
+            return NULL;
+        }
+        job = &queue->jobs[queue->next++]; /* take the next job */
+        pthread_mutex_unlock(&queue->lock);
+
+        log = open_memstream(&job->log, &job->log_size); /* buffer the messages of the file */
+
+        if (log == NULL){
+            job->log = NULL;
+        } else{
+            assemble_file(job->base, log, queue->format, queue->outputs, queue->max_errors, queue->cache, &arena);
+            fclose(log); /* sets the buffer and its size */
+        }
+
+        pthread_mutex_lock(&queue->lock);
+        job->done = true;
+        pthread_cond_broadcast(&queue->job_done);
+        pthread_mutex_unlock(&queue->lock);
+    }
+}
+
+/* Input: an array of base filenames, its size, the amount of workers to use, the format of the statistics, the flags
+ * of the optional output files, the limit of the errors of every file and the build cache (NULL for none).
+ * Output: returns 0 if the workers ran properly, MEMORY_ALLOC_ERROR otherwise.
+ *
+ * Algorithm: with a single worker, assemble the files in order, reusing a single arena, and write the messages
+ * directly. Otherwise, create a job for every file and start the workers - never more than there are files. Then, go
+ * over the jobs in order: wait for each to be done, and print its messages. At the end, wait for the workers to exit
+ * and free the jobs.
+ */
+int assemble_files(char *bases[], int amount, int workers, enum stats_format format, unsigned int outputs,
+                   unsigned int max_errors, BuildCache *cache){
+    struct JobQueue queue;
+    pthread_t *threads;
+    int i, started;
+
+    if (workers <= 1 || amount <= 1){ /* no concurrency is needed */
+        Arena arena = {NULL, NULL}; /* an empty arena, reused by all the files */
+
+        for (i = 0; i < amount; i++){
+            assemble_file(bases[i], stdout, format, outputs, max_errors, cache, &arena);
+        }
+
+        free_arena(&arena);
+        return 0;
+    }
+
+    if (workers > amount){ /* a worker without a file would only wait */
+        workers = amount;
+    }
+
+    queue.jobs = (AssemblyJob *)calloc(amount, sizeof(AssemblyJob));
+    threads = (pthread_t *)malloc(sizeof(pthread_t) * workers);
+
+    if (queue.jobs == NULL || threads == NULL){
+        free(queue.jobs);
+        free(threads);
+        return MEMORY_ALLOC_ERROR;
+    }
+
+    for (i = 0; i < amount; i++){
+        queue.jobs[i].base = bases[i];
+        queue.jobs[i].done = false;
+    }
+
+    queue.amount = amount;
+    queue.next = 0;
+    queue.format = format;
+    queue.outputs = outputs;
+    queue.max_errors = max_errors;
+    queue.cache = cache;
+    pthread_mutex_init(&queue.lock, NULL);
+    pthread_cond_init(&queue.job_done, NULL);
+
+    for (started = 0; started < workers; started++){ /* start the workers */
+        if (pthread_create(&threads[started], NULL, run_worker, &queue) != 0){
+            break; /* continue with the workers that were started */
+        }
+    }
+
+    if (started == 0){ /* no worker could be started, so assemble the files here */
+        run_worker(&queue);
+    }
+
+    for (i = 0; i < amount; i++){ /* print the messages of every file, in order */
+        pthread_mutex_lock(&queue.lock);
+        while (queue.jobs[i].done == false){
+            pthread_cond_wait(&queue.job_done, &queue.lock);
+        }
+        pthread_mutex_unlock(&queue.lock);
+
+        if (queue.jobs[i].log == NULL){
+            printf("Error compiling file: %s%s\n", queue.jobs[i].base, INPUT_FILE_EXT);
+        } else{
+            fwrite(queue.jobs[i].log, 1, queue.jobs[i].log_size, stdout);
+            free(queue.jobs[i].log);
+        }
+    }
+
+    for (i = 0; i < started; i++){
+        pthread_join(threads[i], NULL);
+    }
+
+    pthread_cond_destroy(&queue.job_done);
+    pthread_mutex_destroy(&queue.lock);
+    free(queue.jobs);
+    free(threads);
+
+    return 0;
+}
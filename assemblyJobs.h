@@ -0,0 +1,51 @@
+#include <stdio.h>
+#include "firstScan.h"
+#include "buildCache.h"
+
+/* a file to be assembled by a worker, and the messages written while assembling it */
+struct AssemblyJob{
+    char *base; /* the base filename, without the extension */
+    char *log; /* the messages written while assembling the file */
+    size_t log_size;
+    enum boolean done; /* whether the assembling of the file has finished */
+};
+
+typedef struct AssemblyJob AssemblyJob;
+
+/* Input: an assembly source file, the filename to report, the base filename of the output files, the stream to write
+ * the messages to, the format of the statistics, the flags of the optional output files, the limit of the errors (0 for
+ * none), the build cache (NULL for none) and the arena to allocate the state of the file out of.
+ * Output: returns 0 if the file was assembled successfully, 1 otherwise.
+ *
+ * This function assembles an already opened source - read from a file or received in memory - and writes the output
+ * files with the received base filename. The result and the statistics are reported under the received filename, and
+ * the arena is reset once the file is assembled. A source found in the cache is not assembled at all: its output files
+ * and messages are restored from the cache. The diagnostics of the file are printed once it was scanned, as text or -
+ * if JSON_DIAGNOSTICS_OUTPUT is set - as JSON; the scan stops once the limit of the errors is reached.
+ */
+int assemble_source(SourceFile *source, char *filename, char *output_base, FILE *log, enum stats_format format,
+                    unsigned int outputs, unsigned int max_errors, BuildCache *cache, Arena *arena);
+
+/* Input: the base filename, the stream to write the messages to, the format of the statistics, the flags of the
+ * optional output files, the limit of the errors (0 for none), the build cache (NULL for none) and the arena to
+ * allocate the state of the file out of.
+ * Output: returns 0 if the file was assembled successfully, 1 otherwise.
+ *
+ * This function opens the .as file matching the received base filename, assembles it, and reports whether the
+ * compilation succeeded to the received stream - followed by the statistics of the file, unless the format is NO_STATS.
+ * The arena is reset once the file is assembled, so it may be reused by the next file.
+ */
+int assemble_file(char *base, FILE *log, enum stats_format format, unsigned int outputs, unsigned int max_errors,
+                  BuildCache *cache, Arena *arena);
+
+/* Input: an array of base filenames, its size, the amount of workers to use, the format of the statistics, the flags
+ * of the optional output files, the limit of the errors of every file (0 for none) and the build cache (NULL for none).
+ * Output: returns 0 if the workers ran properly, MEMORY_ALLOC_ERROR otherwise.
+ *
+ * This function assembles every file in the array. With a single worker the files are assembled one after another, and
+ * the messages are written to the standard output immediately. Otherwise, the files are assembled concurrently by
+ * the workers, which own an arena each; the messages of every file are buffered, and printed in the order of the
+ * array once the file is done.
+ */
+int assemble_files(char *bases[], int amount, int workers, enum stats_format format, unsigned int outputs,
+                   unsigned int max_errors, BuildCache *cache);
@@ -0,0 +1,594 @@
+#define _POSIX_C_SOURCE 200809L /* for sockets, sigaction and getline */
+
+#include "assemblyServer.h"
+#include "assemblyJobs.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+/* the amount of files allocated for a request on its first file */
+#define REQUEST_INITIAL_CAPACITY 8
+
+/* the amount of bytes of blocks an idle arena keeps for the next request - the rest are freed */
+#define MAX_IDLE_ARENA_SIZE (16 * ARENA_BLOCK_SIZE)
+
+/* an arena kept by the server between requests */
+struct PooledArena{
+    Arena arena;
+    struct PooledArena *next; /* the next idle arena */
+};
+
+/* the state shared by the thread that accepts the connections and the threads that serve them */
+struct ServerState{
+    struct PooledArena *idle; /* the arenas no connection uses */
+    int active; /* the amount of connections being served */
+    int workers; /* the amount of connections that may be served at once */
+    pthread_mutex_t lock; /* guards idle and active */
+    pthread_cond_t connection_done; /* signalled whenever a connection is done */
+};
+
+/* a file of a request - a path to read it from, or its content */
+struct RequestFile{
+    char *base; /* the base filename, as sent by the client */
+    char *output_dir; /* the directory of the output files, or NULL to write them next to the source */
+    char *source; /* the content of the file, or NULL to read it from its path */
+    size_t size; /* the amount of chars in the content */
+};
+
+/* a request of a client */
+struct Request{
+    char *cwd; /* the directory relative base filenames are resolved in, or NULL */
+    enum stats_format format;
+    unsigned int outputs;
+    unsigned int max_errors;
+    struct RequestFile *files; /* the files to assemble, in order */
+    int amount;
+    int capacity;
+};
+
+/* a connection, handed to the thread that serves it */
+struct Connection{
+    int fd;
+    struct ServerState *state;
+};
+
+/* the signal that stopped the server - set by the signal handler - or 0 while it runs */
+static volatile sig_atomic_t stop_signal = 0;
+
+/* the write end of the pipe that wakes the server up, written to whenever it is stopped or a connection is done - or
+ * -1 while there is none */
+static int wake_fd = -1;
+
+/* Input: none.
+ * Output: returns nothing. Wakes the server up, if it waits for a connection.
+ *
+ * Algorithm: write a byte to the pipe, without blocking - if the pipe is full, the server is woken up already. Only
+ * write is called, so it is safe in a signal handler.
+ */
+static void wake_server(void){
+    int saved_errno = errno;
+
+    if (wake_fd >= 0 && write(wake_fd, "", 1) < 0){
+        ; /* the pipe is full, so the server wakes up anyway */
+    }
+    errno = saved_errno;
+}
+
+/* Input: the number of the signal.
+ * Output: returns nothing. Marks the server to stop, and wakes it up.
+ */
+static void request_stop(int signal_number){
+    stop_signal = signal_number;
+    wake_server();
+}
+
+/* Input: a directory, which may be NULL, and a name.
+ * Output: returns a newly allocated path of the name in the directory, or NULL if memory allocation failed.
+ *
+ * Algorithm: an absolute name, or a name without a directory, is copied as is. Otherwise, join the directory and the
+ * name with a '/'.
+ */
+static char *join_path(char *directory, char *name){
+    char *path;
+
+    if (directory == NULL || name[0] == '/'){
+        directory = "";
+    }
+
+    path = (char *)malloc(strlen(directory) + strlen(name) + 2); /* room for the '/' and '\0' */
+    RETURN_IF_MEMORY_ALLOC_ERROR(path, NULL)
+
+    strcpy(path, directory);
+    if (*directory != '\0'){
+        strcat(path, "/");
+    }
+
+    return strcat(path, name);
+}
+
+/* Input: a string.
+ * Output: returns a newly allocated copy of the string, or NULL if memory allocation failed.
+ */
+static char *copy_string(char *s){
+    char *copy = (char *)malloc(strlen(s) + 1);
+    RETURN_IF_MEMORY_ALLOC_ERROR(copy, NULL)
+
+    return strcpy(copy, s);
+}
+
+/* Input: a request, the base filename of the new file, the output directory (NULL for none), and the content of the
+ * file and its size (NULL and 0 for a file read from its path).
+ * Output: returns 0 if the file was added, 1 if memory allocation failed.
+ *
+ * Algorithm: if the array of files is full, double its capacity. Then, add the file at its end, with copies of the base
+ * and the output directory. The content is owned by the request from now on.
+ */
+static int add_request_file(struct Request *request, char *base, char *output_dir, char *source, size_t size){
+    struct RequestFile *file;
+
+    if (request->amount == request->capacity){ /* no room left */
+        int capacity = (request->capacity == 0) ? REQUEST_INITIAL_CAPACITY : 2 * request->capacity;
+        struct RequestFile *files = (struct RequestFile *)realloc(request->files, sizeof(struct RequestFile) * capacity);
+
+        if (files == NULL){
+            free(source);
+            return 1;
+        }
+
+        request->files = files;
+        request->capacity = capacity;
+    }
+
+    file = &request->files[request->amount++];
+    file->source = source;
+    file->size = size;
+    file->base = copy_string(base);
+    file->output_dir = (output_dir != NULL) ? copy_string(output_dir) : NULL;
+
+    return (file->base == NULL || (output_dir != NULL && file->output_dir == NULL));
+}
+
+/* Input: a request.
+ * Output: returns nothing. Frees the memory of the request.
+ */
+static void free_request(struct Request *request){
+    int i;
+
+    for (i = 0; i < request->amount; i++){
+        free(request->files[i].base);
+        free(request->files[i].output_dir);
+        free(request->files[i].source);
+    }
+
+    free(request->files);
+    free(request->cwd);
+}
+
+/* Input: the stream of the connection, and a request to fill.
+ * Output: returns 0 if a whole request was read, 1 otherwise.
+ *
+ * Algorithm: read the lines of the request one by one, up to REQUEST_END. Split every line into its keyword and its
+ * argument, and apply it: set the directory, the options or the output directory of the request, or add a file to it.
+ * The content of a source follows its line, and is read as is. An unknown keyword, or a connection closed before the
+ * end, fails the request.
+ */
+static int read_request(FILE *in, struct Request *request){
+    char *line = NULL, *argument, *output_dir = NULL, *source;
+    size_t line_capacity = 0, size;
+    ssize_t length;
+    int format, errors = 1;
+
+    while ((length = getline(&line, &line_capacity, in)) > 0){
+        if (line[length - 1] == '\n'){
+            line[--length] = '\0';
+        }
+
+        argument = strchr(line, ' ');
+        if (argument != NULL){
+            *argument++ = '\0'; /* split the keyword and the argument */
+        }
+
+        if (strcmp(line, REQUEST_END) == 0){
+            errors = 0;
+            break;
+        } else if (argument == NULL){
+            break;
+        } else if (strcmp(line, REQUEST_CWD) == 0){
+            free(request->cwd);
+            if ((request->cwd = copy_string(argument)) == NULL){
+                break;
+            }
+        } else if (strcmp(line, REQUEST_OPTIONS) == 0){
+            request->max_errors = 0; /* optional */
+            if (sscanf(argument, "%d %u %u", &format, &request->outputs, &request->max_errors) < 2){
+                break;
+            }
+            request->format = (format == TEXT_STATS || format == JSON_STATS) ? (enum stats_format)format : NO_STATS;
+        } else if (strcmp(line, REQUEST_OUTPUT_DIR) == 0){
+            free(output_dir);
+            if ((output_dir = join_path(request->cwd, argument)) == NULL){
+                break;
+            }
+        } else if (strcmp(line, REQUEST_FILE) == 0){
+            if (add_request_file(request, argument, output_dir, NULL, 0) != 0){
+                break;
+            }
+        } else if (strcmp(line, REQUEST_SOURCE) == 0){
+            size = strtoul(argument, &argument, 10);
+            source = (size < (size_t)-1) ? (char *)malloc(size + 1) : NULL; /* never 0 bytes */
+
+            if (*argument++ != ' ' || source == NULL || fread(source, 1, size, in) != size){
+                free(source);
+                break;
+            }
+            if (add_request_file(request, argument, output_dir, source, size) != 0){
+                break;
+            }
+        } else{ /* an unknown request */
+            break;
+        }
+    }
+
+    free(output_dir);
+    free(line);
+
+    return errors;
+}
+
+/* Input: a file of a request, the request and the stream to write the messages to, and an arena.
+ * Output: returns 0 if the file was assembled successfully, 1 otherwise.
+ *
+ * Algorithm: the messages name the file as the client sent it, while the source is read from its path in the
+ * directory of the client. The output files are written next to the source, or to the output directory under the last
+ * component of the base. The content of a file sent in the request is assembled in place, and is freed with it.
+ */
+static int assemble_request_file(struct RequestFile *file, struct Request *request, FILE *out, Arena *arena){
+    char *filename, *path = NULL, *output_base, *name = strrchr(file->base, '/');
+    SourceFile source;
+    FILE *fp = NULL;
+    int errors = 1, available = 0; /* whether the source is available */
+
+    filename = (char *)malloc(strlen(file->base) + strlen(INPUT_FILE_EXT) + 1);
+    output_base = (file->output_dir != NULL) ? join_path(file->output_dir, (name != NULL) ? name + 1 : file->base) :
+                                               join_path(request->cwd, file->base);
+
+    if (filename == NULL || output_base == NULL){
+        fprintf(out, "Memory allocation failed. Terminating...\n");
+        free(filename);
+        free(output_base);
+        return 1;
+    }
+
+    strcpy(filename, file->base);
+    strcat(filename, INPUT_FILE_EXT);
+
+    if (file->source != NULL){ /* the content was sent in the request */
+        source.data = file->source;
+        source.size = file->size;
+        source.position = 0;
+        source.isMapped = false;
+        file->source = NULL; /* freed by close_source */
+        available = 1;
+    } else if ((path = join_path(request->cwd, filename)) == NULL || (fp = fopen(path, "r")) == NULL){
+        fprintf(out, "Error opening file: %s\n", filename);
+    } else if (open_source(&source, fp) != 0){
+        fprintf(out, "Error reading file: %s\n", filename);
+    } else{
+        available = 1;
+    }
+
+    if (available){
+        errors = assemble_source(&source, filename, output_base, out, request->format, request->outputs,
+                                 request->max_errors, NULL, arena);
+        close_source(&source);
+    }
+
+    if (fp != NULL){
+        fclose(fp);
+    }
+
+    free(path);
+    free(output_base);
+    free(filename);
+
+    return errors;
+}
+
+/* Input: the state of the server.
+ * Output: returns an idle arena, or NULL if memory allocation failed.
+ *
+ * Algorithm: under the lock, take the first idle arena. If there is none, allocate an empty one.
+ */
+static struct PooledArena *take_arena(struct ServerState *state){
+    struct PooledArena *pooled;
+
+    pthread_mutex_lock(&state->lock);
+    pooled = state->idle;
+    if (pooled != NULL){
+        state->idle = pooled->next;
+    }
+    pthread_mutex_unlock(&state->lock);
+
+    if (pooled == NULL){
+        pooled = (struct PooledArena *)calloc(1, sizeof(struct PooledArena)); /* an empty arena */
+    }
+
+    return pooled;
+}
+
+/* Input: a connection.
+ * Output: returns NULL.
+ *
+ * Algorithm: read the whole request first, so a client that sends a long request never waits for its messages. Then,
+ * assemble the files in order with an idle arena, writing the messages to the connection. Trim the arena to
+ * MAX_IDLE_ARENA_SIZE and return it to the idle ones. At last, close the connection and signal the server that it is
+ * done.
+ */
+static void *serve_connection(void *arg){
+    struct Connection *connection = (struct Connection *)arg;
+    struct ServerState *state = connection->state;
+    struct Request request;
+    struct PooledArena *pooled = NULL;
+    FILE *in = fdopen(connection->fd, "r"), *out = NULL;
+    int out_fd = dup(connection->fd), i;
+
+    memset(&request, 0, sizeof(struct Request));
+
+    if (in == NULL){
+        close(connection->fd);
+    }
+
+    if (out_fd >= 0 && (out = fdopen(out_fd, "w")) == NULL){
+        close(out_fd);
+    }
+
+    if (in != NULL && out != NULL){
+        if (read_request(in, &request) != 0){
+            fprintf(out, "Invalid request!\n");
+        } else if ((pooled = take_arena(state)) == NULL){
+            fprintf(out, "Memory allocation failed. Terminating...\n");
+        } else{
+            for (i = 0; i < request.amount; i++){
+                assemble_request_file(&request.files[i], &request, out, &pooled->arena);
+            }
+        }
+    }
+
+    free_request(&request);
+
+    if (pooled != NULL){
+        trim_arena(&pooled->arena, MAX_IDLE_ARENA_SIZE);
+    }
+
+    if (out != NULL){
+        fclose(out);
+    }
+    if (in != NULL){
+        fclose(in);
+    }
+
+    pthread_mutex_lock(&state->lock);
+    if (pooled != NULL){ /* keep the arena, with its blocks, for the next request */
+        pooled->next = state->idle;
+        state->idle = pooled;
+    }
+    state->active--;
+    pthread_cond_broadcast(&state->connection_done);
+    pthread_mutex_unlock(&state->lock);
+    wake_server(); /* the server may accept another connection */
+
+    free(connection);
+
+    return NULL;
+}
+
+/* Input: the path of the socket.
+ * Output: returns the socket the server listens on, or -1 if it could not be created.
+ *
+ * Algorithm: ensure the path fits in the address. If a server already answers on the path, don't take it over;
+ * otherwise, remove the stale socket left there, bind a new one and listen on it. The socket does not block, so a
+ * connection that went away before it was accepted never blocks the server.
+ */
+static int open_server_socket(char *path){
+    struct sockaddr_un address;
+    int fd;
+
+    if (strlen(path) >= sizeof(address.sun_path)){
+        printf("The path of the socket is too long: %s\n", path);
+        return -1;
+    }
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path);
+
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0){
+        printf("Error creating the socket: %s\n", strerror(errno));
+        return -1;
+    }
+
+    if (connect(fd, (struct sockaddr *)&address, sizeof(address)) == 0){
+        printf("A server is already running on %s\n", path);
+        close(fd);
+        return -1;
+    }
+
+    close(fd);
+    unlink(path); /* a socket left by a server that was killed */
+
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || bind(fd, (struct sockaddr *)&address, sizeof(address)) != 0 || listen(fd, SOMAXCONN) != 0 ||
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) != 0){
+        printf("Error listening on %s: %s\n", path, strerror(errno));
+        if (fd >= 0){
+            close(fd);
+        }
+        return -1;
+    }
+
+    return fd;
+}
+
+/* Input: the read end of the pipe that wakes the server up.
+ * Output: returns nothing. Reads all the bytes written to the pipe, without blocking.
+ */
+static void drain_wake_pipe(int fd){
+    char bytes[64];
+
+    while (read(fd, bytes, sizeof(bytes)) > 0)
+        ;
+}
+
+/* Input: the path of the socket to listen on, and the amount of connections to serve at once.
+ * Output: returns 0 once the server was stopped, 1 if it could not be started.
+ *
+ * Algorithm: open the socket and a pipe that wakes the server up, and stop on SIGINT or SIGTERM - the handler writes
+ * to the pipe, so a signal is never lost between checking for it and waiting. The signals are blocked in the threads
+ * that serve the connections, so they are always handled here. A client that goes away must not kill the server, so
+ * SIGPIPE is ignored. Wait for the pipe, and for a connection while fewer connections than the workers are served -
+ * every connection that is done writes to the pipe too. Accept the connections one after another and serve each on a
+ * detached thread - or right here, if a thread cannot be created - so there are never more threads, nor idle arenas,
+ * than workers. Once stopped, remove the socket, wait for the connections being served and free the idle arenas.
+ */
+int run_server(char *path, int workers){
+    struct ServerState state;
+    struct PooledArena *pooled;
+    struct Connection *connection;
+    struct sigaction action;
+    pthread_attr_t attributes;
+    pthread_t thread;
+    sigset_t stop_signals, previous;
+    fd_set waiting;
+    int fd = open_server_socket(path), client, wake[2], full, created;
+
+    if (fd < 0){
+        return 1;
+    }
+
+    if (pipe(wake) != 0){
+        printf("Error creating a pipe: %s\n", strerror(errno));
+        close(fd);
+        unlink(path);
+        return 1;
+    }
+    fcntl(wake[0], F_SETFL, fcntl(wake[0], F_GETFL) | O_NONBLOCK);
+    fcntl(wake[1], F_SETFL, fcntl(wake[1], F_GETFL) | O_NONBLOCK);
+    wake_fd = wake[1];
+
+    enable_allocation_counting(); /* any request may ask for the statistics */
+
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = request_stop;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    action.sa_handler = SIG_IGN;
+    sigaction(SIGPIPE, &action, NULL);
+
+    sigemptyset(&stop_signals);
+    sigaddset(&stop_signals, SIGINT);
+    sigaddset(&stop_signals, SIGTERM);
+
+    state.idle = NULL;
+    state.active = 0;
+    state.workers = workers;
+    pthread_mutex_init(&state.lock, NULL);
+    pthread_cond_init(&state.connection_done, NULL);
+    pthread_attr_init(&attributes);
+    pthread_attr_setdetachstate(&attributes, PTHREAD_CREATE_DETACHED);
+
+    printf("Listening on %s\n", path);
+    fflush(stdout);
+
+    while (!stop_signal){
+        pthread_mutex_lock(&state.lock);
+        full = state.active >= state.workers; /* the next connections wait in the queue of the socket */
+        pthread_mutex_unlock(&state.lock);
+
+        FD_ZERO(&waiting);
+        FD_SET(wake[0], &waiting);
+        if (!full){
+            FD_SET(fd, &waiting);
+        }
+
+        if (select(((fd > wake[0]) ? fd : wake[0]) + 1, &waiting, NULL, NULL, NULL) < 0){
+            if (errno == EINTR){
+                continue;
+            }
+            printf("Error waiting for a connection: %s\n", strerror(errno));
+            break;
+        }
+
+        if (FD_ISSET(wake[0], &waiting)){
+            drain_wake_pipe(wake[0]);
+        }
+        if (full || !FD_ISSET(fd, &waiting)){
+            continue;
+        }
+
+        client = accept(fd, NULL, NULL);
+        if (client < 0){
+            if (errno == EINTR || errno == ECONNABORTED || errno == EAGAIN || errno == EWOULDBLOCK){
+                continue;
+            }
+            printf("Error accepting a connection: %s\n", strerror(errno));
+            break;
+        }
+        fcntl(client, F_SETFL, fcntl(client, F_GETFL) & ~O_NONBLOCK); /* the connection is read with blocking calls */
+
+        connection = (struct Connection *)malloc(sizeof(struct Connection));
+        if (connection == NULL){
+            close(client);
+            continue;
+        }
+
+        connection->fd = client;
+        connection->state = &state;
+
+        pthread_mutex_lock(&state.lock);
+        state.active++;
+        pthread_mutex_unlock(&state.lock);
+
+        pthread_sigmask(SIG_BLOCK, &stop_signals, &previous); /* the new thread inherits the blocked signals */
+        created = pthread_create(&thread, &attributes, serve_connection, connection);
+        pthread_sigmask(SIG_SETMASK, &previous, NULL);
+
+        if (created != 0){
+            serve_connection(connection);
+        }
+    }
+
+    close(fd);
+    unlink(path);
+
+    pthread_mutex_lock(&state.lock);
+    while (state.active > 0){ /* wait for the connections being served */
+        pthread_cond_wait(&state.connection_done, &state.lock);
+    }
+    pthread_mutex_unlock(&state.lock);
+
+    wake_fd = -1;
+    close(wake[0]);
+    close(wake[1]);
+
+    while (state.idle != NULL){
+        pooled = state.idle;
+        state.idle = pooled->next;
+        free_arena(&pooled->arena);
+        free(pooled);
+    }
+
+    pthread_attr_destroy(&attributes);
+    pthread_mutex_destroy(&state.lock);
+    pthread_cond_destroy(&state.connection_done);
+
+    return 0;
+}
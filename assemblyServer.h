@@ -0,0 +1,39 @@
+#ifndef ASSEMBLY_SERVER_H
+#define ASSEMBLY_SERVER_H
+
+/* the environment variable that overrides the path of the socket, and the path used without it */
+#define SOCKET_ENV "ASSEMBLER_SOCKET"
+#define DEFAULT_SOCKET_PATH "/tmp/assembler.sock"
+
+/* the requests of the protocol. A client connects to the socket and sends a request - lines, each a keyword, a space
+ * and its argument - up to REQUEST_END, and then reads the messages of the assembler until the server closes the
+ * connection. The messages are exactly what the assembler prints for the same files.
+ *  cwd <directory> - the directory relative base filenames are resolved in. The working directory of the client.
+ *  options <format> <outputs> [<max errors>] - the format of the statistics, the flags of the optional output files
+ *    and the format of the messages, and the limit of the errors of every file (0, or none, for no limit).
+ *  output <directory> - write the output files of the following files to the directory, instead of next to the sources.
+ *  file <base> - assemble the file <base>.as.
+ *  source <length> <base> - assemble the <length> bytes that follow the line, as if they were the file <base>.as.
+ *  end - the end of the request. The files are assembled in the order they were sent. */
+#define REQUEST_CWD "cwd"
+#define REQUEST_OPTIONS "options"
+#define REQUEST_OUTPUT_DIR "output"
+#define REQUEST_FILE "file"
+#define REQUEST_SOURCE "source"
+#define REQUEST_END "end"
+
+/* the amount of connections the server serves at once, unless -j sets it */
+#define DEFAULT_SERVER_WORKERS 4
+
+/* Input: the path of the socket to listen on, and the amount of connections to serve at once.
+ * Output: returns 0 once the server was stopped, 1 if it could not be started.
+ *
+ * This function runs the assembler as a server: it listens on a Unix domain socket, and serves every connection on a
+ * thread of its own, until it receives SIGINT or SIGTERM - a single signal stops it, even while all the connections it
+ * may serve are busy; it stops once they are done. At most the received amount of connections are served at once -
+ * the next ones wait in the queue of the socket until one is done. The arenas of the finished requests are kept for
+ * the next ones, up to a few blocks each, so a warm server assembles a small file without allocating them again.
+ */
+int run_server(char *path, int workers);
+
+#endif
@@ -0,0 +1,176 @@
+#define _POSIX_C_SOURCE 200809L /* for clock_gettime */
+
+#include "assemblyStats.h"
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+
+/* the statistics the allocations of every thread are counted in. Files are assembled by several threads at once, so
+ * every thread counts in the statistics of its own file */
+static pthread_key_t counted_stats_key;
+
+/* whether the allocations are counted. Set once, before the threads that assemble the files are started, and only read
+ * from then on - so an allocation that isn't counted costs a single test */
+static int counting_enabled = 0;
+
+/* Input: none.
+ * Output: returns nothing.
+ *
+ * Algorithm: create the key of the counted statistics, and mark the counting as enabled - once.
+ */
+void enable_allocation_counting(void){
+    if (!counting_enabled){
+        pthread_key_create(&counted_stats_key, NULL);
+        counting_enabled = 1;
+    }
+}
+
+/* Input: the size of an allocation.
+ * Output: returns nothing.
+ *
+ * This function counts an allocation of the received size, in the statistics of the calling thread.
+ */
+static void count_allocation(size_t size){
+    AssemblyStats *stats;
+
+    if (!counting_enabled){
+        return;
+    }
+
+    stats = (AssemblyStats *)pthread_getspecific(counted_stats_key);
+
+    if (stats != NULL){
+        stats->allocations++;
+        stats->allocated_bytes += size;
+    }
+}
+
+/* Input: none.
+ * Output: returns the current time, in milliseconds.
+ *
+ * Algorithm: read the monotonic clock - unlike the real-time clock, it never jumps - and convert it to milliseconds.
+ */
+double now_ms(void){
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec * 1e3 + now.tv_nsec / 1e6;
+}
+
+/* Input: the statistics of a file, or NULL.
+ * Output: returns nothing.
+ *
+ * Algorithm: if the counting was enabled, store the statistics under the key of the calling thread.
+ */
+void count_allocations_in(AssemblyStats *stats){
+    if (counting_enabled){
+        pthread_setspecific(counted_stats_key, stats);
+    }
+}
+
+/* Input: the size of the allocation.
+ * Output: returns the allocated memory, or NULL if the allocation failed.
+ *
+ * Algorithm: count the allocation, and allocate it with malloc.
+ */
+void *counted_malloc(size_t size){
+    count_allocation(size);
+    return malloc(size);
+}
+
+/* Input: the amount of elements and the size of each.
+ * Output: returns the allocated memory, or NULL if the allocation failed.
+ *
+ * Algorithm: count the allocation, and allocate it with calloc.
+ */
+void *counted_calloc(size_t amount, size_t size){
+    count_allocation(amount * size);
+    return calloc(amount, size);
+}
+
+/* Input: the memory to reallocate, its size and its new size.
+ * Output: returns the reallocated memory, or NULL if the allocation failed.
+ *
+ * Algorithm: count the allocation - with the bytes it adds, none if it shrinks - and reallocate it with realloc.
+ */
+void *counted_realloc(void *pointer, size_t old_size, size_t size){
+    count_allocation((size > old_size) ? size - old_size : 0);
+    return realloc(pointer, size);
+}
+
+/* Input: a string and the stream to write to.
+ * Output: returns nothing.
+ *
+ * Algorithm: write every char as is, except for quotes and backslashes, which are escaped with a backslash, and
+ * control chars, which are written as their code.
+ */
+void print_json_string(char *str, FILE *out){
+    putc('"', out);
+
+    for (; *str != '\0'; str++){
+        if (*str == '"' || *str == '\\'){
+            fprintf(out, "\\%c", *str);
+        } else if ((unsigned char)*str < ' '){
+            fprintf(out, "\\u%04x", (unsigned char)*str);
+        } else{
+            putc(*str, out);
+        }
+    }
+
+    putc('"', out);
+}
+
+/* the names of the results of looking a file up in the build cache */
+static char *cache_result_names[] = {"none", "miss", "hit"};
+
+/* Input: the statistics of a file, the name of the file, the format and the stream to write to.
+ * Output: returns nothing.
+ *
+ * Algorithm: for the text format, write a title with the name of the file, and then a line for every phase and every
+ * count. For the JSON format, write all of them as the members of a single object, in one line. The result of the build
+ * cache is written only if there is a cache, and the time of the listing file only if it was built.
+ */
+void print_stats(AssemblyStats *stats, char *filename, enum stats_format format, FILE *out){
+    if (format == JSON_STATS){
+        fprintf(out, "{\"file\": ");
+        print_json_string(filename, out);
+        fprintf(out, ", \"first_scan_ms\": %.3f, \"relocation_ms\": %.3f, \"second_scan_ms\": %.3f, "
+                     "\"object_file_ms\": %.3f, \"entry_file_ms\": %.3f, \"extern_file_ms\": %.3f, ",
+                stats->first_scan_ms, stats->relocation_ms, stats->second_scan_ms,
+                stats->object_file_ms, stats->entry_file_ms, stats->extern_file_ms);
+        fprintf(out, "\"lines\": %lu, \"code_words\": %lu, \"data_words\": %lu, \"symbols\": %u, "
+                     "\"max_probe_length\": %u, \"allocations\": %lu, \"allocated_bytes\": %lu",
+                stats->lines, stats->code_words, stats->data_words, stats->symbols,
+                stats->max_probe_length, stats->allocations, stats->allocated_bytes);
+        if (stats->output_files & LISTING_FILE_BUILT){
+            fprintf(out, ", \"listing_file_ms\": %.3f", stats->listing_file_ms);
+        }
+        if (stats->cache != NOT_CACHED){
+            fprintf(out, ", \"cache\": \"%s\"", cache_result_names[stats->cache]);
+        }
+        fprintf(out, "}\n");
+        return;
+    }
+
+    if (format == TEXT_STATS){
+        fprintf(out, "Statistics for %s:\n", filename);
+        fprintf(out, "    first scan:        %10.3f ms\n", stats->first_scan_ms);
+        fprintf(out, "    relocation:        %10.3f ms\n", stats->relocation_ms);
+        fprintf(out, "    second scan:       %10.3f ms\n", stats->second_scan_ms);
+        fprintf(out, "    object file:       %10.3f ms\n", stats->object_file_ms);
+        fprintf(out, "    entry file:        %10.3f ms\n", stats->entry_file_ms);
+        fprintf(out, "    extern file:       %10.3f ms\n", stats->extern_file_ms);
+        if (stats->output_files & LISTING_FILE_BUILT){
+            fprintf(out, "    listing file:      %10.3f ms\n", stats->listing_file_ms);
+        }
+        fprintf(out, "    lines:             %10lu\n", stats->lines);
+        fprintf(out, "    words:             %10lu (%lu code, %lu data)\n",
+                stats->code_words + stats->data_words, stats->code_words, stats->data_words);
+        fprintf(out, "    symbols:           %10u (longest probe: %u slots)\n", stats->symbols, stats->max_probe_length);
+        fprintf(out, "    allocations:       %10lu (%lu bytes)\n", stats->allocations, stats->allocated_bytes);
+        if (stats->cache != NOT_CACHED){
+            fprintf(out, "    build cache:       %10s\n", cache_result_names[stats->cache]);
+        }
+    }
+}
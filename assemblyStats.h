@@ -0,0 +1,90 @@
+#ifndef ASSEMBLY_STATS_H
+#define ASSEMBLY_STATS_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+/* the formats in which the statistics of a file can be printed */
+enum stats_format {NO_STATS=0, TEXT_STATS=1, JSON_STATS=2};
+
+/* the results of looking a file up in the build cache */
+enum cache_result {NOT_CACHED=0, CACHE_MISS=1, CACHE_HIT=2};
+
+/* the flags of the output files that were built, recorded in the statistics of the file */
+#define OBJECT_FILE_BUILT 1
+#define ENTRY_FILE_BUILT 2
+#define EXTERN_FILE_BUILT 4
+#define BINARY_OBJECT_FILE_BUILT 8
+#define LISTING_FILE_BUILT 16
+
+/* the statistics collected while assembling a file. Times are wall-clock times, in milliseconds */
+struct AssemblyStats{
+    double first_scan_ms; /* reading the file and encoding what can be encoded */
+    double relocation_ms; /* placing the data image and its symbols after the code image */
+    double second_scan_ms; /* applying .entry instructions and resolving the references to symbols */
+    double object_file_ms; /* building each of the output files */
+    double entry_file_ms;
+    double extern_file_ms;
+    double listing_file_ms; /* building the listing file, if it was requested */
+    unsigned long lines; /* the amount of lines read */
+    unsigned long code_words; /* the amount of words in the code image */
+    unsigned long data_words; /* the amount of words in the data image */
+    unsigned int symbols; /* the amount of symbols in the symbols table */
+    unsigned int max_probe_length; /* the most slots a lookup of a symbol in the table goes over */
+    unsigned long allocations; /* the amount of allocations made by counted_malloc and its siblings */
+    unsigned long allocated_bytes; /* the bytes requested by these allocations - a reallocation counts what it adds */
+    unsigned int output_files; /* the output files that were built, as flags */
+    enum cache_result cache; /* whether the file was found in the build cache, if there is one */
+};
+
+typedef struct AssemblyStats AssemblyStats;
+
+/* Input: none.
+ * Output: returns the current time, in milliseconds.
+ *
+ * This function reads a monotonic clock, so the difference between two of its results is the wall time between them.
+ */
+double now_ms(void);
+
+/* Input: none.
+ * Output: returns nothing.
+ *
+ * This function turns the counting of the allocations on. It must be called before any thread assembles a file - it
+ * is called once, if the statistics were requested. Until then, counting costs the allocations a single test.
+ */
+void enable_allocation_counting(void);
+
+/* Input: the statistics of a file, or NULL.
+ * Output: returns nothing.
+ *
+ * This function makes the received statistics the ones the allocations of the calling thread are counted in.
+ * NULL stops the counting. Nothing is counted unless the counting was enabled.
+ */
+void count_allocations_in(AssemblyStats *stats);
+
+/* Input: the size of the allocation - and for realloc, the size of the memory before it.
+ * Output: returns the allocated memory, or NULL if the allocation failed.
+ *
+ * These functions allocate memory just like malloc, calloc and realloc do, and count the allocation in the statistics
+ * of the calling thread, if there are. A reallocation counts only the bytes it adds to the memory.
+ */
+void *counted_malloc(size_t size);
+void *counted_calloc(size_t amount, size_t size);
+void *counted_realloc(void *pointer, size_t old_size, size_t size);
+
+/* Input: a string and the stream to write to.
+ * Output: returns nothing.
+ *
+ * This function writes the received string as a JSON string - quoted, with quotes, backslashes and control chars escaped.
+ */
+void print_json_string(char *str, FILE *out);
+
+/* Input: the statistics of a file, the name of the file, the format and the stream to write to.
+ * Output: returns nothing.
+ *
+ * This function prints the statistics of the received file in the received format - a few readable lines, or one
+ * line holding a JSON object.
+ */
+void print_stats(AssemblyStats *stats, char *filename, enum stats_format format, FILE *out);
+
+#endif
@@ -0,0 +1,146 @@
+/* a benchmark of the whole assembler: generates programs of several sizes with generateProgram, assembles each of them
+ * a few times, and reports the throughput in lines and words per second and the peak resident memory of the assembler.
+ * The programs are always generated with the same seed, so the results are comparable between commits.
+ * Usage: assemblerBenchmark [amount of lines...] - 1000, 10000, 100000 and 1000000 lines by default.
+ * Run from the root of the repository, after building assembler and generateProgram. */
+#define _DEFAULT_SOURCE /* for wait4 */
+
+#include "../generals.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+/* the directory the generated programs and their output files are written to */
+#define WORK_DIR "benchmarks/programs"
+
+/* the amount of times every program is assembled - the fastest time is reported */
+#define REPEATS 3
+
+/* the maximum length of the base filename of a program, and of a command or a path that contains it */
+#define MAX_BASE_LENGTH 64
+#define MAX_COMMAND_LENGTH 256
+
+/* Input: none.
+ * Output: the current time of a monotonic clock, in milliseconds.
+ */
+static double now(void){
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+/* Input: the base filename of a program, and pointers to the time and the peak memory to set.
+ * Output: returns 0 if the program was assembled, 1 otherwise.
+ *
+ * This function runs the assembler on the received program, with its messages discarded, and measures the wall time
+ * of the run and the peak resident memory of the assembler process, in KB.
+ */
+static int assemble(char *base, double *ms, long *peak_kb){
+    struct rusage usage;
+    double start = now();
+    int status, devnull;
+    pid_t pid = fork();
+
+    if (pid < 0){
+        return 1;
+    }
+
+    if (pid == 0){ /* the child runs the assembler */
+        devnull = open("/dev/null", O_WRONLY);
+        dup2(devnull, STDOUT_FILENO);
+        execl("./assembler", "assembler", base, (char *)NULL);
+        _exit(127); /* the assembler could not be run */
+    }
+
+    if (wait4(pid, &status, 0, &usage) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0){
+        return 1;
+    }
+
+    *ms = now() - start;
+    *peak_kb = usage.ru_maxrss;
+
+    return 0;
+}
+
+/* Input: the amount of lines of the program to benchmark.
+ * Output: returns 0 if succeeded, 1 otherwise.
+ *
+ * This function generates a program of the received size, assembles it REPEATS times and prints a line of results.
+ * The amount of words is read from the header of the object file.
+ */
+static int run(unsigned long lines){
+    char base[MAX_BASE_LENGTH], command[MAX_COMMAND_LENGTH];
+    double ms, best = 0;
+    long peak_kb, peak = 0;
+    unsigned long code_words = 0, data_words = 0, words;
+    FILE *object;
+    int i;
+
+    sprintf(base, "%s/bench%lu", WORK_DIR, lines);
+    sprintf(command, "./generateProgram %lu > %s.as", lines, base);
+    if (system(command) != 0){
+        fprintf(stderr, "Generating %s.as failed - was generateProgram built?\n", base);
+        return 1;
+    }
+
+    sprintf(command, "%s.ob", base);
+    remove(command); /* an object file of an earlier run must not be mistaken for a result */
+
+    for (i = 0; i < REPEATS; i++){
+        if (assemble(base, &ms, &peak_kb) != 0){
+            fprintf(stderr, "Assembling %s.as failed - was the assembler built?\n", base);
+            return 1;
+        }
+
+        best = (i == 0 || ms < best) ? ms : best;
+        peak = (peak_kb > peak) ? peak_kb : peak;
+    }
+
+    object = fopen(command, "r");
+    if (object == NULL || fscanf(object, "%lu %lu", &code_words, &data_words) != 2){
+        fprintf(stderr, "Reading %s failed - the program has errors\n", command);
+        if (object != NULL){
+            fclose(object);
+        }
+        return 1;
+    }
+    fclose(object);
+
+    words = code_words + data_words;
+    printf("%10lu %10lu %12.2f %14.0f %14.0f %12ld\n", lines, words, best,
+           lines / (best / 1e3), words / (best / 1e3), peak);
+
+    return 0;
+}
+
+int main(int argc, char *argv[]){
+    unsigned long sizes[] = {1000, 10000, 100000, 1000000};
+    unsigned long lines;
+    int i;
+
+    mkdir(WORK_DIR, 0755); /* the directory might already exist */
+
+    printf("%10s %10s %12s %14s %14s %12s\n", "lines", "words", "best ms", "lines/sec", "words/sec", "peak RSS KB");
+
+    for (i = 0; i < ((argc > 1) ? argc - 1 : (int)(sizeof(sizes) / sizeof(sizes[0]))); i++){
+        lines = (argc > 1) ? strtoul(argv[i + 1], NULL, 10) : sizes[i];
+
+        if (lines < 2){
+            printf("Usage: assemblerBenchmark [amount of lines...]\n");
+            return MISSING_ARGS_ERROR;
+        }
+
+        if (run(lines) != 0){
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,257 @@
+/* a generator of large, valid assembly programs for benchmarking the assembler. The program is written to the standard
+ * output, and the same arguments always generate the same program.
+ * Usage: generateProgram [-s seed] [-m instructions,data,strings,externs,entries,jumps] lines
+ *        the mix is the relative weight of every kind of line - 60,15,5,5,5,10 by default */
+#include "../generals.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* the kinds of lines the generator writes */
+enum line_kind {INSTRUCTION=0, DATA, STRING, EXTERN, ENTRY, JUMP, KINDS};
+
+/* the default weight of every kind of line, in the order of enum line_kind */
+#define DEFAULT_MIX {60, 15, 5, 5, 5, 10}
+
+/* the default seed of the generator */
+#define DEFAULT_SEED 1
+
+/* one of every LABEL_RATE instructions and data lines defines a label */
+#define LABEL_RATE 4
+
+/* limits that keep every line well below MAX_LINE_LENGTH */
+#define MAX_DATA_VALUES 8
+#define MAX_STRING_LENGTH 30
+
+/* a command and the addressing methods it accepts, as in commands.c: the string has a '1' for every valid method */
+struct GeneratedCommand{
+    char *name;
+    int num_of_args;
+    char *src_methods;
+    char *dst_methods;
+};
+
+static struct GeneratedCommand commands[] = {
+    {"mov", 2, "1101", "0101"}, {"cmp", 2, "1101", "1101"}, {"add", 2, "1101", "0101"}, {"sub", 2, "1101", "0101"},
+    {"lea", 2, "0100", "0101"}, {"clr", 1, "0000", "0101"}, {"not", 1, "0000", "0101"}, {"inc", 1, "0000", "0101"},
+    {"dec", 1, "0000", "0101"}, {"red", 1, "0000", "0101"}, {"prn", 1, "0000", "1101"}, {"rts", 0, "0000", "0000"}
+};
+
+static char *jumps[] = {"jmp", "bne", "jsr"};
+
+/* the state of the generator - a linear congruential generator, so the output doesn't depend on the C library */
+static unsigned long state;
+
+/* Input: an upper bound.
+ * Output: a pseudo-random number between 0 and the bound, not including it.
+ */
+static unsigned long next_random(unsigned long bound){
+    state = (state * 1103515245UL + 12345UL) & 0x7FFFFFFFUL;
+    return (state >> 8) % bound;
+}
+
+/* the plan of the program: the kind of every line, whether it defines a label, and the labels defined so far */
+static unsigned char *kinds;
+static unsigned char *labeled;
+static unsigned long *code_labels, *data_labels; /* the lines of the code and data labels */
+static unsigned long code_count = 0, data_count = 0, extern_count = 0;
+
+/* Input: an addressing method, and the stream to write to.
+ * Output: returns nothing.
+ *
+ * This function writes a random operand of the received addressing method: a scalar, a label - of code, data or an
+ * external symbol - or a register.
+ */
+static void write_operand(int method, FILE *out){
+    unsigned long which;
+
+    if (method == IMMEDIATE){
+        fprintf(out, "#%ld", (long)next_random(2001) - 1000);
+    } else if (method == DIRECT){
+        which = next_random(code_count + data_count + extern_count);
+        if (which < code_count){
+            fprintf(out, "L%lu", code_labels[which]);
+        } else if (which < code_count + data_count){
+            fprintf(out, "L%lu", data_labels[which - code_count]);
+        } else{
+            fprintf(out, "X%lu", which - code_count - data_count);
+        }
+    } else{
+        fprintf(out, "r%lu", next_random(NUM_OF_REGISTERS));
+    }
+}
+
+/* Input: a string of the valid addressing methods, with a '1' for every valid method.
+ * Output: a random valid addressing method.
+ */
+static int random_method(char *methods){
+    int method;
+
+    do {
+        method = (int)next_random(4);
+    } while (methods[method] != '1');
+
+    return method;
+}
+
+/* Input: the weights of the kinds of lines.
+ * Output: a random kind, chosen by the weights.
+ */
+static int random_kind(unsigned long mix[]){
+    unsigned long total = 0, which;
+    int kind;
+
+    for (kind = 0; kind < KINDS; kind++){
+        total += mix[kind];
+    }
+
+    which = next_random(total);
+    for (kind = 0; which >= mix[kind]; kind++){
+        which -= mix[kind];
+    }
+
+    return kind;
+}
+
+/* Input: the amount of lines, the weights of the kinds of lines and the stream to write to.
+ * Output: returns 0 if succeeded, 1 if memory allocation failed.
+ *
+ * Algorithm: first, plan the program - choose the kind of every line and which lines define labels, so that every
+ * operand can refer to any label, including the ones defined later. The first line is always a labeled instruction,
+ * so there is a code label to jump to, and the last is a stop. .string lines are always labeled: the first scan
+ * rejects a .string whose quote follows the instruction after a single space, unless a label precedes it. Then, write every line by its kind: .entry lines name
+ * a label that wasn't named yet (or are replaced with instructions if there is none), jumps use the relative
+ * addressing method to code labels half of the times, and .extern lines declare a new external symbol.
+ */
+static int generate(unsigned long lines, unsigned long mix[], FILE *out){
+    unsigned long i, j, count, next_entry = 0, next_extern = 0;
+    struct GeneratedCommand *command;
+    int kind;
+
+    kinds = (unsigned char *)malloc(lines);
+    labeled = (unsigned char *)calloc(lines, 1);
+    code_labels = (unsigned long *)malloc(sizeof(unsigned long) * lines);
+    data_labels = (unsigned long *)malloc(sizeof(unsigned long) * lines);
+    RETURN_IF_MEMORY_ALLOC_ERROR(kinds, 1)
+    RETURN_IF_MEMORY_ALLOC_ERROR(labeled, 1)
+    RETURN_IF_MEMORY_ALLOC_ERROR(code_labels, 1)
+    RETURN_IF_MEMORY_ALLOC_ERROR(data_labels, 1)
+
+    for (i = 0; i < lines - 1; i++){ /* plan the program */
+        kinds[i] = (unsigned char)((i == 0) ? INSTRUCTION : random_kind(mix));
+
+        if (kinds[i] == EXTERN){
+            extern_count++;
+        } else if (kinds[i] != ENTRY && (i == 0 || kinds[i] == STRING || next_random(LABEL_RATE) == 0)){
+            labeled[i] = 1;
+            if (kinds[i] == DATA || kinds[i] == STRING){
+                data_labels[data_count++] = i;
+            } else{
+                code_labels[code_count++] = i;
+            }
+        }
+    }
+
+    for (i = 0; i < lines - 1; i++){ /* write the program */
+        kind = kinds[i];
+
+        if (kind == ENTRY && next_entry >= code_count + data_count){ /* every label was already declared an entry */
+            kind = INSTRUCTION;
+        }
+
+        if (labeled[i]){
+            fprintf(out, "L%lu: ", i);
+        }
+
+        if (kind == INSTRUCTION){
+            command = &commands[next_random(sizeof(commands) / sizeof(commands[0]))];
+            fprintf(out, "%s", command->name);
+
+            if (command->num_of_args == 2){
+                putc(' ', out);
+                write_operand(random_method(command->src_methods), out);
+                fprintf(out, ", ");
+            } else if (command->num_of_args == 1){
+                putc(' ', out);
+            }
+
+            if (command->num_of_args > 0){
+                write_operand(random_method(command->dst_methods), out);
+            }
+        } else if (kind == JUMP){
+            fprintf(out, "%s ", jumps[next_random(sizeof(jumps) / sizeof(jumps[0]))]);
+            if (next_random(2) == 0){
+                fprintf(out, "%%L%lu", code_labels[next_random(code_count)]); /* relative - to code labels only */
+            } else{
+                write_operand(DIRECT, out);
+            }
+        } else if (kind == DATA){
+            fprintf(out, ".data ");
+            for (j = 0, count = next_random(MAX_DATA_VALUES) + 1; j < count; j++){
+                fprintf(out, (j == 0) ? "%ld" : ", %ld", (long)next_random(4001) - 2000);
+            }
+        } else if (kind == STRING){
+            fprintf(out, ".string \"");
+            for (j = 0, count = next_random(MAX_STRING_LENGTH) + 1; j < count; j++){
+                putc('a' + (int)next_random(26), out);
+            }
+            putc('"', out);
+        } else if (kind == EXTERN){
+            fprintf(out, ".extern X%lu", next_extern++);
+        } else { /* ENTRY */
+            if (next_entry < code_count){
+                fprintf(out, ".entry L%lu", code_labels[next_entry]);
+            } else{
+                fprintf(out, ".entry L%lu", data_labels[next_entry - code_count]);
+            }
+            next_entry++;
+        }
+
+        putc('\n', out);
+    }
+
+    fprintf(out, "stop\n");
+
+    free(kinds);
+    free(labeled);
+    free(code_labels);
+    free(data_labels);
+
+    return 0;
+}
+
+int main(int argc, char *argv[]){
+    unsigned long mix[KINDS] = DEFAULT_MIX;
+    unsigned long lines = 0;
+    int i, kind;
+    char *value;
+
+    state = DEFAULT_SEED;
+
+    for (i = 1; i < argc; i++){ /* read the options and the amount of lines */
+        if (strcmp(argv[i], "-s") == 0 && i + 1 < argc){
+            state = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc){
+            for (kind = 0, value = argv[++i]; kind < KINDS; kind++){
+                mix[kind] = strtoul(value, &value, 10);
+                if (*value == ','){
+                    value++;
+                }
+            }
+        } else{
+            lines = strtoul(argv[i], NULL, 10);
+        }
+    }
+
+    if (lines < 2 || mix[INSTRUCTION] + mix[DATA] + mix[STRING] + mix[EXTERN] + mix[ENTRY] + mix[JUMP] == 0){
+        fprintf(stderr, "Usage: generateProgram [-s seed] [-m instructions,data,strings,externs,entries,jumps] lines\n");
+        return MISSING_ARGS_ERROR;
+    }
+
+    if (generate(lines, mix, stdout) != 0){
+        fprintf(stderr, "Memory allocation error. Terminating!\n");
+        return MEMORY_ALLOC_ERROR;
+    }
+
+    return 0;
+}
@@ -0,0 +1,141 @@
+/* a benchmark that compares the growable arrays of imageTools.c with the linked lists of BinCodeNodes they replaced,
+ * on a code image and a data image built side by side, the way first_scan builds them.
+ * Usage: imageBenchmark [amount of words in each image] */
+#include "../imageTools.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* the default amount of words in each image */
+#define DEFAULT_WORDS 1000000
+
+/* the amount of times every traversal is repeated, to get a measurable time */
+#define TRAVERSALS 10
+
+/* the bytes glibc's malloc adds to every chunk, and the alignment it rounds chunks to */
+#define MALLOC_OVERHEAD 8
+#define MALLOC_ALIGNMENT 16
+
+/* a node of the linked list, as the images were stored before */
+struct ListNode{
+    struct ListNode *next;
+    BinCodeNode word;
+};
+
+/* Input: the start and end clock values.
+ * Output: the time between them in milliseconds.
+ */
+static double ms(clock_t start, clock_t end){
+    return (double)(end - start) / CLOCKS_PER_SEC * 1e3;
+}
+
+/* Input: the size of an allocation.
+ * Output: the bytes the allocation takes on the heap - the size with malloc's header, rounded to its alignment.
+ */
+static unsigned long heap_bytes(unsigned long size){
+    return (size + MALLOC_OVERHEAD + MALLOC_ALIGNMENT - 1) / MALLOC_ALIGNMENT * MALLOC_ALIGNMENT;
+}
+
+/* Input: the head of a list.
+ * Output: returns nothing.
+ *
+ * This function frees all the nodes of a list.
+ */
+static void free_nodes(struct ListNode *head){
+    struct ListNode *next;
+
+    for (; head != NULL; head = next){
+        next = head->next;
+        free(head);
+    }
+}
+
+int main(int argc, char *argv[]){
+    unsigned long words = (argc > 1) ? strtoul(argv[1], NULL, 10) : DEFAULT_WORDS;
+    struct ListNode codeHead = {NULL}, dataHead = {NULL}; /* dummy heads, as first_scan used */
+    struct ListNode *codeTail = &codeHead, *dataTail = &dataHead, *node;
+    Image codeImage = {NULL, 0, 0}, dataImage = {NULL, 0, 0};
+    BinCodeNode *word;
+    unsigned long i, j, checksum = 0;
+    clock_t start, end;
+
+    if (words == 0){
+        printf("Usage: imageBenchmark [amount of words in each image]\n");
+        return MISSING_ARGS_ERROR;
+    }
+
+    /* linked lists: build both interleaved, relocate the data list, and sum both lists as the output writer would */
+    start = clock();
+    for (i = 0; i < words; i++){
+        node = (struct ListNode *)calloc(1, sizeof(struct ListNode));
+        RETURN_IF_MEMORY_ALLOC_ERROR(node, MEMORY_ALLOC_ERROR)
+        node->word.code = (Word)(~i & WORD_MASK);
+        node->word.IC = CODE_LOADING_ADDRESS + i;
+        codeTail = codeTail->next = node;
+
+        node = (struct ListNode *)calloc(1, sizeof(struct ListNode));
+        RETURN_IF_MEMORY_ALLOC_ERROR(node, MEMORY_ALLOC_ERROR)
+        node->word.code = (Word)(i & WORD_MASK);
+        node->word.IC = i;
+        dataTail = dataTail->next = node;
+    }
+    end = clock();
+    printf("%-12s %8lu words  footprint %8.1f MB  build %8.1f ms", "linked list", words,
+           2.0 * words * heap_bytes(sizeof(struct ListNode)) / (1 << 20), ms(start, end));
+
+    start = clock();
+    for (j = 0; j < TRAVERSALS; j++){
+        for (node = dataHead.next; node != NULL; node = node->next){ /* the ICF relocation */
+            node->word.IC += CODE_LOADING_ADDRESS + words;
+        }
+        for (node = codeHead.next; node != NULL; node = node->next){
+            checksum += node->word.code + node->word.IC;
+        }
+        for (node = dataHead.next; node != NULL; node = node->next){
+            checksum += node->word.code + node->word.IC;
+        }
+    }
+    end = clock();
+    printf("  traverse %8.1f ms\n", ms(start, end) / TRAVERSALS);
+
+    free_nodes(codeHead.next);
+    free_nodes(dataHead.next);
+
+    /* arrays: the same work on the images */
+    start = clock();
+    for (i = 0; i < words; i++){
+        word = add_word(&codeImage);
+        RETURN_IF_MEMORY_ALLOC_ERROR(word, MEMORY_ALLOC_ERROR)
+        word->code = (Word)(~i & WORD_MASK);
+        word->IC = CODE_LOADING_ADDRESS + i;
+
+        word = add_word(&dataImage);
+        RETURN_IF_MEMORY_ALLOC_ERROR(word, MEMORY_ALLOC_ERROR)
+        word->code = (Word)(i & WORD_MASK);
+        word->IC = i;
+    }
+    end = clock();
+    printf("%-12s %8lu words  footprint %8.1f MB  build %8.1f ms", "array", words,
+           (double)(heap_bytes(sizeof(BinCodeNode) * codeImage.capacity) + heap_bytes(sizeof(BinCodeNode) * dataImage.capacity)) / (1 << 20),
+           ms(start, end));
+
+    start = clock();
+    for (j = 0; j < TRAVERSALS; j++){
+        for (i = 0; i < dataImage.size; i++){ /* the ICF relocation */
+            dataImage.words[i].IC += CODE_LOADING_ADDRESS + words;
+        }
+        for (i = 0; i < codeImage.size; i++){
+            checksum += codeImage.words[i].code + codeImage.words[i].IC;
+        }
+        for (i = 0; i < dataImage.size; i++){
+            checksum += dataImage.words[i].code + dataImage.words[i].IC;
+        }
+    }
+    end = clock();
+    printf("  traverse %8.1f ms\n", ms(start, end) / TRAVERSALS);
+
+    free_image(&codeImage);
+    free_image(&dataImage);
+
+    return (checksum == 0); /* use the checksum, so the traversals are not optimized away */
+}
@@ -0,0 +1,398 @@
+/* a benchmark of the throughput of the tokenizer: it reads the lines of a program the way first_scan does, once with
+ * the table-driven lexer of inputHandlers.c and once with the previous get_token, which looked up every char in a
+ * string of delimiters, and the checks that read every token again to validate it.
+ * Usage: lexerBenchmark [amount of lines] */
+#include "../inputHandlers.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+
+/* the default amount of lines of the program */
+#define DEFAULT_LINES 1000000
+
+/* the amount of times the program is read by each tokenizer, to get a measurable time */
+#define PASSES 5
+
+/* the lines the program is made of, in turns - every kind of token of the language */
+static const char *sample_lines[] = {
+    "MAIN: mov #-12, r3\n",
+    "LOOP:  cmp r1 , LENGTH\n",
+    "\tadd   r2, COUNT\n",
+    "jmp %LOOP\n",
+    "prn #48\n",
+    "LIST: .data 6, -9, +15, 22, 300\n",
+    "STR: .string \"abcdef\"\n",
+    ".entry MAIN\n",
+    ".extern EXTERNAL\n",
+    "lea STR, r6\n",
+    "END: stop\n",
+    "bne %END\n"
+};
+
+#define SAMPLE_LINES (sizeof(sample_lines) / sizeof(sample_lines[0]))
+
+/* Input: receive a char an a string.
+ * Output: returns 1 if c is in delims, 0 otherwise.
+ *
+ * This function is the previous is_char_in_delims: a space in delims stands for any white space.
+ */
+static int previous_is_char_in_delims(char c, char *delims){
+    int i;
+
+    for (i = 0; delims[i] != '\0'; ++i){
+        if (delims[i] == ' '){
+            if (isspace(c)){
+                return 1;
+            }
+        } else if (c == delims[i]){
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/* Input: the start and the end of a line of text, a destination token and a string of delimiters.
+ * Output: returns the amount of chars read.
+ *
+ * This function is the previous get_token, which checked every char of the token with previous_is_char_in_delims.
+ */
+static int previous_get_token(char *line, char *line_end, Token *dest, char *delims){
+    int read_chars = 0;
+    int reached_token = (line < line_end && isspace(*line)) ? 0 : 1;
+
+    dest->start = line;
+    dest->length = 0;
+
+    for (; line < line_end; line++){
+        read_chars++;
+        if (reached_token == 0){
+            if (isspace(*line)){
+                continue;
+            } else{
+                dest->start = line;
+                dest->length = 1;
+                reached_token = 1;
+            }
+        } else{
+            if (previous_is_char_in_delims(*line, delims)){
+                break;
+            }
+            dest->length++;
+        }
+    }
+
+    return read_chars - 1;
+}
+
+/* Input: receives a token that represents a scalar.
+ * Output: returns 0 if the scalar isn't a valid one, returns 1 otherwise.
+ *
+ * This function is the previous legal_scalar, which read the token again.
+ */
+static int previous_legal_scalar(Token token){
+    char *scalar = token.start;
+    int ind = 0, scalar_done = 0;
+
+    for (; ind < token.length && isspace(scalar[ind]); ind++);
+    ind = (ind > 0) ? ind - 1 : ind;
+
+    if (ind < token.length && (scalar[ind] == '-' || scalar[ind] == '+')){
+        ind++;
+    }
+
+    if (ind >= token.length){
+        return 0;
+    }
+
+    while (ind < token.length){
+        if (!isdigit(scalar[ind]) && scalar_done == 0 && !isspace(scalar[ind])){
+            return 0;
+        } else if (isspace(scalar[ind])){
+            scalar_done = 1;
+        } else if (scalar_done == 1){
+            return 0;
+        }
+
+        ind++;
+    }
+
+    return 1;
+}
+
+/* Input: a token.
+ * Output: returns 1 if the token represents a register, 0 otherwise.
+ *
+ * This function is the previous is_register.
+ */
+static int previous_is_register(Token str){
+    int i;
+
+    if (str.length == 0 || str.start[0] != 'r' || !previous_legal_scalar(skip_chars(str, 1))){
+        return 0;
+    }
+
+    i = token_to_int(skip_chars(str, 1));
+
+    return i >= 0 && i < NUM_OF_REGISTERS;
+}
+
+/* Input: a token.
+ * Output: returns 1 if the token is a keyword, 0 otherwise.
+ *
+ * This function is the previous is_key_word.
+ */
+static int previous_is_key_word(Token c){
+    return find_keyword(c) >= 0 || previous_is_register(c);
+}
+
+/* Input: receives a token that represents a symbol.
+ * Output: returns 1 if the symbol is legal, 0 otherwise.
+ *
+ * This function is the previous legal_symbol.
+ */
+static int previous_legal_symbol(Token symbol){
+    int i;
+
+    if (symbol.length == 0 || !isalpha(symbol.start[0]) || previous_is_key_word(symbol)){
+        return 0;
+    }
+
+    for (i = 1; i < symbol.length; ++i){
+        if (!isalpha(symbol.start[i]) && !isdigit(symbol.start[i])){
+            return 0;
+        }
+    }
+
+    return i <= MAX_SYMBOL_LENGTH;
+}
+
+/* Input: a token representing an argument.
+ * Output: the enum value representing the address method.
+ *
+ * This function is the previous get_addressing_method.
+ */
+static enum addr_method previous_get_addressing_method(Token arg){
+    if (arg.length > 0 && arg.start[0] == '#'){
+        return IMMEDIATE;
+    } else if (arg.length > 0 && arg.start[0] == '%'){
+        return RELATIVE;
+    }
+
+    return previous_is_register(arg) ? IMD_REGISTER : DIRECT;
+}
+
+/* Input: the argument as a token and its addressing method.
+ * Output: returns 1 if the argument is valid, 0 otherwise.
+ *
+ * This function is the previous legal_arg, which read the argument again.
+ */
+static int previous_legal_arg(Token arg, enum addr_method method){
+    if (method == IMMEDIATE){
+        return previous_legal_scalar(skip_chars(arg, 1));
+    }
+
+    if (method == IMD_REGISTER){
+        int num = token_to_int(skip_chars(arg, 1));
+
+        return num >= 0 && num < NUM_OF_REGISTERS;
+    }
+
+    if (arg.length > 0 && arg.start[0] == '%'){
+        arg = skip_chars(arg, 1);
+    }
+
+    return !previous_is_key_word(arg);
+}
+
+/* Input: a token.
+ * Output: returns 1 if the token contains a space between 2 words, 0 otherwise.
+ *
+ * This function is the previous is_containing_space_between_words.
+ */
+static int previous_is_containing_space_between_words(Token c){
+    int i, space = 0;
+
+    for (i = 0; i < c.length; i++){
+        if (isspace(c.start[i])){
+            space = 1;
+        } else if (space == 1){
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/* Input: the start and the end of a line, and a pointer to the amount of tokens read.
+ * Output: returns a checksum of what was learned about the tokens of the line.
+ *
+ * This function reads a line with the previous tokenizer, as first_scan read it: the label, the instruction, and then
+ * the scalars of .data, the string of .string, the symbol of .entry and .extern or the arguments of a command - every
+ * token validated by reading it again.
+ */
+static unsigned long read_line_previous(char *line, char *line_end, unsigned long *tokens){
+    unsigned long sum = 0;
+    const Command *command;
+    enum addr_method method;
+    Token token;
+
+    line += previous_get_token(line, line_end, &token, " :");
+    (*tokens)++;
+
+    if (*line++ == ':'){
+        sum += previous_legal_symbol(token);
+        line += previous_get_token(line, line_end, &token, " ");
+        (*tokens)++;
+    }
+
+    if (token_equals(token, ".data")){
+        line += previous_get_token(line, line_end, &token, ",") + 1;
+        while (token.length != 0 && previous_legal_scalar(token)){
+            (*tokens)++;
+            sum += token_to_int(token);
+            line += previous_get_token(line, line_end, &token, ",") + 1;
+        }
+    } else if (token_equals(token, ".string")){
+        previous_get_token(line, line_end, &token, "\"");
+        (*tokens)++;
+        sum += token.length;
+    } else if (token_equals(token, ".entry") || token_equals(token, ".extern")){
+        previous_get_token(line, line_end, &token, " ");
+        (*tokens)++;
+        sum += previous_legal_symbol(token);
+    } else if ((command = find_command(token)) != NULL && command->num_of_args > 0){
+        line += previous_get_token(line, line_end, &token, (command->num_of_args == 2) ? "," : " ");
+        (*tokens)++;
+        method = previous_get_addressing_method(token);
+        sum += method + previous_legal_arg(token, method);
+
+        if (command->num_of_args == 2){
+            sum += (*line++ != ',' && previous_is_containing_space_between_words(token));
+            previous_get_token(line, line_end, &token, " ");
+            (*tokens)++;
+            method = previous_get_addressing_method(token);
+            sum += method + previous_legal_arg(token, method);
+        }
+    }
+
+    return sum;
+}
+
+/* Input: the start and the end of a line, and a pointer to the amount of tokens read.
+ * Output: returns a checksum of what was learned about the tokens of the line.
+ *
+ * This function reads a line with lex_token, as first_scan reads it now - the same tokens as read_line_previous, each
+ * validated while it was read.
+ */
+static unsigned long read_line_lexer(char *line, char *line_end, unsigned long *tokens){
+    unsigned long sum = 0;
+    const Command *command;
+    Lexeme lexeme;
+
+    line += lex_token(line, line_end, &lexeme, CHAR_SPACE | CHAR_COLON);
+    (*tokens)++;
+
+    if (*line++ == ':'){
+        sum += lexeme.legal;
+        line += lex_token(line, line_end, &lexeme, CHAR_SPACE);
+        (*tokens)++;
+    }
+
+    if (lexeme.type == TOKEN_DIRECTIVE && lexeme.keyword == DATA_DIRECTIVE){
+        line += lex_token(line, line_end, &lexeme, CHAR_COMMA) + 1;
+        while (lexeme.type == TOKEN_SCALAR){
+            (*tokens)++;
+            sum += lexeme.value;
+            line += lex_token(line, line_end, &lexeme, CHAR_COMMA) + 1;
+        }
+    } else if (lexeme.type == TOKEN_DIRECTIVE && lexeme.keyword == STRING_DIRECTIVE){
+        lex_token(line, line_end, &lexeme, CHAR_QUOTE);
+        (*tokens)++;
+        sum += lexeme.token.length;
+    } else if (lexeme.type == TOKEN_DIRECTIVE){
+        lex_token(line, line_end, &lexeme, CHAR_SPACE);
+        (*tokens)++;
+        sum += (lexeme.type == TOKEN_SYMBOL && lexeme.legal);
+    } else if (lexeme.type == TOKEN_MNEMONIC && (command = get_command(lexeme.keyword))->num_of_args > 0){
+        line += lex_token(line, line_end, &lexeme, (command->num_of_args == 2) ? CHAR_COMMA : CHAR_SPACE);
+        (*tokens)++;
+        sum += get_addressing_method(&lexeme) + legal_arg(&lexeme);
+
+        if (command->num_of_args == 2){
+            sum += (*line++ != ',' && lexeme.spaced);
+            lex_token(line, line_end, &lexeme, CHAR_SPACE);
+            (*tokens)++;
+            sum += get_addressing_method(&lexeme) + legal_arg(&lexeme);
+        }
+    }
+
+    return sum;
+}
+
+/* Input: the name of the tokenizer, the function that reads a line with it, the starts of the lines and their amount.
+ * Output: returns the checksum of the tokens. Prints the tokens and megabytes read per second.
+ */
+static unsigned long measure(char *name, unsigned long (*read_line)(char *, char *, unsigned long *), char **starts,
+                             unsigned long lines){
+    unsigned long sum = 0, tokens = 0, i;
+    int pass;
+    clock_t start = clock();
+    double seconds;
+
+    for (pass = 0; pass < PASSES; pass++){
+        for (i = 0; i < lines; i++){
+            sum += read_line(starts[i], starts[i + 1], &tokens);
+        }
+    }
+    seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    printf("%-10s %10.1f M tokens/sec %8.1f MB/sec  (%lu tokens, checksum %lu)\n", name,
+           tokens / seconds / 1e6, (double)(starts[lines] - starts[0]) * PASSES / seconds / 1e6, tokens, sum);
+
+    return sum;
+}
+
+int main(int argc, char *argv[]){
+    unsigned long lines = (argc > 1) ? strtoul(argv[1], NULL, 10) : DEFAULT_LINES;
+    unsigned long i, size = 0;
+    char **starts, *program;
+
+    if (lines == 0){
+        printf("Usage: lexerBenchmark [amount of lines]\n");
+        return MISSING_ARGS_ERROR;
+    }
+
+    for (i = 0; i < lines; i++){
+        size += strlen(sample_lines[i % SAMPLE_LINES]);
+    }
+
+    /* the program, and the start of every line followed by the end of the last one */
+    program = (char *)malloc(size);
+    starts = (char **)malloc((lines + 1) * sizeof(char *));
+    if (program == NULL || starts == NULL){
+        printf("Memory allocation error. Terminating!\n");
+        return MEMORY_ALLOC_ERROR;
+    }
+
+    starts[0] = program;
+    for (i = 0; i < lines; i++){
+        size_t length = strlen(sample_lines[i % SAMPLE_LINES]);
+
+        memcpy(starts[i], sample_lines[i % SAMPLE_LINES], length);
+        starts[i + 1] = starts[i] + length;
+    }
+
+    printf("%lu lines, %lu bytes, %d passes\n", lines, size, PASSES);
+    if (measure("previous", read_line_previous, starts, lines) != measure("lexer", read_line_lexer, starts, lines)){
+        printf("The tokenizers disagree!\n");
+        return 1;
+    }
+
+    free(program);
+    free(starts);
+
+    return 0;
+}
@@ -0,0 +1,49 @@
+/* a benchmark of the in-process API of libassembler.a: assembles the same source again and again out of memory, the way
+ * a tool assembling many snippets would, and reports the snippets assembled per second.
+ * Usage: libraryBenchmark [source file] [amount of times] */
+#include "../assemblerLibrary.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* the source assembled without arguments, and the default amount of times it is assembled */
+#define DEFAULT_SOURCE "examples/ps.as"
+#define DEFAULT_TIMES 20000
+
+/* the most chars of the source that are read */
+#define MAX_SOURCE_SIZE 1048576
+
+int main(int argc, char *argv[]){
+    char *path = (argc > 1) ? argv[1] : DEFAULT_SOURCE;
+    unsigned long times = (argc > 2) ? strtoul(argv[2], NULL, 10) : DEFAULT_TIMES, i, failed = 0, words = 0;
+    char *text = (char *)malloc(MAX_SOURCE_SIZE);
+    AssemblyResult result;
+    size_t size;
+    clock_t start;
+    double seconds;
+    FILE *fp = fopen(path, "r");
+
+    if (fp == NULL || text == NULL){
+        printf("Cannot read %s\n", path);
+        free(text);
+        return 1;
+    }
+
+    size = fread(text, 1, MAX_SOURCE_SIZE, fp); /* read once - only the assembling is measured */
+    fclose(fp);
+
+    start = clock();
+    for (i = 0; i < times; i++){
+        failed += assemble_buffer(text, size, 0, &result);
+        words += result.object.code.size + result.object.data.size;
+        free_assembly_result(&result);
+    }
+    seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    printf("%s: %lu snippets in %.3f s - %.0f snippets/sec, %.0f words/sec (%lu failed)\n", path, times, seconds,
+           times / seconds, words / seconds, failed);
+
+    free(text);
+
+    return 0;
+}
@@ -0,0 +1,14 @@
+; a loop of 2000 * 2000 iterations of 4 commands - about 16M instructions.
+; prints 3 times the amount of iterations, in 12 bits
+MAIN:   clr r2
+        clr r3
+OUTER:  clr r1
+INNER:  inc r1
+        add #3, r3
+        cmp #2000, r1
+        bne %INNER
+        inc r2
+        cmp #2000, r2
+        bne %OUTER
+        prn r3
+        stop
@@ -0,0 +1,188 @@
+/* a microbenchmark that compares the open-addressing table of tableTools.c with the previous fixed-size chained table,
+ * at 1k, 100k and 1M symbols.
+ * Usage: tableBenchmark [amount of lookups per size] */
+#include "../tableTools.h"
+#include "../generals.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* the amount of buckets of the chained table - as it was defined in tableTools.h */
+#define CHAINED_TABLE_SIZE 50
+
+/* the default amount of lookups measured for every size */
+#define DEFAULT_LOOKUPS 10000
+
+/* the format of the generated symbol names */
+#define SYMBOL_FORMAT "SYM%lu"
+
+/* a cell of the chained table */
+struct chained_cell{
+    struct chained_cell *next;
+    char *key;
+    void *value;
+};
+
+/* the chained table - a fixed array of buckets */
+struct ChainedTable{
+    struct chained_cell *storage[CHAINED_TABLE_SIZE];
+};
+
+/* Input: a string.
+ * Output: the bucket of the string in the chained table.
+ *
+ * This function is the hash function of the chained table.
+ */
+static unsigned int chained_hash(char *s){
+    unsigned int hashval;
+
+    for (hashval = 0; *s != '\0'; s++){
+        hashval = *s + 31 * hashval;
+    }
+
+    return hashval % CHAINED_TABLE_SIZE;
+}
+
+/* Input: a key and the chained table.
+ * Output: the cell of the key, NULL if it is not in the table.
+ *
+ * This function searches the chained table the same way lookup() did.
+ */
+static struct chained_cell *chained_lookup(char *s, struct ChainedTable *table){
+    struct chained_cell *ret;
+
+    for (ret = table->storage[chained_hash(s)]; ret != NULL; ret = ret->next){
+        if (strcmp(s, ret->key) == 0){
+            return ret;
+        }
+    }
+
+    return NULL;
+}
+
+/* Input: a key, a value and the chained table.
+ * Output: the new cell, NULL if an allocation failed.
+ *
+ * This function adds a cell to the head of its bucket. The keys of the benchmark are unique, so unlike install() it
+ * does not search the bucket first - otherwise filling the table with 1M keys would take hours.
+ */
+static struct chained_cell *chained_install(char *key, void *value, struct ChainedTable *table){
+    struct chained_cell *ret = (struct chained_cell *)malloc(sizeof(struct chained_cell));
+    unsigned int hashval = chained_hash(key);
+
+    RETURN_IF_MEMORY_ALLOC_ERROR(ret, NULL)
+    ret->key = (char *)malloc(strlen(key) + 1);
+    RETURN_IF_MEMORY_ALLOC_ERROR(ret->key, NULL)
+
+    strcpy(ret->key, key);
+    ret->value = value;
+    ret->next = table->storage[hashval];
+    table->storage[hashval] = ret;
+
+    return ret;
+}
+
+/* Input: the chained table.
+ * Output: returns nothing.
+ *
+ * This function frees all the cells of the chained table.
+ */
+static void chained_free(struct ChainedTable *table){
+    int i;
+    struct chained_cell *c, *next;
+
+    for (i = 0; i < CHAINED_TABLE_SIZE; i++){
+        for (c = table->storage[i]; c != NULL; c = next){
+            next = c->next;
+            free(c->key);
+            free(c);
+        }
+    }
+}
+
+/* Input: the start and end clock values, and the amount of operations in between.
+ * Output: the average time of an operation in nanoseconds.
+ */
+static double ns_per_op(clock_t start, clock_t end, unsigned long ops){
+    return (double)(end - start) / CLOCKS_PER_SEC * 1e9 / ops;
+}
+
+/* Input: the amount of symbols and the amount of lookups to measure.
+ * Output: returns 0 if succeeded, 1 otherwise. Prints a row for each table.
+ *
+ * This function fills both tables with the received amount of symbols, and measures the insertions and a mix of
+ * successful and failed lookups.
+ */
+static int run(unsigned long symbols, unsigned long lookups){
+    Table *table = (Table *)calloc(1, sizeof(Table));
+    struct ChainedTable *chained = (struct ChainedTable *)calloc(1, sizeof(struct ChainedTable));
+    char name[MAX_SYMBOL_LENGTH];
+    unsigned long i, found;
+    clock_t start, end;
+
+    RETURN_IF_MEMORY_ALLOC_ERROR(table, 1)
+    RETURN_IF_MEMORY_ALLOC_ERROR(chained, 1)
+
+    /* the open-addressing table */
+    start = clock();
+    for (i = 0; i < symbols; i++){
+        sprintf(name, SYMBOL_FORMAT, i);
+        RETURN_IF_MEMORY_ALLOC_ERROR(install(name, table, table), 1)
+        table->cells[table->count - 1].value = NULL; /* the value is only a marker, so free_table must not free it */
+    }
+    end = clock();
+    printf("%-15s %9lu symbols  install %8.1f ns", "open-addressing", symbols, ns_per_op(start, end, symbols));
+
+    start = clock();
+    for (i = 0, found = 0; i < lookups; i++){ /* every second lookup searches a key that is not in the table */
+        sprintf(name, SYMBOL_FORMAT, (i * 7919) % (symbols * 2));
+        found += (lookup(name, table) != NULL);
+    }
+    end = clock();
+    printf("  lookup %10.1f ns  (%lu found)\n", ns_per_op(start, end, lookups), found);
+
+    /* the chained table */
+    start = clock();
+    for (i = 0; i < symbols; i++){
+        sprintf(name, SYMBOL_FORMAT, i);
+        RETURN_IF_MEMORY_ALLOC_ERROR(chained_install(name, NULL, chained), 1)
+    }
+    end = clock();
+    printf("%-15s %9lu symbols  install %8.1f ns", "chained (50)", symbols, ns_per_op(start, end, symbols));
+
+    start = clock();
+    for (i = 0, found = 0; i < lookups; i++){
+        sprintf(name, SYMBOL_FORMAT, (i * 7919) % (symbols * 2));
+        found += (chained_lookup(name, chained) != NULL);
+    }
+    end = clock();
+    printf("  lookup %10.1f ns  (%lu found)\n", ns_per_op(start, end, lookups), found);
+
+    free_table(table);
+    chained_free(chained);
+    free(table);
+    free(chained);
+
+    return 0;
+}
+
+int main(int argc, char *argv[]){
+    unsigned long sizes[] = {1000, 100000, 1000000};
+    unsigned long lookups = (argc > 1) ? strtoul(argv[1], NULL, 10) : DEFAULT_LOOKUPS;
+    unsigned int i;
+
+    if (lookups == 0){
+        printf("Usage: tableBenchmark [amount of lookups per size]\n");
+        return MISSING_ARGS_ERROR;
+    }
+
+    for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++){
+        if (run(sizes[i], lookups) != 0){
+            printf("Memory allocation error. Terminating!\n");
+            return MEMORY_ALLOC_ERROR;
+        }
+    }
+
+    return 0;
+}
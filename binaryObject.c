@@ -0,0 +1,648 @@
+#include "binaryObject.h"
+#include "imageTools.h"
+#include "numberingSystems.h"
+#include "assemblyStats.h"
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* the offsets of the fields of the header, in fields */
+enum header_field {MAGIC_FIELD=0, VERSION_FIELD, FLAGS_FIELD, CODE_BASE_FIELD, CODE_SIZE_FIELD, DATA_SIZE_FIELD,
+                   ENTRIES_FIELD, EXTERNS_FIELD, POOL_SIZE_FIELD};
+
+/* round a size up to a multiple of 4 bytes */
+#define ALIGN4(size) (((size) + 3) / 4 * 4)
+
+/* the offset of the entries in a binary object with the received amount of words */
+#define SYMBOLS_OFFSET(words) (BINARY_OBJ_HEADER_SIZE + ALIGN4((size_t)(words) * 2))
+
+/* Input: a destination and a value.
+ * Output: returns a pointer to the byte after the value. Writes the lowest 32 bits of the value, in little-endian order.
+ */
+static unsigned char *put_u32(unsigned char *dest, unsigned long value){
+    dest[0] = (unsigned char)(value & 0xFF);
+    dest[1] = (unsigned char)((value >> 8) & 0xFF);
+    dest[2] = (unsigned char)((value >> 16) & 0xFF);
+    dest[3] = (unsigned char)((value >> 24) & 0xFF);
+
+    return dest + 4;
+}
+
+/* Input: a pointer to 4 bytes.
+ * Output: returns the 32-bit little-endian value stored in them.
+ */
+static unsigned long get_u32(const unsigned char *src){
+    return (unsigned long)src[0] | ((unsigned long)src[1] << 8) | ((unsigned long)src[2] << 16) |
+           ((unsigned long)src[3] << 24);
+}
+
+/* Input: an image.
+ * Output: returns the address of the first word of the image, or CODE_LOADING_ADDRESS for an empty image.
+ */
+static unsigned int image_base(Image *image){
+    return (image->size > 0) ? image->words[0].IC : CODE_LOADING_ADDRESS;
+}
+
+/* Input: an object file to fill, the code and data images, the arrays of entries and externals and their sizes, and
+ * the stream to write errors to.
+ * Output: returns 0 if succeeded, 1 if memory allocation failed.
+ *
+ * Algorithm: count the usages of the externals, and allocate the symbols of the object - an entry for every .entry
+ * symbol, and a usage for every address in which an external is used, in the order of the text files. Mark the text
+ * files the assembler builds as well. The names are the names of the symbols, and the images are shared.
+ */
+int fill_object(ObjectFile *object, Image *codeImage, Image *dataImage, Symbol *entries[], int ent_size,
+                Symbol *externs[], int ext_size, FILE *log){
+    Usage *usage;
+    unsigned int usages = 0;
+    int i;
+
+    for (i = 0; i < ext_size - 1; i++){ /* count the usages of the externals */
+        for (usage = externs[i]->usage->next; usage != NULL; usage = usage->next){
+            usages++;
+        }
+    }
+
+    object->code = *codeImage;
+    object->data = *dataImage;
+    object->entries = (ObjectSymbol *)counted_malloc(sizeof(ObjectSymbol) * ent_size); /* never 0 symbols */
+    object->externs = (ObjectSymbol *)counted_malloc(sizeof(ObjectSymbol) * (usages + 1));
+    object->entries_size = 0;
+    object->externs_size = 0;
+    object->flags = ((ent_size > 1) ? HAS_ENTRY_FILE : 0) | ((ext_size > 1) ? HAS_EXTERN_FILE : 0);
+
+    if (object->entries == NULL || object->externs == NULL){
+        fprintf(log, "Memory allocation error! File creation failed.\n");
+        free(object->entries);
+        free(object->externs);
+        return 1;
+    }
+
+    for (i = 0; i < ent_size - 1; i++){
+        object->entries[object->entries_size].name = entries[i]->name;
+        object->entries[object->entries_size++].value = entries[i]->value;
+    }
+
+    for (i = 0; i < ext_size - 1; i++){
+        for (usage = externs[i]->usage->next; usage != NULL; usage = usage->next){
+            object->externs[object->externs_size].name = externs[i]->name;
+            object->externs[object->externs_size++].value = usage->value;
+        }
+    }
+
+    return 0;
+}
+
+/* Input: the code and data images, the arrays of entries and externals and their sizes, the base filename and the
+ * stream to write errors to.
+ * Output: builds the binary object file. Returns 0 if completed successfully, 1 otherwise.
+ *
+ * Algorithm: fill an object with the images and the symbols, write it and free its symbols.
+ */
+int build_binary_object_file(Image *codeImage, Image *dataImage, Symbol *entries[], int ent_size, Symbol *externs[],
+                             int ext_size, char *base_filename, FILE *log){
+    ObjectFile object;
+    int errors;
+
+    if (fill_object(&object, codeImage, dataImage, entries, ent_size, externs, ext_size, log) != 0){
+        return 1;
+    }
+
+    errors = write_binary_object(&object, base_filename, log);
+
+    free(object.entries);
+    free(object.externs);
+
+    return errors;
+}
+
+/* Input: an array of symbols, its size, the string pool, the offset of the next name in it and a destination.
+ * Output: returns a pointer to the byte after the symbols. Updates the offset.
+ *
+ * Algorithm: for every symbol, write the offset of its name and its value. A name equal to the name of the previous
+ * symbol - the usages of an external follow each other - shares its offset. Otherwise, copy the name to the pool, if
+ * there is one, and advance the offset past it.
+ */
+static unsigned char *put_symbols(ObjectSymbol *symbols, unsigned int size, char *pool, unsigned long *offset,
+                                  unsigned char *dest){
+    unsigned long name_offset = 0;
+    unsigned int i;
+
+    for (i = 0; i < size; i++){
+        if (i == 0 || strcmp(symbols[i].name, symbols[i - 1].name) != 0){ /* a new name */
+            name_offset = *offset;
+            if (pool != NULL){
+                strcpy(pool + name_offset, symbols[i].name);
+            }
+            *offset += strlen(symbols[i].name) + 1;
+        }
+
+        if (dest != NULL){
+            dest = put_u32(dest, name_offset);
+            dest = put_u32(dest, symbols[i].value);
+        }
+    }
+
+    return dest;
+}
+
+/* Input: an object file, the base filename and the stream to write errors to.
+ * Output: returns 0 if the file was written, 1 otherwise.
+ *
+ * Algorithm: first, compute the size of the string pool, and from it the size of the file. Allocate a buffer of that
+ * size, write the header, every word - packed with its ARE tag - the padding, the symbols and the pool into it, and
+ * write the buffer to the file at once. Free the buffer, and return whether the writing failed.
+ */
+int write_binary_object(ObjectFile *object, char *base_filename, FILE *log){
+    unsigned int words = object->code.size + object->data.size;
+    unsigned long pool_size = 0, offset = 0;
+    unsigned char *content, *dest;
+    size_t size;
+    unsigned int i, tag;
+    BinCodeNode *word;
+    int errors;
+
+    put_symbols(object->entries, object->entries_size, NULL, &pool_size, NULL); /* only measure the pool */
+    put_symbols(object->externs, object->externs_size, NULL, &pool_size, NULL);
+
+    size = SYMBOLS_OFFSET(words) + (size_t)(object->entries_size + object->externs_size) * BINARY_OBJ_SYMBOL_SIZE +
+           pool_size;
+    content = (unsigned char *)counted_calloc(size, 1); /* the padding stays zero */
+
+    if (content == NULL){
+        fprintf(log, "Memory allocation error! File creation failed.\n");
+        return 1;
+    }
+
+    memcpy(content, BINARY_OBJ_MAGIC, 4);
+    dest = put_u32(content + 4, BINARY_OBJ_VERSION);
+    dest = put_u32(dest, object->flags);
+    dest = put_u32(dest, (object->code.size > 0) ? image_base(&object->code) : image_base(&object->data));
+    dest = put_u32(dest, object->code.size);
+    dest = put_u32(dest, object->data.size);
+    dest = put_u32(dest, object->entries_size);
+    dest = put_u32(dest, object->externs_size);
+    dest = put_u32(dest, pool_size);
+
+    for (i = 0; i < words; i++){ /* pack the words of both images */
+        word = (i < object->code.size) ? &object->code.words[i] : &object->data.words[i - object->code.size];
+        tag = (word->are == R) ? ARE_TAG_R : (word->are == E) ? ARE_TAG_E : ARE_TAG_A;
+        *dest++ = (unsigned char)(word->code & 0xFF);
+        *dest++ = (unsigned char)(((word->code & WORD_MASK) >> 8) | (tag << (ARE_TAG_SHIFT - 8)));
+    }
+
+    dest = content + SYMBOLS_OFFSET(words); /* skip the padding */
+    dest = put_symbols(object->entries, object->entries_size, (char *)content + size - pool_size, &offset, dest);
+    put_symbols(object->externs, object->externs_size, (char *)content + size - pool_size, &offset, dest);
+
+    errors = write_output_file(base_filename, BINARY_OBJ_EXTENSION, (char *)content, size, log);
+    free(content);
+
+    return errors;
+}
+
+/* Input: the base filename, an extension, a source file to fill and a pointer to the file to set.
+ * Output: returns 0 if the file was opened and read, 1 otherwise.
+ *
+ * Algorithm: construct the filename - the base and the extension - and open the file. If it was opened, make its
+ * content available using the source reader, which maps it into memory. Free the filename.
+ */
+static int open_object_file(char *base_filename, char *extension, SourceFile *source, FILE **file){
+    char *filename = (char *)malloc(strlen(base_filename) + strlen(extension) + 1);
+
+    RETURN_IF_MEMORY_ALLOC_ERROR(filename, 1)
+
+    strcpy(filename, base_filename);
+    *file = fopen(strcat(filename, extension), "rb");
+    free(filename);
+
+    if (*file == NULL){
+        return 1;
+    }
+
+    if (open_source(source, *file) != 0){
+        fclose(*file);
+        *file = NULL;
+        return 1;
+    }
+
+    return 0;
+}
+
+/* Input: a source file and the file it was read from.
+ * Output: returns nothing. Unmaps and closes the file.
+ */
+static void close_object_file(SourceFile *source, FILE *file){
+    close_source(source);
+    fclose(file);
+}
+
+/* Input: an image to fill and the amount of words.
+ * Output: returns 0 if succeeded, 1 if memory allocation failed.
+ *
+ * Algorithm: allocate exactly the received amount of words, and mark the image as full.
+ */
+static int allocate_image(Image *image, unsigned int size){
+    image->words = (size > 0) ? (BinCodeNode *)counted_malloc(sizeof(BinCodeNode) * size) : NULL;
+    image->size = image->capacity = (image->words != NULL) ? size : 0;
+
+    return (size > 0 && image->words == NULL);
+}
+
+/* Input: an array of symbols to fill, their amount, the first of them in the file, the string pool and its size.
+ * Output: returns 0 if succeeded, 1 if a name is out of the pool or memory allocation failed.
+ *
+ * Algorithm: for every symbol, ensure the offset of its name points into the pool and the name is terminated before
+ * its end. Copy the name out of the file, into the arena, and read the value.
+ */
+static int get_symbols(ObjectSymbol *symbols, unsigned long size, const unsigned char *src, const char *pool,
+                       unsigned long pool_size, Arena *arena){
+    unsigned long i, offset;
+
+    for (i = 0; i < size; i++, src += BINARY_OBJ_SYMBOL_SIZE){
+        offset = get_u32(src);
+        if (offset >= pool_size || memchr(pool + offset, '\0', pool_size - offset) == NULL){
+            return 1;
+        }
+
+        symbols[i].name = arena_copy_string(arena, (char *)pool + offset, strlen(pool + offset));
+        RETURN_IF_MEMORY_ALLOC_ERROR(symbols[i].name, 1)
+        symbols[i].value = (unsigned int)get_u32(src + 4);
+    }
+
+    return 0;
+}
+
+/* Input: an object file to fill, the base filename, an arena and the stream to write errors to.
+ * Output: returns 0 if the file was read, 1 otherwise.
+ *
+ * Algorithm: map the file, and ensure it holds a header with the right magic and version, and exactly the size the
+ * header describes. Then, unpack every word - the address follows the one before it, starting from the address of the
+ * first code word - and ensure its ARE tag is valid. Read the entries and the usages of externals, with their names
+ * copied out of the pool. Unmap the file, and free the images if something failed.
+ */
+int read_binary_object(ObjectFile *object, char *base_filename, Arena *arena, FILE *log){
+    const unsigned char *content, *src;
+    unsigned long code_size, data_size, entries_size, externs_size, pool_size, base, word, i;
+    SourceFile source;
+    FILE *file;
+    int errors = 1;
+
+    memset(object, 0, sizeof(ObjectFile));
+
+    if (open_object_file(base_filename, BINARY_OBJ_EXTENSION, &source, &file) != 0){
+        fprintf(log, "Error opening file: %s%s\n", base_filename, BINARY_OBJ_EXTENSION);
+        return 1;
+    }
+
+    content = (const unsigned char *)source.data;
+
+    if (source.size < BINARY_OBJ_HEADER_SIZE || memcmp(content, BINARY_OBJ_MAGIC, 4) != 0 ||
+        get_u32(content + 4 * VERSION_FIELD) != BINARY_OBJ_VERSION){
+        fprintf(log, "Error in %s%s: not a binary object file\n", base_filename, BINARY_OBJ_EXTENSION);
+        close_object_file(&source, file);
+        return 1;
+    }
+
+    base = get_u32(content + 4 * CODE_BASE_FIELD);
+    code_size = get_u32(content + 4 * CODE_SIZE_FIELD);
+    data_size = get_u32(content + 4 * DATA_SIZE_FIELD);
+    entries_size = get_u32(content + 4 * ENTRIES_FIELD);
+    externs_size = get_u32(content + 4 * EXTERNS_FIELD);
+    pool_size = get_u32(content + 4 * POOL_SIZE_FIELD);
+    object->flags = (unsigned int)get_u32(content + 4 * FLAGS_FIELD);
+
+    /* every size is below 2^32, so with a size_t of 64 bits the sum cannot overflow. A smaller size_t is guarded by
+     * bounding every size with the size of the file first */
+    if (code_size > source.size || data_size > source.size || entries_size > source.size || externs_size > source.size ||
+        pool_size > source.size || SYMBOLS_OFFSET(code_size + data_size) + (entries_size + externs_size) *
+        BINARY_OBJ_SYMBOL_SIZE + pool_size != source.size){
+        fprintf(log, "Error in %s%s: the size of the file doesn't match its header\n", base_filename, BINARY_OBJ_EXTENSION);
+        close_object_file(&source, file);
+        return 1;
+    }
+
+    object->entries = (ObjectSymbol *)arena_alloc(arena, sizeof(ObjectSymbol) * (entries_size + 1));
+    object->externs = (ObjectSymbol *)arena_alloc(arena, sizeof(ObjectSymbol) * (externs_size + 1));
+
+    if (object->entries == NULL || object->externs == NULL || allocate_image(&object->code, code_size) != 0 ||
+        allocate_image(&object->data, data_size) != 0){
+        fprintf(log, "Memory allocation error!\n");
+    } else{
+        for (i = 0, src = content + BINARY_OBJ_HEADER_SIZE; i < code_size + data_size; i++, src += 2){
+            BinCodeNode *node = (i < code_size) ? &object->code.words[i] : &object->data.words[i - code_size];
+
+            word = (unsigned long)src[0] | ((unsigned long)src[1] << 8);
+            if ((word >> ARE_TAG_SHIFT) > ARE_TAG_E){
+                break;
+            }
+
+            node->code = (Word)(word & WORD_MASK);
+            node->IC = (unsigned int)(base + i);
+            node->L = 0;
+            node->are = ((word >> ARE_TAG_SHIFT) == ARE_TAG_R) ? R : ((word >> ARE_TAG_SHIFT) == ARE_TAG_E) ? E : A;
+        }
+
+        src = content + SYMBOLS_OFFSET(code_size + data_size);
+        object->entries_size = (unsigned int)entries_size;
+        object->externs_size = (unsigned int)externs_size;
+
+        if (i < code_size + data_size){
+            fprintf(log, "Error in %s%s: an invalid ARE tag in word %lu\n", base_filename, BINARY_OBJ_EXTENSION, i);
+        } else if (get_symbols(object->entries, entries_size, src, (char *)content + source.size - pool_size, pool_size,
+                               arena) != 0 ||
+                   get_symbols(object->externs, externs_size, src + entries_size * BINARY_OBJ_SYMBOL_SIZE,
+                               (char *)content + source.size - pool_size, pool_size, arena) != 0){
+            fprintf(log, "Error in %s%s: an invalid name of a symbol\n", base_filename, BINARY_OBJ_EXTENSION);
+        } else{
+            errors = 0;
+        }
+    }
+
+    close_object_file(&source, file);
+
+    if (errors){
+        free_image(&object->code);
+        free_image(&object->data);
+    }
+
+    return errors;
+}
+
+/* Input: an array of symbols, its size, the base filename, the extension of the file and the stream to write errors to.
+ * Output: returns 0 if the file was written, 1 otherwise.
+ *
+ * Algorithm: compute the exact length of the file - a line for every symbol, with its name and its value padded to
+ * OBJ_VALUE_PADDING digits, just like the .ent and .ext files of the assembler. Allocate a buffer of that length, fill
+ * it with the lines and write it to the file at once.
+ */
+static int write_symbols_file(ObjectSymbol *symbols, unsigned int size, char *base_filename, char *extension, FILE *log){
+    size_t length = 1, name_length; /* never allocate 0 bytes */
+    char *content, *end;
+    unsigned int i;
+    int errors;
+
+    for (i = 0; i < size; i++){ /* the name, a space, the value and a '\n' */
+        length += strlen(symbols[i].name) + decimal_length(symbols[i].value, OBJ_VALUE_PADDING) + 2;
+    }
+
+    content = (char *)counted_malloc(length);
+    if (content == NULL){
+        fprintf(log, "Memory allocation error! File creation failed.\n");
+        return 1;
+    }
+
+    for (i = 0, end = content; i < size; i++){
+        name_length = strlen(symbols[i].name);
+        memcpy(end, symbols[i].name, name_length);
+        end += name_length;
+        *end++ = ' ';
+        end = unsigned_to_decimal(symbols[i].value, OBJ_VALUE_PADDING, end);
+        *end++ = '\n';
+    }
+
+    errors = write_output_file(base_filename, extension, content, end - content, log);
+    free(content);
+
+    return errors;
+}
+
+/* Input: an object file, the base filename and the stream to write errors to.
+ * Output: returns 0 if the files were written, 1 otherwise.
+ *
+ * Algorithm: build the object file from the images, the same way the assembler does. Then, write the .ent and .ext
+ * files, only if the object has them.
+ */
+int write_text_object(ObjectFile *object, char *base_filename, FILE *log){
+    if (build_object_file(&object->code, &object->data, base_filename, log) != 0){
+        return 1;
+    }
+
+    if ((object->flags & HAS_ENTRY_FILE) &&
+        write_symbols_file(object->entries, object->entries_size, base_filename, ENT_EXTENSION, log) != 0){
+        return 1;
+    }
+
+    if ((object->flags & HAS_EXTERN_FILE) &&
+        write_symbols_file(object->externs, object->externs_size, base_filename, EXT_EXTENSION, log) != 0){
+        return 1;
+    }
+
+    return 0;
+}
+
+/* Input: a source file, and a buffer of MAX_LINE_LENGTH chars.
+ * Output: returns 1 if a line was read, 0 at the end of the file.
+ *
+ * Algorithm: read the next line of the source, and copy it to the buffer - terminated, so it can be parsed with sscanf.
+ */
+static int copy_next_line(SourceFile *source, char *buffer){
+    char *line, *line_end;
+
+    if (!next_line(source, &line, &line_end)){
+        return 0;
+    }
+
+    memcpy(buffer, line, line_end - line);
+    buffer[line_end - line] = '\0';
+
+    return 1;
+}
+
+/* Input: the base filename, the extension of the file, pointers to the array of symbols and its size to set, a pointer
+ * to the flags of the object, the flag of the file, an arena and the stream to write errors to.
+ * Output: returns 0 if the file was read or doesn't exist, 1 otherwise.
+ *
+ * Algorithm: open the file - if it doesn't exist, there are no symbols. Otherwise, set the flag, count the lines and
+ * allocate a symbol for each out of the arena. Read every line: a name and a value, separated by a space.
+ */
+int read_symbols_file(char *base_filename, char *extension, ObjectSymbol **symbols, unsigned int *size,
+                             unsigned int *flags, unsigned int flag, Arena *arena, FILE *log){
+    char line[MAX_LINE_LENGTH], name[MAX_LINE_LENGTH];
+    unsigned int lines = 0, value;
+    SourceFile source;
+    FILE *file;
+    size_t i;
+
+    *symbols = NULL;
+    *size = 0;
+
+    if (open_object_file(base_filename, extension, &source, &file) != 0){
+        return 0; /* the object has no such symbols */
+    }
+
+    *flags |= flag;
+
+    for (i = 0; i < source.size; i++){ /* count the lines */
+        lines += (source.data[i] == '\n');
+    }
+
+    *symbols = (ObjectSymbol *)arena_alloc(arena, sizeof(ObjectSymbol) * (lines + 1));
+    if (*symbols == NULL){
+        fprintf(log, "Memory allocation error!\n");
+        close_object_file(&source, file);
+        return 1;
+    }
+
+    while (*size < lines && copy_next_line(&source, line)){
+        if (sscanf(line, "%s %u", name, &value) != 2 ||
+            ((*symbols)[*size].name = arena_copy_string(arena, name, strlen(name))) == NULL){
+            fprintf(log, "Error in %s%s: invalid line %u\n", base_filename, extension, *size + 1);
+            close_object_file(&source, file);
+            return 1;
+        }
+
+        (*symbols)[(*size)++].value = value;
+    }
+
+    close_object_file(&source, file);
+
+    return 0;
+}
+
+/* Input: a reader to open, the base filename and the stream to write errors to.
+ * Output: returns 0 if the .ob file was opened, 1 otherwise.
+ *
+ * Algorithm: open the .ob file of the received base filename, and read its head - the sizes of the images.
+ */
+int open_object_reader(ObjectReader *reader, char *base_filename, FILE *log){
+    char line[MAX_LINE_LENGTH];
+
+    memset(reader, 0, sizeof(ObjectReader));
+    reader->base_filename = base_filename;
+
+    if (open_object_file(base_filename, OBJ_EXTENSION, &reader->source, &reader->file) != 0){
+        fprintf(log, "Error opening file: %s%s\n", base_filename, OBJ_EXTENSION);
+        return 1;
+    }
+
+    if (!copy_next_line(&reader->source, line) || sscanf(line, "%u %u", &reader->code_size, &reader->data_size) != 2){
+        fprintf(log, "Error in %s%s: missing the sizes of the images\n", base_filename, OBJ_EXTENSION);
+        close_object_reader(reader);
+        return 1;
+    }
+
+    return 0;
+}
+
+/* Input: a reader, and a word to fill.
+ * Output: returns 1 if a word was read, 0 if all the words were already read, -1 if the line is missing or invalid.
+ *
+ * Algorithm: parse the next line in place, without copying it: skip the spaces, read the address in decimal base, the
+ * code in hexadecimal base and the ARE. Ensure the code fits in a word, the ARE is valid and the address follows the
+ * address of the previous word, as in every object file of the assembler.
+ */
+int read_object_word(ObjectReader *reader, BinCodeNode *word){
+    char *line, *line_end;
+    unsigned int address = 0, code = 0, digits;
+    int digit;
+
+    if (reader->words == reader->code_size + reader->data_size){
+        return 0;
+    }
+
+    if (!next_line(&reader->source, &line, &line_end)){
+        return -1;
+    }
+
+    for (; line < line_end && isspace(*line); line++)
+        ;
+    for (digits = 0; line < line_end && isdigit(*line) && digits < MAX_DECIMAL_DIGITS - 1; line++, digits++){
+        address = address * 10 + (unsigned int)(*line - '0');
+    }
+    if (digits == 0 || line == line_end || !isspace(*line)){
+        return -1;
+    }
+
+    for (; line < line_end && isspace(*line); line++)
+        ;
+    for (digits = 0; line < line_end && isxdigit(*line) && code <= WORD_MASK; line++, digits++){
+        digit = isdigit(*line) ? *line - '0' : toupper(*line) - 'A' + 10;
+        code = code * 16 + (unsigned int)digit;
+    }
+    if (digits == 0 || code > WORD_MASK || line == line_end || !isspace(*line)){
+        return -1;
+    }
+
+    for (; line < line_end && isspace(*line); line++)
+        ;
+    if (line == line_end || (*line != A && *line != R && *line != E) ||
+        (reader->words > 0 && address != reader->base + reader->words)){
+        return -1;
+    }
+
+    reader->base = (reader->words == 0) ? address : reader->base; /* the addresses start at the first word */
+    reader->words++;
+
+    word->code = (Word)code;
+    word->IC = address;
+    word->L = 0;
+    word->are = (enum ARE)*line;
+
+    return 1;
+}
+
+/* Input: a reader.
+ * Output: returns nothing. Unmaps and closes the .ob file.
+ */
+void close_object_reader(ObjectReader *reader){
+    if (reader->file != NULL){
+        close_object_file(&reader->source, reader->file);
+        reader->file = NULL;
+    }
+}
+
+/* Input: an object file to fill, the base filename, an arena and the stream to write errors to.
+ * Output: returns 0 if the files were read, 1 otherwise.
+ *
+ * Algorithm: open a reader of the .ob file - which reads the sizes of the images - and allocate both images. Read
+ * every word with the reader, which validates it. Then, read the .ent and .ext files, if they exist. Free the images
+ * if something failed.
+ */
+int read_text_object(ObjectFile *object, char *base_filename, Arena *arena, FILE *log){
+    ObjectReader reader;
+    unsigned int i;
+    int errors = 1;
+
+    memset(object, 0, sizeof(ObjectFile));
+
+    if (open_object_reader(&reader, base_filename, log) != 0){
+        return 1;
+    }
+
+    if (reader.code_size > reader.source.size || reader.data_size > reader.source.size || /* every word takes a line */
+        allocate_image(&object->code, reader.code_size) != 0 || allocate_image(&object->data, reader.data_size) != 0){
+        fprintf(log, "Error in %s%s: invalid sizes of the images\n", base_filename, OBJ_EXTENSION);
+    } else{
+        for (i = 0; i < reader.code_size + reader.data_size; i++){
+            BinCodeNode *node = (i < reader.code_size) ? &object->code.words[i] : &object->data.words[i - reader.code_size];
+
+            if (read_object_word(&reader, node) != 1){
+                break;
+            }
+        }
+
+        if (i < reader.code_size + reader.data_size){
+            fprintf(log, "Error in %s%s: invalid line %u\n", base_filename, OBJ_EXTENSION, i + 2);
+        } else{
+            errors = 0;
+        }
+    }
+
+    close_object_reader(&reader);
+
+    if (errors == 0 &&
+        (read_symbols_file(base_filename, ENT_EXTENSION, &object->entries, &object->entries_size, &object->flags,
+                           HAS_ENTRY_FILE, arena, log) != 0 ||
+         read_symbols_file(base_filename, EXT_EXTENSION, &object->externs, &object->externs_size, &object->flags,
+                           HAS_EXTERN_FILE, arena, log) != 0)){
+        errors = 1;
+    }
+
+    if (errors){
+        free_image(&object->code);
+        free_image(&object->data);
+    }
+
+    return errors;
+}
@@ -0,0 +1,154 @@
+#ifndef BINARY_OBJECT_H
+#define BINARY_OBJECT_H
+
+#include "buildOutputFiles.h"
+
+#define BINARY_OBJ_EXTENSION ".obj"
+
+/* the first bytes of every binary object file, and the version of the format */
+#define BINARY_OBJ_MAGIC "SCOB"
+#define BINARY_OBJ_VERSION 1
+
+/* the layout of a binary object file. All the numbers are little-endian, so the file can be mapped and read in place:
+ *  a header of BINARY_OBJ_HEADER_FIELDS 32-bit fields - the magic, the version, the flags, the address of the first
+ *      code word, the sizes of the code and data images, the amount of entries, the amount of usages of externals and
+ *      the size of the string pool.
+ *  the words of the code image, followed by the words of the data image, 16 bits each: the word in the lowest
+ *      WORD_SIZE bits, and the ARE tag in the 2 bits above it. The data image follows the code image in memory too.
+ *  padding to a multiple of 4 bytes.
+ *  the entries, and then the usages of externals: 2 32-bit fields each - the offset of the name in the string pool,
+ *      and the value of the entry or the address of the usage.
+ *  the string pool - the names, each terminated by a '\0'. */
+#define BINARY_OBJ_HEADER_FIELDS 9
+#define BINARY_OBJ_HEADER_SIZE (BINARY_OBJ_HEADER_FIELDS * 4)
+#define BINARY_OBJ_SYMBOL_SIZE 8
+
+/* the ARE tags of the packed words */
+#define ARE_TAG_SHIFT WORD_SIZE
+#define ARE_TAG_A 0
+#define ARE_TAG_R 1
+#define ARE_TAG_E 2
+
+/* the flags of the header, which mark the text files the object has - so converting it back creates exactly them */
+#define HAS_ENTRY_FILE 1
+#define HAS_EXTERN_FILE 2
+
+/* a symbol of an object file - an entry and its value, or a usage of an external and its address */
+struct ObjectSymbol{
+    char *name;
+    unsigned int value;
+};
+
+typedef struct ObjectSymbol ObjectSymbol;
+
+/* the content of an object file, in either format */
+struct ObjectFile{
+    Image code; /* the code image, with the address and ARE of every word */
+    Image data; /* the data image, right after the code image */
+    ObjectSymbol *entries; /* the entries, in the order of the .ent file */
+    unsigned int entries_size;
+    ObjectSymbol *externs; /* the usages of externals, in the order of the .ext file */
+    unsigned int externs_size;
+    unsigned int flags; /* HAS_ENTRY_FILE and HAS_EXTERN_FILE */
+};
+
+typedef struct ObjectFile ObjectFile;
+
+/* a reader of the words of a .ob file, one at a time - so an object of any size is read without holding its images */
+struct ObjectReader{
+    char *base_filename;
+    SourceFile source; /* the .ob file, mapped into memory */
+    FILE *file;
+    unsigned int code_size; /* the sizes of the images, from the head of the file */
+    unsigned int data_size;
+    unsigned int words; /* the amount of words read */
+    unsigned int base; /* the address of the first word */
+};
+
+typedef struct ObjectReader ObjectReader;
+
+/* Input: an object file to fill, the "code image", the "data image", the arrays of entries and externals and their
+ * sizes (as passed to build_entry_file and build_extern_file) and the stream to write errors to.
+ * Output: returns 0 if succeeded, 1 if memory allocation failed.
+ *
+ * This function fills the received object with the whole output of the assembler. The object shares the images and the
+ * names of the symbols; only its arrays of symbols are allocated, and must be freed.
+ */
+int fill_object(ObjectFile *object, Image *codeImage, Image *dataImage, Symbol *entries[], int ent_size,
+                Symbol *externs[], int ext_size, FILE *log);
+
+/* Input: the "code image", the "data image", the arrays of entries and externals and their sizes (as passed to
+ * build_entry_file and build_extern_file), the base filename and the stream to write errors to.
+ * Output: builds the binary object file. Returns 0 if completed successfully, 1 otherwise.
+ *
+ * This function writes the whole output of the assembler - the images, the entries and the usages of the
+ * externals - as a single binary object file.
+ */
+int build_binary_object_file(Image *codeImage, Image *dataImage, Symbol *entries[], int ent_size, Symbol *externs[],
+                             int ext_size, char *base_filename, FILE *log);
+
+/* Input: an object file, the base filename and the stream to write errors to.
+ * Output: returns 0 if the file was written, 1 otherwise.
+ *
+ * This function writes the received object as a binary object file, with the names gathered into the string pool.
+ */
+int write_binary_object(ObjectFile *object, char *base_filename, FILE *log);
+
+/* Input: an object file to fill, the base filename, an arena and the stream to write errors to.
+ * Output: returns 0 if the file was read, 1 otherwise.
+ *
+ * This function reads a binary object file, after ensuring it is well-formed. The names and the symbols are allocated
+ * out of the arena, and the images must be freed with free_image.
+ */
+int read_binary_object(ObjectFile *object, char *base_filename, Arena *arena, FILE *log);
+
+/* Input: an object file, the base filename and the stream to write errors to.
+ * Output: returns 0 if the files were written, 1 otherwise.
+ *
+ * This function writes the received object in the text format - the .ob file, and the .ent and .ext files if the
+ * object has them - exactly as the assembler writes them.
+ */
+int write_text_object(ObjectFile *object, char *base_filename, FILE *log);
+
+/* Input: a reader to open, the base filename and the stream to write errors to.
+ * Output: returns 0 if the .ob file was opened, 1 otherwise.
+ *
+ * This function opens the .ob file of the received base filename and reads the sizes of its images, to read its words
+ * with read_object_word. The reader must be closed with close_object_reader.
+ */
+int open_object_reader(ObjectReader *reader, char *base_filename, FILE *log);
+
+/* Input: a reader, and a word to fill.
+ * Output: returns 1 if a word was read, 0 if all the words were already read, -1 if the line is missing or invalid.
+ *
+ * This function reads the next word of the .ob file - the words of the code image, followed by the words of the data
+ * image - with its address and ARE. A word whose address doesn't follow the previous one is invalid.
+ */
+int read_object_word(ObjectReader *reader, BinCodeNode *word);
+
+/* Input: a reader.
+ * Output: returns nothing.
+ *
+ * This function closes the .ob file of the received reader.
+ */
+void close_object_reader(ObjectReader *reader);
+
+/* Input: the base filename, the extension of the file (ENT_EXTENSION or EXT_EXTENSION), pointers to the array of
+ * symbols and its size to set, a pointer to the flags, the flag of the file, an arena and the stream to write errors to.
+ * Output: returns 0 if the file was read or doesn't exist, 1 otherwise.
+ *
+ * This function reads the .ent or .ext file of the received base filename, in its order, and sets the flag if it
+ * exists. The array and the names are allocated out of the arena.
+ */
+int read_symbols_file(char *base_filename, char *extension, ObjectSymbol **symbols, unsigned int *size,
+                      unsigned int *flags, unsigned int flag, Arena *arena, FILE *log);
+
+/* Input: an object file to fill, the base filename, an arena and the stream to write errors to.
+ * Output: returns 0 if the files were read, 1 otherwise.
+ *
+ * This function reads the .ob file of the received base filename, and its .ent and .ext files if they exist. The names
+ * and the symbols are allocated out of the arena, and the images must be freed with free_image.
+ */
+int read_text_object(ObjectFile *object, char *base_filename, Arena *arena, FILE *log);
+
+#endif
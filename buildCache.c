@@ -0,0 +1,314 @@
+#define _POSIX_C_SOURCE 200809L /* for mkdir and open_memstream */
+
+#include "buildCache.h"
+#include "binaryObject.h"
+#include "listingFile.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/stat.h>
+
+/* the maximum length of the header line of an entry, while it is written */
+#define CACHE_HEADER_LENGTH 256
+
+/* the maximum length of the version of the assembler in a header */
+#define MAX_VERSION_LENGTH 16
+
+/* the amount of hexadecimal digits in the name of an entry - two 32-bit hashes */
+#define ENTRY_NAME_LENGTH 16
+
+/* the extensions of the output files an entry may hold, in the order of their flags: bit i of the flags of the built
+ * files marks the file with the i-th extension */
+static char *cached_extensions[CACHED_FILES] = {OBJ_EXTENSION, ENT_EXTENSION, EXT_EXTENSION, BINARY_OBJ_EXTENSION,
+                                                LST_EXTENSION};
+
+/* Input: a cache, and its directory.
+ * Output: returns 0 if succeeded, 1 if the directory could not be created.
+ *
+ * Algorithm: create the directory - it may already exist - and reset the counts.
+ */
+int open_build_cache(BuildCache *cache, char *directory){
+    if (mkdir(directory, 0777) != 0 && errno != EEXIST){
+        printf("Error creating the cache directory %s: %s\n", directory, strerror(errno));
+        return 1;
+    }
+
+    cache->directory = directory;
+    cache->hits = 0;
+    cache->misses = 0;
+    pthread_mutex_init(&cache->lock, NULL);
+
+    return 0;
+}
+
+/* Input: a cache, an assembly source file and the flags of the optional output files.
+ * Output: returns the path of the entry of the source in the cache, or NULL if memory allocation failed.
+ *
+ * Algorithm: hash the version of the assembler, the flags and the source with two different 32-bit hashes - FNV-1a,
+ * and the xor variant of djb2 - and name the entry after both, in hexadecimal base. The flag of the format of the
+ * diagnostics is left out, since they are saved in no format.
+ */
+static char *entry_path(BuildCache *cache, SourceFile *source, unsigned int outputs){
+    unsigned long fnv = 2166136261UL, djb = 5381;
+    char *path, *version = ASSEMBLER_VERSION;
+    size_t i, length = strlen(version) + 1; /* the version and its '\0' */
+    unsigned char c;
+
+    path = (char *)malloc(strlen(cache->directory) + ENTRY_NAME_LENGTH + 2); /* room for the '/' and '\0' */
+    RETURN_IF_MEMORY_ALLOC_ERROR(path, NULL)
+
+    for (i = 0; i < length + 1 + source->size; i++){
+        c = (i < length) ? (unsigned char)version[i] :
+            (i == length) ? (unsigned char)(outputs & ~JSON_DIAGNOSTICS_OUTPUT) :
+            (unsigned char)source->data[i - length - 1];
+        fnv = ((fnv ^ c) * 16777619UL) & 0xFFFFFFFFUL;
+        djb = ((djb * 33) ^ c) & 0xFFFFFFFFUL;
+    }
+
+    sprintf(path, "%s/%08lx%08lx", cache->directory, fnv, djb);
+
+    return path;
+}
+
+/* Input: the base filename, an extension, and the content the file should hold and its length.
+ * Output: returns 1 if the file exists and holds exactly the content, 0 otherwise.
+ */
+static int same_content(char *base_filename, char *extension, char *content, size_t length){
+    char *filename = (char *)malloc(strlen(base_filename) + strlen(extension) + 1);
+    SourceFile file;
+    FILE *fp;
+    int same = 0;
+
+    RETURN_IF_MEMORY_ALLOC_ERROR(filename, 0)
+
+    strcpy(filename, base_filename);
+    fp = fopen(strcat(filename, extension), "rb");
+    free(filename);
+
+    if (fp != NULL){
+        if (open_source(&file, fp) == 0){
+            same = (file.size == length && memcmp(file.data, content, length) == 0);
+            close_source(&file);
+        }
+        fclose(fp);
+    }
+
+    return same;
+}
+
+/* Input: an entry of the cache, an assembly source file, the filename to report, the base filename of the output
+ * files, the format of the diagnostics and the stream to write the messages to.
+ * Output: returns 1 if the entry holds the result of the source and the output files were restored, 0 otherwise.
+ *
+ * Algorithm: parse the header line, and ensure the entry was made by this version of the assembler and its size is
+ * exactly the sum of its parts. Ensure the entry holds the very same source - the name of the entry is only a hash -
+ * and valid diagnostics. Then, restore every output file the entry holds - unless it already holds the content - and
+ * print the diagnostics for the received filename.
+ */
+static int restore_entry(SourceFile *entry, SourceFile *source, char *filename, char *output_base,
+                         enum diagnostics_format format, FILE *log){
+    char line[MAX_LINE_LENGTH], magic[sizeof(CACHE_MAGIC)], version[MAX_VERSION_LENGTH], *start, *end, *content;
+    unsigned long source_size, messages_length, lengths[CACHED_FILES];
+    unsigned int files;
+    size_t total;
+    int i;
+
+    if (!next_line(entry, &start, &end)){
+        return 0;
+    }
+
+    memcpy(line, start, end - start);
+    line[end - start] = '\0';
+
+    if (sscanf(line, "%4s %15s %u %lu %lu %lu %lu %lu %lu %lu", magic, version, &files, &source_size, &messages_length,
+               &lengths[0], &lengths[1], &lengths[2], &lengths[3], &lengths[4]) != 5 + CACHED_FILES ||
+        strcmp(magic, CACHE_MAGIC) != 0 || strcmp(version, ASSEMBLER_VERSION) != 0 || source_size != source->size ||
+        messages_length > entry->size){
+        return 0;
+    }
+
+    total = entry->position + source_size + messages_length;
+    for (i = 0; i < CACHED_FILES; i++){
+        if (lengths[i] > entry->size){ /* the sum cannot overflow */
+            return 0;
+        }
+        total += lengths[i];
+    }
+
+    content = entry->data + entry->position;
+    if (total != entry->size || memcmp(content, source->data, source_size) != 0 || /* a collision, or a broken entry */
+        print_saved_diagnostics(content + source_size, messages_length, NULL, format, NULL) != 0){
+        return 0;
+    }
+
+    for (i = 0, content += source_size + messages_length; i < CACHED_FILES; content += lengths[i++]){
+        if ((files & (1 << i)) && !same_content(output_base, cached_extensions[i], content, lengths[i]) &&
+            write_output_file(output_base, cached_extensions[i], content, lengths[i], log) != 0){
+            return 0;
+        }
+    }
+
+    print_saved_diagnostics(entry->data + entry->position + source_size, messages_length, filename, format, log);
+
+    return 1;
+}
+
+/* Input: a cache, an assembly source file, the filename to report, the base filename of the output files, the flags of
+ * the optional output files and the stream to write the messages to.
+ * Output: returns 1 on a hit, 0 on a miss.
+ *
+ * Algorithm: open the entry of the source and map it into memory. If it exists, restore the result from it. Count the
+ * hit or the miss under the lock.
+ */
+int restore_from_cache(BuildCache *cache, SourceFile *source, char *filename, char *output_base, unsigned int outputs,
+                       FILE *log){
+    char *path = entry_path(cache, source, outputs);
+    SourceFile entry;
+    FILE *fp = (path != NULL) ? fopen(path, "rb") : NULL;
+    int hit = 0;
+
+    if (fp != NULL){
+        if (open_source(&entry, fp) == 0){
+            hit = restore_entry(&entry, source, filename, output_base,
+                                (outputs & JSON_DIAGNOSTICS_OUTPUT) ? JSON_DIAGNOSTICS : TEXT_DIAGNOSTICS, log);
+            close_source(&entry);
+        }
+        fclose(fp);
+    }
+
+    free(path);
+
+    pthread_mutex_lock(&cache->lock);
+    if (hit){
+        cache->hits++;
+    } else{
+        cache->misses++;
+    }
+    pthread_mutex_unlock(&cache->lock);
+
+    return hit;
+}
+
+/* Input: a cache, an assembly source file, the base filename of the output files, the flags of the optional output
+ * files, the flags of the output files that were built, and the diagnostics of the source.
+ * Output: returns nothing.
+ *
+ * Algorithm: save the diagnostics into memory, and map every output file that was built into memory. Write the header
+ * line - the sizes of all the parts of the entry - and compute the size of the entry. Allocate a buffer of that size,
+ * copy the header, the source, the diagnostics and the output files into it, and write it at once - like every output
+ * file, it replaces the entry atomically, so a concurrent reader never sees a partial entry. Unmap the files. Every
+ * step that fails prints a line to the standard error, and the entry is not stored.
+ */
+void store_in_cache(BuildCache *cache, SourceFile *source, char *output_base, unsigned int outputs,
+                    unsigned int output_files, Diagnostics *diagnostics){
+    SourceFile files[CACHED_FILES];
+    FILE *fps[CACHED_FILES], *saved;
+    char header[CACHE_HEADER_LENGTH], *path = entry_path(cache, source, outputs), *filename, *content = NULL, *end;
+    char *messages = NULL; /* the saved diagnostics */
+    size_t total, header_length, messages_length = 0;
+    int i, opened = 0;
+
+    filename = (char *)malloc(strlen(output_base) + strlen(BINARY_OBJ_EXTENSION) + 1); /* the longest extension */
+
+    if ((saved = open_memstream(&messages, &messages_length)) != NULL){
+        save_diagnostics(diagnostics, saved);
+        if (fclose(saved) != 0){ /* sets the saved diagnostics and their length */
+            saved = NULL; /* there is nothing to store */
+        }
+    }
+
+    if (path == NULL || filename == NULL){
+        fprintf(stderr, "Error storing %s in the cache: out of memory!\n", output_base);
+    } else if (saved == NULL){
+        fprintf(stderr, "Error storing %s in the cache: cannot save its diagnostics!\n", output_base);
+    }
+
+    for (; saved != NULL && path != NULL && filename != NULL && opened < CACHED_FILES; opened++){ /* map the files */
+        fps[opened] = NULL;
+        files[opened].size = 0;
+
+        if (output_files & (1 << opened)){
+            strcpy(filename, output_base);
+            fps[opened] = fopen(strcat(filename, cached_extensions[opened]), "rb");
+
+            if (fps[opened] == NULL || open_source(&files[opened], fps[opened]) != 0){
+                if (fps[opened] != NULL){
+                    fclose(fps[opened]);
+                }
+                fprintf(stderr, "Error storing %s in the cache: cannot read %s!\n", output_base, filename);
+                break;
+            }
+        }
+    }
+
+    if (opened == CACHED_FILES){
+        header_length = sprintf(header, "%s %s %u %lu %lu %lu %lu %lu %lu %lu\n", CACHE_MAGIC, ASSEMBLER_VERSION,
+                                output_files, (unsigned long)source->size, (unsigned long)messages_length,
+                                (unsigned long)files[0].size, (unsigned long)files[1].size,
+                                (unsigned long)files[2].size, (unsigned long)files[3].size,
+                                (unsigned long)files[4].size);
+        total = header_length + source->size + messages_length;
+        for (i = 0; i < CACHED_FILES; i++){
+            total += files[i].size;
+        }
+
+        if ((content = (char *)malloc(total)) == NULL){
+            fprintf(stderr, "Error storing %s in the cache: out of memory!\n", output_base);
+        }
+    }
+
+    if (content != NULL){
+        memcpy(content, header, header_length);
+        memcpy(content + header_length, source->data, source->size);
+        end = content + header_length + source->size;
+        memcpy(end, messages, messages_length);
+        end += messages_length;
+
+        for (i = 0; i < CACHED_FILES; i++){
+            if (fps[i] != NULL){
+                memcpy(end, files[i].data, files[i].size);
+                end += files[i].size;
+            }
+        }
+
+        write_output_file(path, "", content, total, stderr); /* the entry is named by its path alone */
+    }
+
+    while (--opened >= 0){ /* unmap the files that were mapped */
+        if (fps[opened] != NULL){
+            close_source(&files[opened]);
+            fclose(fps[opened]);
+        }
+    }
+
+    free(messages);
+    free(content);
+    free(filename);
+    free(path);
+}
+
+/* Input: a cache, the format of the statistics and the stream to write to.
+ * Output: returns nothing.
+ *
+ * Algorithm: compute the hit rate out of all the lookups - 0 if there were none - and print the counts with it.
+ */
+void print_cache_stats(BuildCache *cache, enum stats_format format, FILE *out){
+    unsigned long lookups = cache->hits + cache->misses;
+    double rate = (lookups > 0) ? (double)cache->hits / lookups : 0;
+
+    if (format == JSON_STATS){
+        fprintf(out, "{\"cache_hits\": %lu, \"cache_misses\": %lu, \"cache_hit_rate\": %.3f}\n",
+                cache->hits, cache->misses, rate);
+    } else if (format == TEXT_STATS){
+        fprintf(out, "Build cache: %lu hits, %lu misses (%.1f%% hit rate)\n", cache->hits, cache->misses, 100 * rate);
+    }
+}
+
+/* Input: a cache.
+ * Output: returns nothing.
+ *
+ * Algorithm: destroy the lock of the counts.
+ */
+void close_build_cache(BuildCache *cache){
+    pthread_mutex_destroy(&cache->lock);
+}
@@ -0,0 +1,74 @@
+#ifndef BUILD_CACHE_H
+#define BUILD_CACHE_H
+
+#include <stdio.h>
+#include <pthread.h>
+#include "sourceReader.h"
+#include "assemblyStats.h"
+#include "diagnostics.h"
+
+/* the first chars of every entry of the cache */
+#define CACHE_MAGIC "SCAC"
+
+/* the amount of output files an entry may hold - the .ob, .ent, .ext, .obj and .lst files */
+#define CACHED_FILES 5
+
+/* a directory of the results of assembling sources, keyed by a hash of the source, the version of the assembler and
+ * the optional output files. An entry is a single file: a header line with the sizes of its parts, followed by the
+ * source itself - so a collision of the hash is never mistaken for a hit - the diagnostics of the source, saved without
+ * the name of the file or a format, and the output files that were built. Only successful compilations are stored, so
+ * a source shares its entry with any identical source, whatever its name and the format of its diagnostics. */
+struct BuildCache{
+    char *directory;
+    unsigned long hits; /* the amount of files found in the cache */
+    unsigned long misses; /* the amount of files assembled since they were not */
+    pthread_mutex_t lock; /* guards hits and misses, which files assembled at once update */
+};
+
+typedef struct BuildCache BuildCache;
+
+/* Input: a cache to initialize, and its directory.
+ * Output: returns 0 if succeeded, 1 if the directory could not be created.
+ *
+ * This function prepares the cache in the received directory, creating the directory if it doesn't exist.
+ */
+int open_build_cache(BuildCache *cache, char *directory);
+
+/* Input: a cache, an assembly source file, the filename to report, the base filename of the output files, the flags of
+ * the optional output files and the stream to write the messages to.
+ * Output: returns 1 on a hit, 0 on a miss.
+ *
+ * This function looks the received source up in the cache. On a hit, the diagnostics of the compilation are printed
+ * to the received stream - for the received filename, in the format set in the flags - and the output files are
+ * restored. An output file that already holds the cached content is kept as is, so its modification time doesn't
+ * change.
+ */
+int restore_from_cache(BuildCache *cache, SourceFile *source, char *filename, char *output_base, unsigned int outputs,
+                       FILE *log);
+
+/* Input: a cache, an assembly source file, the base filename of the output files, the flags of the optional output
+ * files, the flags of the output files that were built, and the diagnostics of the source.
+ * Output: returns nothing.
+ *
+ * This function stores the result of a successful compilation of the received source in the cache. A failure to store
+ * it is not an error of the compilation - it is reported to the standard error, and the compilation is not affected.
+ */
+void store_in_cache(BuildCache *cache, SourceFile *source, char *output_base, unsigned int outputs,
+                    unsigned int output_files, Diagnostics *diagnostics);
+
+/* Input: a cache, the format of the statistics and the stream to write to.
+ * Output: returns nothing.
+ *
+ * This function prints the amount of hits and misses of the cache and its hit rate, in the received format - nothing
+ * for NO_STATS.
+ */
+void print_cache_stats(BuildCache *cache, enum stats_format format, FILE *out);
+
+/* Input: a cache.
+ * Output: returns nothing.
+ *
+ * This function releases the resources of the received cache. The entries stay in its directory.
+ */
+void close_build_cache(BuildCache *cache);
+
+#endif
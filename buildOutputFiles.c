@@ -1,205 +1,400 @@
-#include "buildOutputFiles.h"
+#define _POSIX_C_SOURCE 200809L /* for open, write, close and getpid */
+
+#include "binaryObject.h" /* includes buildOutputFiles.h */
 #include "numberingSystems.h"
+#include "assemblyStats.h"
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+
+/* the length of a line of the object file, without its address - a space, the word, a space, the ARE and the '\n' */
+#define OBJECT_LINE_LENGTH (HEX_WORD_LENGTH + 4)
+
+/* the amount of times a name is tried for a temporary file, in case names of a process that exited are left over */
+#define MAX_TEMP_ATTEMPTS 100
 
-/* the format for the values addresses - four zeros padding */
-#define VALUE_PADDING "%04d"
-#define UNSIGNED_VALUE_PADDING "%04u"
+/* the amount of temporary files the process created, which tells their names apart */
+static unsigned long temp_files = 0;
+
+/* guards temp_files, which files written at once update */
+static pthread_mutex_t temp_files_lock = PTHREAD_MUTEX_INITIALIZER;
 
 /* check if the memory allocation for the array was successful - if not, inform the user, free both and return 1 */
 #define CHECK_ARR_ALLOC(x) if (x == NULL){ \
-                                printf("Memory allocation error! File creation failed.\n"); \
+                                fprintf(log, "Memory allocation error! File creation failed.\n"); \
                                 free(externals); \
                                 free(entries); \
                                 return 1; \
                             }
 
-/* check whether the file was opened\created successfully - if not, inform about the error and return 1 */
-#define CHECK_FILE_OPEN(x) if (outputFile == NULL){ \
-                                printf("Error creating object file for %s!\n", filename); \
+/* check if the memory allocation for the content of a file was successful - if not, inform the user and return 1 */
+#define CHECK_CONTENT_ALLOC(x) if (x == NULL){ \
+                                fprintf(log, "Memory allocation error! File creation failed.\n"); \
                                 return 1; \
                             }
 
-/* Input: the list representing "code image", the list representing "data image", a pointer to the symbols table, the base filename,
- * along with the instructions and data counters.
- * Output: builds the output files - .ob, .ent (if entries were defined) and .ext (if there are external symbols). Returns 0 if
- * build completed successfully, 1 otherwise.
+/* Input: the name of an output file, and a buffer for the temporary name.
+ * Output: returns the descriptor of the temporary file, or -1 if it could not be created.
  *
- * Algorithm: first, allocate memory for the externals and entries array, and ensure it succeeded. Then, create the object
- * files and return 1 if an error occurred, after freeing the arrays. Then, iterate through all the symbols in the table,
- * and fill the externals and entries arrays. At last, create both the .ent file and .ext file - only if needed! If an
- * error occurred, return 1 - otherwise, 0 is returned.
+ * Algorithm: take the next count of the temporary files under the lock, and name the file after the output file, the
+ * id of the process and the count. Create it exclusively - with the permissions fopen uses - so an existing file is
+ * never written over. If the name is taken - left over by a process with the same id - try the next count.
  */
-int build_output_files(BinCodeNode *codeList, BinCodeNode *dataList, Table *symbols_table, char *base_filename, int instSize, int dataSize){
-    int ext_size = 1; /* current size of the array of .extern symbols */
-    int ent_size = 1; /* current size of the array of .entry symbols */
+int create_temp_file(char *filename, char *temp_filename){
+    unsigned long count;
+    int fd = -1, attempts;
+
+    for (attempts = 0; attempts < MAX_TEMP_ATTEMPTS; attempts++){
+        pthread_mutex_lock(&temp_files_lock);
+        count = temp_files++;
+        pthread_mutex_unlock(&temp_files_lock);
+
+        sprintf(temp_filename, "%s.%lu.%lu%s", filename, (unsigned long)getpid(), count, TEMP_EXTENSION);
+        fd = open(temp_filename, O_WRONLY | O_CREAT | O_EXCL, 0666);
+        if (fd >= 0 || errno != EEXIST){
+            break;
+        }
+    }
 
-    int i; /* for the for loop */
-    cell *c;
+    return fd;
+}
 
-    /* allocate memory for the .extern and .entry symbols arrays */
-    Symbol **externals = (Symbol **)malloc(sizeof(Symbol *) * ext_size);
-    Symbol **entries = (Symbol **)malloc(sizeof(Symbol *) * ent_size);
+/* Input: the base filename, the extension of the file, its content, the length of the content and the stream to write
+ * errors to.
+ * Output: returns 0 if the file was written, 1 otherwise.
+ *
+ * Algorithm: construct the filename - the base and the extension - in a buffer large enough for the temporary name
+ * next to it as well, and create the temporary file. Write the whole content to it - a single write, unless the
+ * system writes less than asked, or the write is interrupted before writing anything and is retried. A write that
+ * writes nothing is a failure, like any other. Then, close the file and rename it to the filename, so the file is
+ * replaced at once and a reader never sees a partial file. If something failed, inform the user and remove the
+ * temporary file. In any case, free the names.
+ */
+int write_output_file(char *base_filename, char *extension, char *content, size_t length, FILE *log){
+    size_t filename_length = strlen(base_filename) + strlen(extension);
+    char *filename = (char *)counted_malloc(2 * filename_length + MAX_TEMP_SUFFIX_LENGTH + 1); /* both names, '\0's */
+    char *temp_filename;
+    ssize_t written;
+    int fd, errors = 0;
 
-    /* ensure all memory allocations succeeded */
-    CHECK_ARR_ALLOC(externals)
-    CHECK_ARR_ALLOC(entries)
+    RETURN_IF_MEMORY_ALLOC_ERROR(filename, 1) /* ensure memory allocation succeeded */
+
+    /* construct the filename, and the temporary name right after it */
+    strcpy(filename, base_filename);
+    strcat(filename, extension);
+    temp_filename = filename + filename_length + 1;
+
+    fd = create_temp_file(filename, temp_filename);
+    if (fd < 0){ /* ensure file created successfully */
+        fprintf(log, "Error creating object file for %s!\n", filename);
+        free(filename);
+        return 1;
+    }
+
+    while (length > 0){ /* write the rest of the content */
+        written = write(fd, content, length);
+        if (written > 0){
+            content += written;
+            length -= (size_t)written;
+        } else if (written == 0 || errno != EINTR){ /* only an interrupted write is retried */
+            break;
+        }
+    }
+
+    if (close(fd) != 0 || length > 0 || rename(temp_filename, filename) != 0){ /* ensure all the content was written */
+        fprintf(log, "Error writing file %s!\n", filename);
+        remove(temp_filename);
+        errors = 1;
+    }
+
+    free(filename); /* free the names */
+
+    return errors;
+}
+
+/* Input: the name of a symbol.
+ * Output: returns the bucket of the symbol in the order of the .ent and .ext files.
+ */
+unsigned int output_order_bucket(char *name){
+    unsigned int hashval;
+
+    for (hashval = 0; *name != '\0'; name++){
+        hashval = *name + OUTPUT_ORDER_MULTIPLIER * hashval;
+    }
+
+    return hashval % OUTPUT_ORDER_BUCKETS;
+}
+
+/* Input: the "code image", the "data image", a pointer to the symbols table, the base filename, the
+ * stream to write errors to, the statistics of the file, in which the time of building every file is recorded, the
+ * flags of the optional output files and an object to fill instead of building the files (NULL for none).
+ * Output: builds the output files - .ob, .ent (if entries were defined), .ext (if there are external symbols) and .obj
+ * (if requested) - or fills the object. Returns 0 if build completed successfully, 1 otherwise.
+ *
+ * Algorithm: first, create the object file and return 1 if an error occurred. Then, count the entries and externals in
+ * the symbols table - in every bucket of the order of the files - allocate memory for arrays of exactly that size, and
+ * ensure it succeeded. The counts tell where every bucket starts in the arrays. Iterate through all the symbols in the
+ * table again, from the last one defined, and fill the externals and entries arrays - every symbol at the next place of
+ * its bucket, so the latest symbols come first within a bucket. At last, create both the .ent file and .ext
+ * file - only if needed! If requested, build the binary object file out of the same arrays. If an error occurred,
+ * return 1 - otherwise, 0 is returned. Measure the time of building each of the files. If an object was received, no
+ * file is built at all: the object is filled out of the same arrays instead.
+ */
+int build_output_files(Image *codeImage, Image *dataImage, Table *symbols_table, char *base_filename, FILE *log,
+                       AssemblyStats *stats, unsigned int outputs, ObjectFile *object){
+    double start; /* the time the building of the current file started */
+    int ext_size = 1; /* size of the array of .extern symbols - the amount of symbols plus 1 */
+    int ent_size = 1; /* size of the array of .entry symbols - the amount of symbols plus 1 */
+    int errors = 0;
+    Symbol **externals, **entries;
+    unsigned int ent_next[OUTPUT_ORDER_BUCKETS + 1]; /* the next place of every bucket in the entries array */
+    unsigned int ext_next[OUTPUT_ORDER_BUCKETS + 1]; /* the next place of every bucket in the externals array */
+
+    unsigned int i; /* for the for loop */
 
     /* build the object file. If operation failed, return 1 */
-    if (build_object_file(codeList, dataList, base_filename, instSize, dataSize) != 0){
-        free(externals);
-        free(entries);
+    start = now_ms();
+    if (object == NULL && build_object_file(codeImage, dataImage, base_filename, log) != 0){
         return 1;
     }
+    stats->object_file_ms = now_ms() - start;
+    stats->output_files = (object == NULL) ? OBJECT_FILE_BUILT : 0;
+
+    memset(ent_next, 0, sizeof(ent_next));
+    memset(ext_next, 0, sizeof(ext_next));
+
+    for (i = 0; i < symbols_table->count; i++) { /* count the .entry and .extern symbols, after their bucket starts */
+        Symbol *symbol = (Symbol *)symbols_table->cells[i].value; /* get the current symbol */
+
+        if (symbol->isEntry == true || symbol->isExternal == true){
+            unsigned int bucket = output_order_bucket(symbol->name);
+
+            ent_next[bucket + 1] += (symbol->isEntry == true);
+            ext_next[bucket + 1] += (symbol->isExternal == true);
+        }
+    }
 
-    for (i = 0; i < TABLE_SIZE; i++) {
-        for (c = symbols_table->storage[i];  c != NULL ; c = c->next) { /* iterate through all the symbols */
-            Symbol *symbol = (Symbol *)c->value; /* get the current symbol */
+    for (i = 1; i <= OUTPUT_ORDER_BUCKETS; i++){ /* every bucket starts after the buckets before it */
+        ent_next[i] += ent_next[i - 1];
+        ext_next[i] += ext_next[i - 1];
+    }
 
-            if (symbol->isEntry == true){ /* check if the current symbol is a .entry one */
-                entries[ent_size-1] = symbol; /* add the symbol to the array */
-                ent_size++; /* update the size of the entries array */
+    ent_size += ent_next[OUTPUT_ORDER_BUCKETS];
+    ext_size += ext_next[OUTPUT_ORDER_BUCKETS];
 
-                entries = (Symbol **)realloc(entries,sizeof(Symbol *) * ent_size); /* reallocate memory for more entries */
-                CHECK_ARR_ALLOC(entries) /* ensure memory allocation succeeded */
-            }
+    /* allocate memory for the .extern and .entry symbols arrays */
+    externals = (Symbol **)counted_malloc(sizeof(Symbol *) * ext_size);
+    entries = (Symbol **)counted_malloc(sizeof(Symbol *) * ent_size);
 
-            if (symbol->isExternal == true){ /* check if the current symbol is a .extern one */
-                externals[ext_size-1] = symbol; /* add the symbol to the array */
-                ext_size++; /* update the size of the externals array */
+    /* ensure all memory allocations succeeded */
+    CHECK_ARR_ALLOC(externals)
+    CHECK_ARR_ALLOC(entries)
 
-                externals = (Symbol **)realloc(externals, sizeof(Symbol *) * ext_size); /* reallocate memory for more entries */
-                CHECK_ARR_ALLOC(externals) /* ensure memory allocation succeeded */
-            }
+    for (i = symbols_table->count; i-- > 0;) { /* iterate through all the symbols, from the last one defined */
+        Symbol *symbol = (Symbol *)symbols_table->cells[i].value; /* get the current symbol */
+
+        if (symbol->isEntry == true){ /* check if the current symbol is a .entry one */
+            entries[ent_next[output_order_bucket(symbol->name)]++] = symbol; /* add the symbol to its bucket */
+        }
+
+        if (symbol->isExternal == true){ /* check if the current symbol is a .extern one */
+            externals[ext_next[output_order_bucket(symbol->name)]++] = symbol; /* add the symbol to its bucket */
         }
     }
 
+    if (object != NULL){ /* fill the object instead of building the files */
+        errors = fill_object(object, codeImage, dataImage, entries, ent_size, externals, ext_size, log);
+
+        free(externals);
+        free(entries);
+
+        return errors;
+    }
+
     /* build the entries file only if there are .entry symbols */
-    if (ent_size > 1 && build_entry_file(entries, ent_size, base_filename) != 0){ /* build the entries file. If operation failed, return 1 */
-        return 1;
+    start = now_ms();
+    if (ent_size > 1 && build_entry_file(entries, ent_size, base_filename, log) != 0){ /* build the entries file. If operation failed, stop */
+        errors = 1;
     }
+    stats->output_files |= (ent_size > 1) ? ENTRY_FILE_BUILT : 0;
+    stats->entry_file_ms = now_ms() - start;
 
     /* build the externals file only if there are .extern symbols */
-    if (ext_size > 1 && build_extern_file(externals, ext_size, base_filename) != 0){ /* build the externals file. If operation failed, return 1 */
-        return 1;
+    start = now_ms();
+    if (!errors && ext_size > 1 && build_extern_file(externals, ext_size, base_filename, log) != 0){ /* build the externals file. If operation failed, stop */
+        errors = 1;
     }
+    stats->output_files |= (ext_size > 1) ? EXTERN_FILE_BUILT : 0;
+    stats->extern_file_ms = now_ms() - start;
 
-    /* free the dynamically allocated arrays */
+    /* build the binary object file only if it was requested */
+    if (!errors && (outputs & BINARY_OBJECT_OUTPUT) &&
+        build_binary_object_file(codeImage, dataImage, entries, ent_size, externals, ext_size, base_filename, log) != 0){
+        errors = 1;
+    }
+    stats->output_files |= (outputs & BINARY_OBJECT_OUTPUT) ? BINARY_OBJECT_FILE_BUILT : 0;
+
+    /* free the dynamically allocated arrays - a server keeps running after a failure */
     free(externals);
     free(entries);
 
-    return 0; /* if we arrived here, all went well and we return 0 */
+    return errors; /* 0 if all went well */
 }
 
-/* Input: the list representing "code image", the list representing "data image", the base filename along with the
- * instructions and data counters.
- * Output: builds the object file. Returns 0 if completed successfully, 1 otherwise.
+/* Input: an image.
+ * Output: returns the amount of chars format_image writes for the image.
  *
- * Algorithm: first, allocate memory for the filename and construct it (after ensuring memory allocation didn't fail) -
- * concatenate the "base" name with the .ob extension. Then, open the file, and return 1 if an error occurred.
- * Write the size of the instructions image and data image at the head of the file, and then each of the instructions
- * in the required format. Then, in the same format, write the data image to the file. Before returning 0, close the file
- * and free the string.
+ * Algorithm: every line has the same length, except for its address - add the length of every address, padded to
+ * OBJ_VALUE_PADDING digits, to the length of the rest of the lines.
  */
-int build_object_file(BinCodeNode *codeList, BinCodeNode *dataList, char *base_filename, int instSize, int dataSize){
-    char *filename = (char *)malloc(sizeof(char) * strlen(base_filename)); /* allocate memory for the filename */
-    FILE *outputFile;
-
-    RETURN_IF_MEMORY_ALLOC_ERROR(filename, 1) /* ensure memory allocation succeeded */
+size_t formatted_image_length(Image *image){
+    size_t length = (size_t)image->size * OBJECT_LINE_LENGTH;
+    unsigned int i;
 
-    /* construct the filename and create the file */
-    strcpy(filename, base_filename);
-    outputFile = fopen(strcat(filename, OBJ_EXTENSION), "w"); /* create the object file in write mode */
-
-    CHECK_FILE_OPEN(outputFile) /* ensure file created successfully */
-
-    /* write the size of the instructions image and data image at the head of the file */
-    fprintf(outputFile, "\t%d %d\n", instSize, dataSize); /* write to the file the sizes of the instructions and data images */
-
-    while (codeList != NULL){ /* write all the code to the file */
-        fprintf(outputFile, VALUE_PADDING " %s %c\n", codeList->IC, bin_to_hex(codeList->code), codeList->are);
-        codeList = codeList->next; /* continue to the next node */
+    for (i = 0; i < image->size; i++){
+        length += decimal_length(image->words[i].IC, OBJ_VALUE_PADDING);
     }
 
+    return length;
+}
 
-    while (dataList != NULL){ /* write all the data to the file */
-        fprintf(outputFile, VALUE_PADDING " %s %c\n", dataList->IC, bin_to_hex(dataList->code), dataList->are);
-        dataList = dataList->next; /* continue to the next node */
+/* Input: an image and a destination of at least formatted_image_length(image) chars.
+ * Output: returns a pointer to the char after the lines written. Writes a line of the object file for every word.
+ *
+ * Algorithm: for every word, write its address padded to OBJ_VALUE_PADDING digits, its code as hexadecimal digits and
+ * its ARE, separated by spaces and followed by a '\n' - the same line the object file always had, written straight into
+ * the destination using the lookup tables of the numbering systems.
+ */
+char *format_image(Image *image, char *dest){
+    BinCodeNode *word = image->words, *end = image->words + image->size;
+
+    for (; word < end; word++){ /* format the words in a single pass */
+        dest = unsigned_to_decimal(word->IC, OBJ_VALUE_PADDING, dest);
+        *dest++ = ' ';
+        dest = word_to_hex(word->code, dest);
+        *dest++ = ' ';
+        *dest++ = (char)word->are;
+        *dest++ = '\n';
     }
 
-    fclose(outputFile); /* close the file */
-    free(filename); /* free the string */
+    return dest;
+}
 
-    return 0; /* if the code arrived here, it means all went successfully so we return 0 */
+/* Input: the "code image", the "data image", the base filename and the stream to write errors to.
+ * Output: builds the object file. Returns 0 if completed successfully, 1 otherwise.
+ *
+ * Algorithm: first, compute the exact length of the file - the head, which holds the sizes of the instructions image and
+ * data image, and the lines of both images. Allocate a buffer of that length, write the head into it, and then format
+ * the instructions image and the data image into it. Write the buffer to the file at once, and free it. Return 1 if an
+ * error occurred, 0 otherwise.
+ */
+int build_object_file(Image *codeImage, Image *dataImage, char *base_filename, FILE *log){
+    size_t length = decimal_length(codeImage->size, 1) + decimal_length(dataImage->size, 1) + 3 + /* a tab, a space, '\n' */
+                    formatted_image_length(codeImage) + formatted_image_length(dataImage);
+    char *content = (char *)counted_malloc(length); /* the content of the file */
+    char *end; /* the char after the last one written */
+    int errors;
+
+    CHECK_CONTENT_ALLOC(content) /* ensure memory allocation succeeded */
+
+    /* write the size of the instructions image and data image at the head of the file, then all the code and data */
+    end = content;
+    *end++ = '\t';
+    end = unsigned_to_decimal(codeImage->size, 1, end);
+    *end++ = ' ';
+    end = unsigned_to_decimal(dataImage->size, 1, end);
+    *end++ = '\n';
+    end = format_image(codeImage, end);
+    end = format_image(dataImage, end);
+
+    errors = write_output_file(base_filename, OBJ_EXTENSION, content, end - content, log);
+    free(content);
+
+    return errors;
 }
 
-/* Input: an array containing pointers to the different symbols that are entries, its size and the base filename.
+/* Input: an array containing pointers to the different symbols that are entries, its size, the base filename and
+ * the stream to write errors to.
  * Output: builds the entry file. Returns 0 if completed successfully, 1 otherwise.
  *
- * Algorithm: first, allocate memory for the filename and construct it (after ensuring memory allocation didn't fail) -
- * concatenate the "base" name with the .ent extension. Then, open the file, and return 1 if an error occurred. Then,
- * iterate through the received array, and for each symbol write a line containing its name and value. Before returning 0,
- * close the file and free the string.
+ * Algorithm: first, compute the exact length of the file - a line for every symbol in the received array, containing
+ * its name and its value, padded to OBJ_VALUE_PADDING digits. Allocate a buffer of that length, fill it with the lines,
+ * and write it to the file at once. Free the buffer, and return 1 if an error occurred, 0 otherwise.
  */
-int build_entry_file(Symbol *entries[], int size, char *base_filename){
-    char *filename = (char *)malloc(sizeof(char) * strlen(base_filename)); /* allocate memory for the filename */
-    FILE *outputFile;
+int build_entry_file(Symbol *entries[], int size, char *base_filename, FILE *log){
+    size_t length = 0, name_length;
+    char *content, *end;
     int i; /* for the for loop */
+    int errors;
 
-    RETURN_IF_MEMORY_ALLOC_ERROR(filename, 1) /* ensure memory allocation succeeded */
-
-    /* construct the filename and create the file */
-    strcpy(filename, base_filename);
-    outputFile = fopen(strcat(filename, ENT_EXTENSION), "w"); /* create the entries file in write mode */
-
-    CHECK_FILE_OPEN(outputFile) /* ensure file created successfully */
+    for (i = 0; i < size - 1; i++) { /* the name, a space, the value and a '\n' */
+        length += strlen(entries[i]->name) + decimal_length(entries[i]->value, OBJ_VALUE_PADDING) + 2;
+    }
 
-    for (i = 0; i < size - 1; i++) { /* write all the entries to the file */
-        /* write the name of the entry symbol and the value (address) to the file */
-        fprintf(outputFile, "%s " VALUE_PADDING "\n", entries[i]->name, entries[i]->value);
+    content = (char *)counted_malloc(length + 1); /* never allocate 0 bytes */
+    CHECK_CONTENT_ALLOC(content) /* ensure memory allocation succeeded */
+
+    for (i = 0, end = content; i < size - 1; i++) { /* write all the entries */
+        /* write the name of the entry symbol and the value (address) */
+        name_length = strlen(entries[i]->name);
+        memcpy(end, entries[i]->name, name_length);
+        end += name_length;
+        *end++ = ' ';
+        end = unsigned_to_decimal(entries[i]->value, OBJ_VALUE_PADDING, end);
+        *end++ = '\n';
     }
 
-    fclose(outputFile); /* close the file */
-    free(filename); /* free the string */
+    errors = write_output_file(base_filename, ENT_EXTENSION, content, end - content, log);
+    free(content);
 
-    return 0; /* if the code arrived here, it means all went successfully so we return 0 */
+    return errors;
 }
 
-/* Input: an array containing pointers to the different symbols that are externals, its size and the base filename.
+/* Input: an array containing pointers to the different symbols that are externals, its size, the base filename and
+ * the stream to write errors to.
  * Output: builds the extern file. Returns 0 if completed successfully, 1 otherwise.
  *
- * Algorithm: first, allocate memory for the filename and construct it (after ensuring memory allocation didn't fail) -
- * concatenate the "base" name with the .ext extension. Then, open the file, and return 1 if an error occurred. Then,
- * iterate through the received array, and for each symbol write all its usages: each usage in a separate line,
- * containing the name of the symbol and the address in which it is used. Before returning 0, close the file and free the string.
+ * Algorithm: first, compute the exact length of the file - for every symbol in the received array, a line for each of
+ * its usages, containing the name of the symbol and the address in which it is used, padded to OBJ_VALUE_PADDING
+ * digits. Allocate a buffer of that length, fill it with the lines, and write it to the file at once. Free the buffer,
+ * and return 1 if an error occurred, 0 otherwise.
  */
-int build_extern_file(Symbol *externs[], int size, char *base_filename){
-    char *filename = (char *)malloc(sizeof(char) * strlen(base_filename)); /* allocate memory for the filename */
-    FILE *outputFile;
+int build_extern_file(Symbol *externs[], int size, char *base_filename, FILE *log){
+    size_t length = 0, name_length;
+    char *content, *end;
+    Usage *usage;
     int i; /* for the for loop */
+    int errors;
 
-    RETURN_IF_MEMORY_ALLOC_ERROR(filename, 1) /* ensure memory allocation succeeded */
-
-    /* construct the filename and create the file */
-    strcpy(filename, base_filename);
-    outputFile = fopen(strcat(filename, EXT_EXTENSION), "w"); /* create the externs file in write mode */
+    for (i = 0; i < size - 1; i++) { /* the name, a space, the address and a '\n' for every usage */
+        name_length = strlen(externs[i]->name);
+        for (usage = externs[i]->usage->next; usage != NULL; usage = usage->next){
+            length += name_length + decimal_length(usage->value, OBJ_VALUE_PADDING) + 2;
+        }
+    }
 
-    CHECK_FILE_OPEN(outputFile) /* ensure file created successfully */
+    content = (char *)counted_malloc(length + 1); /* never allocate 0 bytes */
+    CHECK_CONTENT_ALLOC(content) /* ensure memory allocation succeeded */
 
-    for (i = 0; i < size - 1; i++) { /* write all the entries to the file */
-        Usage *usage = externs[i]->usage->next; /* get the first usage */
+    for (i = 0, end = content; i < size - 1; i++) { /* write all the usages of the externals */
+        name_length = strlen(externs[i]->name);
 
-        /* write the name of the extern symbol and the values (addresses) in which is it used to the file */
-        while (usage != NULL){
-            fprintf(outputFile, "%s " UNSIGNED_VALUE_PADDING "\n", externs[i]->name, usage->value);
-            usage = usage->next; /* continue to the next usage */
+        /* write the name of the extern symbol and the values (addresses) in which is it used */
+        for (usage = externs[i]->usage->next; usage != NULL; usage = usage->next){
+            memcpy(end, externs[i]->name, name_length);
+            end += name_length;
+            *end++ = ' ';
+            end = unsigned_to_decimal(usage->value, OBJ_VALUE_PADDING, end);
+            *end++ = '\n';
         }
     }
 
-    fclose(outputFile); /* close the file */
-    free(filename); /* free the string */
+    errors = write_output_file(base_filename, EXT_EXTENSION, content, end - content, log);
+    free(content);
 
-    return 0; /* if the code arrived here, it means all went successfully so we return 0 */
-}
\ No newline at end of file
+    return errors;
+}
@@ -1,4 +1,5 @@
 #include "firstScan.h"
+#include "numberingSystems.h"
 
 #define OBJ_EXTENSION ".ob"
 #define ENT_EXTENSION ".ent"
@@ -6,37 +7,97 @@
 
 #define OBJ_VALUE_PADDING 4
 
-/* Input: the list representing "code image", the list representing "data image", a pointer to the symbols table, the base filename,
- * along with the instructions and data counters.
- * Output: builds the output files: .ob, .ent (if entries were defined) and .ext (if there are external symbols). Returns 0 if
- * build completed successfully, 1 otherwise.
+/* the extension added to the name of an output file while it is written */
+#define TEMP_EXTENSION ".tmp"
+
+/* the most chars a temporary name adds to the name of its file - two dots and two numbers before the extension */
+#define MAX_TEMP_SUFFIX_LENGTH (2 + 2 * 20 + sizeof(TEMP_EXTENSION))
+
+/* the hash of the symbols table the assembler first had - 50 chained buckets, each listing its latest symbol first.
+ * The .ent and .ext files list the symbols in the order of that table, so they stay the same */
+#define OUTPUT_ORDER_BUCKETS 50
+#define OUTPUT_ORDER_MULTIPLIER 31
+
+/* the whole output of the assembler in memory, defined in binaryObject.h */
+struct ObjectFile;
+
+/* Input: the "code image", the "data image", a pointer to the symbols table, the base filename, the
+ * stream to write errors to, the statistics of the file, in which the time of building every file is recorded, the
+ * flags of the optional output files and an object to fill instead (NULL for none).
+ * Output: builds the output files: .ob, .ent (if entries were defined), .ext (if there are external symbols) and .obj (if
+ * BINARY_OBJECT_OUTPUT is set). Returns 0 if build completed successfully, 1 otherwise.
  *
  * This function receives the different data necessary to create the output files, and builds them. Returns 0 if all files
- * were built successfully, 1 otherwise.
+ * were built successfully, 1 otherwise. Every file is rendered into a buffer of exactly its size, written with a single
+ * write to a temporary file and renamed over the output file - so a partial output file is never seen. If an object is
+ * received, nothing is written: the object is filled as fill_object does, and the base filename is not used.
+ */
+int build_output_files(Image *codeImage, Image *dataImage, Table *symbols_table, char *base_filename, FILE *log,
+                       AssemblyStats *stats, unsigned int outputs, struct ObjectFile *object);
+
+/* Input: the base filename, the extension of the file, its content, the length of the content and the stream to write
+ * errors to.
+ * Output: returns 0 if the file was written, 1 otherwise.
+ *
+ * This function writes the received content to the file, with a single write to a temporary file that is renamed over
+ * the file once it is complete.
+ */
+int write_output_file(char *base_filename, char *extension, char *content, size_t length, FILE *log);
+
+/* Input: the name of a symbol.
+ * Output: returns the bucket of the symbol in the order of the .ent and .ext files, below OUTPUT_ORDER_BUCKETS.
+ *
+ * This function hashes the name as the first symbols table did. The files list the symbols by their buckets, and the
+ * latest symbol defined (or declared, for an external) first within a bucket.
+ */
+unsigned int output_order_bucket(char *name);
+
+/* Input: the name of an output file, and a buffer for the temporary name - its length and MAX_TEMP_SUFFIX_LENGTH chars.
+ * Output: returns the descriptor of the temporary file, open for writing, or -1 if it could not be created.
+ *
+ * This function creates a new temporary file next to the output file. Its name holds the id of the process and a count
+ * of the temporary files, so files written at once - by threads or by processes - never share a temporary file.
+ */
+int create_temp_file(char *filename, char *temp_filename);
+
+/* Input: an image.
+ * Output: returns the amount of chars format_image writes for the image.
+ *
+ * This function computes the exact length of the lines of the object file for the received image, so the file can be
+ * written from a buffer of exactly its size.
+ */
+size_t formatted_image_length(Image *image);
+
+/* Input: an image and a destination of at least formatted_image_length(image) chars.
+ * Output: returns a pointer to the char after the lines written. Writes a line of the object file for every word.
+ *
+ * This function formats a whole image in a single pass, without any allocation: every word becomes its address, its
+ * code in hexadecimal base and its ARE. The lines are not terminated.
  */
-int build_output_files(BinCodeNode *codeList, BinCodeNode *dataList, Table *symbols_table, char *base_filename, int instSize, int dataSize);
+char *format_image(Image *image, char *dest);
 
-/* Input: the list representing "code image", the list representing "data image", the base filename along with the instructions
- * and data counters.
+/* Input: the "code image", the "data image", the base filename and the stream to write errors to.
  * Output: builds the object file. Returns 0 if completed successfully, 1 otherwise.
  *
  * This function receives the code and data images, builds the object file, and returns 0 if the task was completed
  * successfully. If not, 1 is returned.
  */
-int build_object_file(BinCodeNode *codeList, BinCodeNode *dataList, char *base_filename, int instSize, int dataSize);
+int build_object_file(Image *codeImage, Image *dataImage, char *base_filename, FILE *log);
 
-/* Input: an array containing pointers to the different symbols that are entries, its size and the base filename.
+/* Input: an array containing pointers to the different symbols that are entries, its size, the base filename and
+ * the stream to write errors to.
  * Output: builds the entry file. Returns 0 if completed successfully, 1 otherwise.
  *
  * This function receives an array of pointers to .entry symbols and its size, builds the .ent file, and returns 0 if the
  * task was completed successfully. If not, 1 is returned.
  */
-int build_entry_file(Symbol *entries[], int size, char *base_filename);
+int build_entry_file(Symbol *entries[], int size, char *base_filename, FILE *log);
 
-/* Input: an array containing pointers to the different symbols that are externals, its size and the base filename.
+/* Input: an array containing pointers to the different symbols that are externals, its size, the base filename and
+ * the stream to write errors to.
  * Output: builds the extern file. Returns 0 if completed successfully, 1 otherwise.
  *
  * This function receives an array of pointers to .extern symbols and its size, builds the .ext file, and returns 0 if the
  * task was completed successfully. If not, 1 is returned.
  */
-int build_extern_file(Symbol *externs[], int size, char *filename);
\ No newline at end of file
+int build_extern_file(Symbol *externs[], int size, char *base_filename, FILE *log);
\ No newline at end of file
@@ -1,233 +1,157 @@
-#include "commands.h"
+#include "inputHandlers.h"
 #include "numberingSystems.h"
+#include "imageTools.h"
+#include "assemblyStats.h"
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
 
-/* Input: receives a Table to which the commands should be added.
- * Output: returns 0 if all went successfully, 1 otherwise. Fills the table with the different commands and their properties.
+/* the instruction set, in the order of the opcodes. It is never written to, so all the threads share it */
+static const Command commands[NUM_OF_COMMANDS] = {
+    {"mov", 0, 0, 2, "1101", "0101"},
+    {"cmp", 1, 0, 2, "1101", "1101"},
+    {"add", 2, 10, 2, "1101", "0101"},
+    {"sub", 2, 11, 2, "1101", "0101"},
+    {"lea", 4, 0, 2, "0100", "0101"},
+    {"clr", 5, 10, 1, "0000", "0101"},
+    {"not", 5, 11, 1, "0000", "0101"},
+    {"inc", 5, 12, 1, "0000", "0101"},
+    {"dec", 5, 13, 1, "0000", "0101"},
+    {"jmp", 9, 10, 1, "0000", "0110"},
+    {"bne", 9, 11, 1, "0000", "0110"},
+    {"jsr", 9, 12, 1, "0000", "0110"},
+    {"red", 12, 0, 1, "0000", "0101"},
+    {"prn", 13, 0, 1, "0000", "1101"},
+    {"rts", 14, 0, 0, "0000", "0000"},
+    {"stop", 15, 0, 0, "0000", "0000"}
+};
+
+/* the names of the directives, which are keywords as well. Their indexes follow the indexes of the commands */
+static const char *directives[] = {"data", "string", "entry", "extern"};
+
+/* the index of the keyword of every slot of the perfect hash - a command or a directive - or -1 for an empty slot.
+ * The slots were computed from the names above with keyword_hash(), and no two keywords share a slot */
+static const signed char keyword_slots[KEYWORD_SLOTS] = {
+    14, 15, -1, -1, -1, -1, 2, 12, -1, -1, 1, -1, -1, -1, 17, 19,
+    -1, 11, 0, -1, 3, 7, 4, 16, 8, 18, 5, 9, -1, 13, 10, 6
+};
+
+/* Input: a token of at least 2 chars.
+ * Output: returns the slot of the token in the perfect hash of the keywords.
  *
- * Algorithm: first, allocate memory for all the commands, and ensure none failed. Then, edit the attributes for each command and
- * insert it to the received table using install(). If an insertion failed, 1 is returned. If not, 0 is returned.
+ * Algorithm: combine the first, the second and the last char with the length. The multipliers were found by searching
+ * for the smallest ones that give every keyword a slot of its own.
  */
-int fill_table(Table *table){
-    /* allocate memory for all of the commands */
-    Command *mov = (Command *) malloc(sizeof(Command));
-    Command *cmp = (Command *) malloc(sizeof(Command));
-    Command *add = (Command *) malloc(sizeof(Command));
-    Command *sub = (Command *) malloc(sizeof(Command));
-    Command *lea = (Command *) malloc(sizeof(Command));
-    Command *clr = (Command *) malloc(sizeof(Command));
-    Command *not = (Command *) malloc(sizeof(Command));
-    Command *inc = (Command *) malloc(sizeof(Command));
-    Command *dec = (Command *) malloc(sizeof(Command));
-    Command *jmp = (Command *) malloc(sizeof(Command));
-    Command *bne = (Command *) malloc(sizeof(Command));
-    Command *jsr = (Command *) malloc(sizeof(Command));
-    Command *red = (Command *) malloc(sizeof(Command));
-    Command *prn = (Command *) malloc(sizeof(Command));
-    Command *rts = (Command *) malloc(sizeof(Command));
-    Command *stop = (Command *) malloc(sizeof(Command));
-
-    /* ensure all memory allocation succeeded */
-    RETURN_IF_MEMORY_ALLOC_ERROR(mov, 1)
-    RETURN_IF_MEMORY_ALLOC_ERROR(cmp, 1)
-    RETURN_IF_MEMORY_ALLOC_ERROR(add, 1)
-    RETURN_IF_MEMORY_ALLOC_ERROR(sub, 1)
-    RETURN_IF_MEMORY_ALLOC_ERROR(lea, 1)
-    RETURN_IF_MEMORY_ALLOC_ERROR(clr, 1)
-    RETURN_IF_MEMORY_ALLOC_ERROR(not, 1)
-    RETURN_IF_MEMORY_ALLOC_ERROR(inc, 1)
-    RETURN_IF_MEMORY_ALLOC_ERROR(dec, 1)
-    RETURN_IF_MEMORY_ALLOC_ERROR(jmp, 1)
-    RETURN_IF_MEMORY_ALLOC_ERROR(bne, 1)
-    RETURN_IF_MEMORY_ALLOC_ERROR(jsr, 1)
-    RETURN_IF_MEMORY_ALLOC_ERROR(red, 1)
-    RETURN_IF_MEMORY_ALLOC_ERROR(prn, 1)
-    RETURN_IF_MEMORY_ALLOC_ERROR(rts, 1)
-    RETURN_IF_MEMORY_ALLOC_ERROR(stop, 1)
-
-
-    /* specify the properties of each command and install it to the table */
-    mov->name = "mov";
-    mov->funct = 0;
-    mov->opcode = 0;
-    mov->num_of_args = 2;
-    mov->valid_src_addr_methods = "1101";
-    mov->valid_dst_addr_methods = "0101";
-    RETURN_IF_MEMORY_ALLOC_ERROR(install(mov->name, mov, table), 1) /* add the current command to the table and return in case of failure */
-
-    cmp->name = "cmp";
-    cmp->funct = 0;
-    cmp->opcode = 1;
-    cmp->num_of_args = 2;
-    cmp->valid_src_addr_methods = "1101";
-    cmp->valid_dst_addr_methods = "1101";
-    RETURN_IF_MEMORY_ALLOC_ERROR(install(cmp->name, cmp, table), 1) /* add the current command to the table and return in case of failure */
-
-    add->name = "add";
-    add->funct = 10;
-    add->opcode = 2;
-    add->num_of_args = 2;
-    add->valid_src_addr_methods = "1101";
-    add->valid_dst_addr_methods = "0101";
-    RETURN_IF_MEMORY_ALLOC_ERROR(install(add->name, add, table), 1) /* add the current command to the table and return in case of failure */
-
-    sub->name = "sub";
-    sub->funct = 11;
-    sub->opcode = 2;
-    sub->num_of_args = 2;
-    sub->valid_src_addr_methods = "1101";
-    sub->valid_dst_addr_methods = "0101";
-    RETURN_IF_MEMORY_ALLOC_ERROR(install(sub->name, sub, table), 1) /* add the current command to the table and return in case of failure */
-
-    lea->name = "lea";
-    lea->funct = 0;
-    lea->opcode = 4;
-    lea->num_of_args = 2;
-    lea->valid_src_addr_methods = "0100";
-    lea->valid_dst_addr_methods = "0101";
-    RETURN_IF_MEMORY_ALLOC_ERROR(install(lea->name, lea, table), 1) /* add the current command to the table and return in case of failure */
-
-    clr->name = "clr";
-    clr->funct = 10;
-    clr->opcode = 5;
-    clr->num_of_args = 1;
-    clr->valid_src_addr_methods = "0000";
-    clr->valid_dst_addr_methods = "0101";
-    RETURN_IF_MEMORY_ALLOC_ERROR(install(clr->name, clr, table), 1) /* add the current command to the table and return in case of failure */
-
-    not->name = "not";
-    not->funct = 11;
-    not->opcode = 5;
-    not->num_of_args = 1;
-    not->valid_src_addr_methods = "0000";
-    not->valid_dst_addr_methods = "0101";
-    RETURN_IF_MEMORY_ALLOC_ERROR(install(not->name, not, table), 1) /* add the current command to the table and return in case of failure */
-
-    inc->name = "inc";
-    inc->funct = 12;
-    inc->opcode = 5;
-    inc->num_of_args = 1;
-    inc->valid_src_addr_methods = "0000";
-    inc->valid_dst_addr_methods = "0101";
-    RETURN_IF_MEMORY_ALLOC_ERROR(install(inc->name, inc, table), 1) /* add the current command to the table and return in case of failure */
-
-    dec->name = "dec";
-    dec->funct = 13;
-    dec->opcode = 5;
-    dec->num_of_args = 1;
-    dec->valid_src_addr_methods = "0000";
-    dec->valid_dst_addr_methods = "0101";
-    RETURN_IF_MEMORY_ALLOC_ERROR(install(dec->name, dec, table), 1) /* add the current command to the table and return in case of failure */
-
-    jmp->name = "jmp";
-    jmp->funct = 10;
-    jmp->opcode = 9;
-    jmp->num_of_args = 1;
-    jmp->valid_src_addr_methods = "0000";
-    jmp->valid_dst_addr_methods = "0110";
-    RETURN_IF_MEMORY_ALLOC_ERROR(install(jmp->name, jmp, table), 1) /* add the current command to the table and return in case of failure */
-
-    bne->name = "bne";
-    bne->funct = 11;
-    bne->opcode = 9;
-    bne->num_of_args = 1;
-    bne->valid_src_addr_methods = "0000";
-    bne->valid_dst_addr_methods = "0110";
-    RETURN_IF_MEMORY_ALLOC_ERROR(install(bne->name, bne, table), 1) /* add the current command to the table and return in case of failure */
-
-    jsr->name = "jsr";
-    jsr->funct = 12;
-    jsr->opcode = 9;
-    jsr->num_of_args = 1;
-    jsr->valid_src_addr_methods = "0000";
-    jsr->valid_dst_addr_methods = "0110";
-    RETURN_IF_MEMORY_ALLOC_ERROR(install(jsr->name, jsr, table), 1) /* add the current command to the table and return in case of failure */
-
-    red->name = "red";
-    red->funct = 0;
-    red->opcode = 12;
-    red->num_of_args = 1;
-    red->valid_src_addr_methods = "0000";
-    red->valid_dst_addr_methods = "0101";
-    RETURN_IF_MEMORY_ALLOC_ERROR(install(red->name, red, table), 1); /* add the current command to the table and return in case of failure */
-
-    prn->name = "prn";
-    prn->funct = 0;
-    prn->opcode = 13;
-    prn->num_of_args = 1;
-    prn->valid_src_addr_methods = "0000";
-    prn->valid_dst_addr_methods = "1101";
-    RETURN_IF_MEMORY_ALLOC_ERROR(install(prn->name, prn, table), 1) /* add the current command to the table and return in case of failure */
-
-    rts->name = "rts";
-    rts->funct = 0;
-    rts->opcode = 14;
-    rts->num_of_args = 0;
-    rts->valid_src_addr_methods = "0000";
-    rts->valid_dst_addr_methods = "0000";
-    RETURN_IF_MEMORY_ALLOC_ERROR(install(rts->name, rts, table), 1) /* add the current command to the table and return in case of failure */
-
-    stop->name = "stop";
-    stop->funct = 0;
-    stop->opcode = 15;
-    stop->num_of_args = 0;
-    stop->valid_src_addr_methods = "0000";
-    stop->valid_dst_addr_methods = "0000";
-    RETURN_IF_MEMORY_ALLOC_ERROR(install(stop->name, stop, table), 1); /* add the current command to the table and return in case of failure */
-
-    return 0; /* indicate that everything went well */
+static unsigned int keyword_hash(Token word){
+    return (7 * (unsigned char)word.start[0] + 10 * (unsigned char)word.start[1] +
+            13 * (unsigned char)word.start[word.length - 1] + (unsigned int)word.length) & (KEYWORD_SLOTS - 1);
 }
 
-/* Input: a binary code node, the argument as a string, and its addressing method. Assumption: the argument is valid.
- * Output: constructs the node to match the argument. Returns 0 if no errors occurred, 1 otherwise.
+/* Input: a token.
+ * Output: returns the index of the keyword the token is - the opcode order of a command, followed by the directives -
+ * or -1 if it isn't a keyword.
  *
- * Algorithm: If the addressing method is Immediate, the word of the argument is the binary representation of the scalar.
- * If the argument is a register, allocate memory for the word (ensure it succeeded), set all its chars to '0' except
- * the one in the appropriate index, which is set to '1'. Otherwise, allocate memory for the word in the size of a symbol name,
- * and after ensuring it succeeded, copy the name of the symbol to the word. If the addressing method is Direct, set the
- * ARE property to R. If something failed during function execution, we return 1. If all went fine, 0 is returned.
+ * Algorithm: a token shorter or longer than all the keywords isn't one. Otherwise, hash the token to its slot, and
+ * compare it to the only keyword that might be there - so a token is recognized with a single comparison.
  */
-int constructArg(BinCodeNode *node, char *arg, enum addr_method method){
-    int i = 0;
+int find_keyword(Token word){
+    const char *name;
+    int index;
 
-    if (method == IMMEDIATE){
-        node->code = decimal_to_bin(atoi(arg+1)); /* encode the scalar to binary, skip the # */
-        RETURN_IF_MEMORY_ALLOC_ERROR(node->code, 1) /* ensure conversion succeeded */
-        return 0; /* exit the function and indicate that everything went successfully */
-    } else if (method == IMD_REGISTER){
-        char *word = (char *)malloc(sizeof(char) * WORD_SIZE); /* allocate memory for the argument */
+    if (word.length < MIN_KEYWORD_LENGTH || word.length > MAX_KEYWORD_LENGTH){
+        return -1;
+    }
+
+    index = keyword_slots[keyword_hash(word)];
+    if (index < 0){ /* an empty slot */
+        return -1;
+    }
 
-        /* check if memory allocation completed successfully */
-        RETURN_IF_MEMORY_ALLOC_ERROR(word, 1)
+    name = (index < NUM_OF_COMMANDS) ? commands[index].name : directives[index - NUM_OF_COMMANDS];
 
-        for (i = 0; i < WORD_SIZE; i++){ /* set all the bits to 0 */
-            word[i] = '0';
+    return (strncmp(name, word.start, word.length) == 0 && name[word.length] == '\0') ? index : -1;
+}
+
+/* Input: a token.
+ * Output: returns the command named by the token, or NULL if there is no such command.
+ *
+ * Algorithm: find the keyword the token is, and return the matching command if the keyword is one.
+ */
+const Command *find_command(Token name){
+    int index = find_keyword(name);
+
+    return (index >= 0 && index < NUM_OF_COMMANDS) ? &commands[index] : NULL;
+}
+
+/* Input: the operation code and the funct of a command word.
+ * Output: returns the index of the command, or -1 if there is no such command.
+ *
+ * Algorithm: go over the instruction set, and return the index of the command that has both codes.
+ */
+int find_command_by_code(unsigned int opcode, unsigned int funct){
+    int i;
+
+    for (i = 0; i < NUM_OF_COMMANDS; i++){
+        if (commands[i].opcode == opcode && commands[i].funct == funct){
+            return i;
         }
+    }
+
+    return -1;
+}
 
-        word[WORD_SIZE - atoi(arg+1) - 1] = '1'; /* set the appropriate bit to 1, marking the right register */
-        word[WORD_SIZE] = '\0'; /* mark end of string */
+/* Input: the index of a command.
+ * Output: returns the properties of the command.
+ */
+const Command *get_command(int index){
+    return &commands[index];
+}
+
+/* Input: a binary code node, its index in the code image, the argument as a token, its addressing method, the fix-up
+ * table and the arena of the file. Assumption: the argument is valid.
+ * Output: constructs the node to match the argument. Returns 0 if no errors occurred, 1 otherwise.
+ *
+ * Algorithm: If the addressing method is Immediate, the word of the argument is the value of the scalar.
+ * If the argument is a register, the word has only the bit of the register number set. Otherwise, the word refers to a
+ * symbol: add a reference to the fix-up table, find the end of the name of the symbol, and copy the name into the arena
+ * after ensuring it succeeded (without the % of a relative addressing). Set the reference, along with the
+ * index of the word and the line number stored in the node. If the addressing method is Direct, set the ARE property
+ * to R. If something failed during function execution, we return 1. If all went fine, 0 is returned.
+ */
+int constructArg(BinCodeNode *node, unsigned int index, Token arg, enum addr_method method, FixupList *fixups, Arena *arena){
+    int i = 0;
+    Fixup *fixup;
 
-        node->code = word;
+    if (method == IMMEDIATE){
+        node->code = decimal_to_word(token_to_int(skip_chars(arg, 1))); /* encode the scalar, skip the # */
+        return 0; /* exit the function and indicate that everything went successfully */
+    } else if (method == IMD_REGISTER){
+        node->code = (Word)(1 << token_to_int(skip_chars(arg, 1))); /* set the appropriate bit to 1, marking the right register */
         return 0; /* exit the function and indicate that everything went successfully */
     }
 
     /* if the code arrived here, it is either a direct of a relative addressing method. In both cases, we should
-     * store only the name of the symbol, and in the second scan it will be replaced to the right binary code */
+     * record only the name of the symbol, and in the second scan the word will be encoded with the right value */
+    fixup = add_fixup(fixups);
+    RETURN_IF_MEMORY_ALLOC_ERROR(fixup, 1)
 
-    /* allocate memory for the name of the symbol  */
-    node->code = (char *)malloc(sizeof(char) * (MAX_SYMBOL_LENGTH + 1));
+    fixup->index = index;
+    fixup->line = node->L;
 
-    /* check if memory allocation completed successfully */
-    RETURN_IF_MEMORY_ALLOC_ERROR(node->code, 1)
+    if (method == RELATIVE){
+        fixup->isRelative = true;
+        arg = skip_chars(arg, 1); /* skip the % */
+    }
 
-    /* copy the name of the symbol into the node, without possible spaces */
-    while (!isspace(arg[i]) && arg[i] != '\0'){
-        node->code[i] = arg[i];
+    /* find the end of the name of the symbol, without possible spaces. The whole name is kept - a name too long for a
+     * symbol is not found in the second scan, rather than found by its beginning */
+    while (i < arg.length && !isspace(arg.start[i])){
         i++;
     }
-    node->code[i] = '\0'; /* mark the end of the string */
+
+    /* copy the name of the symbol into the reference, and check if memory allocation completed successfully */
+    fixup->symbol = arena_copy_string(arena, arg.start, i);
+    RETURN_IF_MEMORY_ALLOC_ERROR(fixup->symbol, 1)
 
     /* if the addressing method is direct, its ARE property should be R or E. The second scan will update it to E if needed */
     if (method == DIRECT){
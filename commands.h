@@ -12,18 +12,57 @@ struct Command{
 
 typedef struct Command Command;
 
-/* Input: receives a Table to which the commands should be added.
- * Output: returns 0 if all went successfully, 1 otherwise. Fills the table with the different commands and their properties.
+/* the amount of commands in the instruction set */
+#define NUM_OF_COMMANDS 16
+
+/* the indexes of the directives among the keywords, which follow the commands */
+#define DATA_DIRECTIVE NUM_OF_COMMANDS
+#define STRING_DIRECTIVE (NUM_OF_COMMANDS + 1)
+#define ENTRY_DIRECTIVE (NUM_OF_COMMANDS + 2)
+#define EXTERN_DIRECTIVE (NUM_OF_COMMANDS + 3)
+
+/* the amount of slots of the perfect hash of the keywords - must be a power of 2 */
+#define KEYWORD_SLOTS 32
+
+/* the lengths of the shortest and longest keywords */
+#define MIN_KEYWORD_LENGTH 3
+#define MAX_KEYWORD_LENGTH 6
+
+/* Input: a token.
+ * Output: returns the index of the keyword the token is - the opcode order of a command, followed by the directives -
+ * or -1 if it isn't a keyword.
+ *
+ * This function recognizes the names of the commands and the directives (without the dot) using a static perfect
+ * hash, with no allocations and a single comparison.
+ */
+int find_keyword(Token word);
+
+/* Input: a token.
+ * Output: returns the command named by the token, or NULL if there is no such command.
+ *
+ * This function returns the properties of the received command out of the static instruction set, which is never
+ * written to and is safe to read from any thread.
+ */
+const Command *find_command(Token name);
+
+/* Input: the operation code and the funct of a command word.
+ * Output: returns the index of the command - its opcode order, as find_keyword returns it - or -1 if there is no such
+ * command.
  *
- * This function receives a table and fills it with the different commands and their properties. Returns 1 in case of
- * failure, 0 otherwise.
+ * This function recognizes the command encoded in a word, for the tools that read the images back.
+ */
+int find_command_by_code(unsigned int opcode, unsigned int funct);
+
+/* Input: the index of a command, as returned by find_keyword or find_command_by_code.
+ * Output: returns the properties of the command.
  */
-int fill_table(Table *table);
+const Command *get_command(int index);
 
-/* Input: a binary code node, the argument as a string, and its addressing method. Assumption: the argument is valid.
+/* Input: a binary code node, its index in the code image, the argument as a token, its addressing method, the fix-up
+ * table and the arena of the file. Assumption: the argument is valid.
  * Output: constructs the node to match the argument. Returns 0 if no errors occurred, 1 otherwise.
  *
- * This function encodes the received argument and fills it to the node, and returns 0 if no errors occurred.
- * Else, 1 is returned.
+ * This function encodes the received argument and fills it to the node, or records it in the fix-up table if it refers
+ * to a symbol - with the name of the symbol allocated out of the arena. Returns 0 if no errors occurred. Else, 1 is returned.
  */
-int constructArg(BinCodeNode *node, char *arg, enum addr_method method);
\ No newline at end of file
+int constructArg(BinCodeNode *node, unsigned int index, Token arg, enum addr_method method, FixupList *fixups, Arena *arena);
\ No newline at end of file
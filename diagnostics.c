@@ -0,0 +1,357 @@
+#include "diagnostics.h"
+#include "assemblyStats.h"
+#include "generals.h"
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+/* the longest message, once its argument - at most a line - is written into it */
+#define MAX_MESSAGE_LENGTH (192 + MAX_LINE_LENGTH)
+
+/* the amount of numbers that open a saved diagnostic - its code, line, column and the length of its argument */
+#define SAVED_FIELDS 4
+
+/* the amount of diagnostics allocated for a list on its first diagnostic */
+#define DIAGNOSTICS_INITIAL_CAPACITY 16
+
+/* to write the value of a define into a message */
+#define STRINGIFY(x) #x
+#define TO_STRING(x) STRINGIFY(x)
+
+/* the ways a message is laid out in the text format, around its line number */
+enum message_layout {
+    ERROR_LAYOUT, /* "Error in line N: message" */
+    EXTERN_ERROR_LAYOUT, /* "Error in line: N: message" */
+    WARNING_LAYOUT, /* "line N - Warning: message" */
+    PLAIN_LAYOUT, /* "message", without the line */
+    LINE_SUFFIX_LAYOUT /* "message, line N" */
+};
+
+/* the text and properties of a code of a diagnostic */
+struct DiagnosticKind{
+    char *name; /* the name of the code in the JSON format */
+    enum diagnostic_severity severity;
+    enum message_layout layout;
+    char *message; /* the message, in which %s is replaced with the argument */
+};
+
+/* the kinds of the diagnostics, in the order of their codes */
+static const struct DiagnosticKind kinds[] = {
+    {"out_of_memory", DIAGNOSTIC_ERROR, PLAIN_LAYOUT, "Memory allocation error. Terminating!"},
+    {"argument_out_of_memory", DIAGNOSTIC_ERROR, LINE_SUFFIX_LAYOUT, "Memory allocation error during compilation"},
+    {"symbol_table_error", DIAGNOSTIC_ERROR, PLAIN_LAYOUT, "Error while adding symbol to table."},
+    {"messages_lost", DIAGNOSTIC_ERROR, PLAIN_LAYOUT, "Memory allocation error. %s messages were lost!"},
+    {"no_space_after_label", DIAGNOSTIC_ERROR, ERROR_LAYOUT, "no space after label name!"},
+    {"illegal_symbol", DIAGNOSTIC_ERROR, ERROR_LAYOUT, "Illegal symbol name! %s"},
+    {"symbol_rules", DIAGNOSTIC_NOTE, PLAIN_LAYOUT, "A legal symbol is at most " TO_STRING(MAX_SYMBOL_LENGTH)
+        " chars length, begins with a letter, not a command nor register or keyword, and contains letters and digits only."},
+    {"empty_label", DIAGNOSTIC_ERROR, ERROR_LAYOUT, "an empty label was defined! %s"},
+    {"symbol_redefined", DIAGNOSTIC_ERROR, ERROR_LAYOUT, "Redefining a symbol %s"},
+    {"empty_string", DIAGNOSTIC_ERROR, ERROR_LAYOUT, "empty .string is declared!"},
+    {"empty_data", DIAGNOSTIC_ERROR, ERROR_LAYOUT, "empty .data is declared!"},
+    {"illegal_scalar", DIAGNOSTIC_ERROR, ERROR_LAYOUT, "Illegal scalar in .data, or no comma between arguments! %s"},
+    {"data_ends_with_comma", DIAGNOSTIC_ERROR, ERROR_LAYOUT, ".data cannot end with a comma!"},
+    {"label_before_entry", DIAGNOSTIC_WARNING, WARNING_LAYOUT, "Symbol definition before .entry"},
+    {"label_before_extern", DIAGNOSTIC_WARNING, WARNING_LAYOUT, "Symbol definition before .extern"},
+    {"illegal_extern", DIAGNOSTIC_ERROR, EXTERN_ERROR_LAYOUT, "problematic external symbol %s"},
+    {"extern_redeclared", DIAGNOSTIC_ERROR, EXTERN_ERROR_LAYOUT, "multiple declarations of external symbol %s"},
+    {"invalid_command", DIAGNOSTIC_ERROR, ERROR_LAYOUT, "Invalid command! %s"},
+    {"missing_comma", DIAGNOSTIC_ERROR, ERROR_LAYOUT, "no comma between arguments!"},
+    {"missing_argument", DIAGNOSTIC_ERROR, ERROR_LAYOUT, "missing argument!"},
+    {"invalid_addressing", DIAGNOSTIC_ERROR, ERROR_LAYOUT, "invalid addressing method!"},
+    {"illegal_argument", DIAGNOSTIC_ERROR, ERROR_LAYOUT, "illegal argument! %s"},
+    {"extra_text", DIAGNOSTIC_ERROR, ERROR_LAYOUT, "unrecognized extra text!"},
+    {"undefined_entry", DIAGNOSTIC_ERROR, ERROR_LAYOUT, "No such symbol was defined - %s"},
+    {"entry_is_extern", DIAGNOSTIC_ERROR, ERROR_LAYOUT, "a symbol cannot be both .entry and .extern"},
+    {"undefined_symbol", DIAGNOSTIC_ERROR, ERROR_LAYOUT, "No such symbol was defined - %s"},
+    {"symbol_without_value", DIAGNOSTIC_ERROR, ERROR_LAYOUT, "undefined symbol!"},
+    {"relative_extern", DIAGNOSTIC_ERROR, ERROR_LAYOUT, "Relative addressing cannot be applied on an external symbol!"},
+    {"relative_data", DIAGNOSTIC_ERROR, ERROR_LAYOUT, "Relative addressing cannot be applied on a .data symbol!"},
+    {"illegal_macro", DIAGNOSTIC_ERROR, ERROR_LAYOUT, "Illegal macro name! %s"},
+    {"macro_redefined", DIAGNOSTIC_ERROR, ERROR_LAYOUT, "Redefining a macro %s"},
+    {"nested_macro", DIAGNOSTIC_ERROR, ERROR_LAYOUT, "a macro cannot be defined inside another macro!"},
+    {"macro_not_closed", DIAGNOSTIC_ERROR, ERROR_LAYOUT, "the macro %s has no endmcr!"},
+    {"macro_end_without_start", DIAGNOSTIC_ERROR, ERROR_LAYOUT, "endmcr without a macro definition!"},
+    {"too_many_errors", DIAGNOSTIC_NOTE, PLAIN_LAYOUT, "Too many errors - the rest of the file was not checked."}
+};
+
+/* the names of the severities in the JSON format */
+static char *severity_names[] = {"error", "warning", "note"};
+
+/* Input: the diagnostics to initialize, the limit of the errors and the arena to copy the arguments to.
+ * Output: returns nothing.
+ */
+void init_diagnostics(Diagnostics *diagnostics, unsigned int max_errors, Arena *arena){
+    memset(diagnostics, 0, sizeof(Diagnostics));
+    diagnostics->max_errors = max_errors;
+    diagnostics->arena = arena;
+}
+
+/* Input: the diagnostics, the code of the message, its line and column, and its argument and the length of the
+ * argument.
+ * Output: returns nothing.
+ *
+ * Algorithm: count an error. If the list is full, double the amount of diagnostics allocated for it (or allocate the
+ * initial capacity for an empty list). Copy the argument out of the arena - at most a line of it, which is
+ * all a message has room for - and fill the next free diagnostic. If an allocation failed, count the diagnostic as
+ * lost instead.
+ */
+void report(Diagnostics *diagnostics, enum diagnostic_code code, unsigned int line, unsigned int column,
+            char *argument, int length){
+    Diagnostic *diagnostic;
+
+    diagnostics->errors += (kinds[code].severity == DIAGNOSTIC_ERROR);
+
+    if (diagnostics->size == diagnostics->capacity){ /* ensure there is room for another diagnostic */
+        unsigned int capacity = (diagnostics->capacity == 0) ? DIAGNOSTICS_INITIAL_CAPACITY : diagnostics->capacity * 2;
+        Diagnostic *grown = (Diagnostic *)counted_realloc(diagnostics->diagnostics,
+                                                           sizeof(Diagnostic) * diagnostics->capacity,
+                                                           sizeof(Diagnostic) * capacity);
+
+        if (grown == NULL){
+            diagnostics->lost++;
+            return;
+        }
+
+        diagnostics->diagnostics = grown;
+        diagnostics->capacity = capacity;
+    }
+
+    diagnostic = &diagnostics->diagnostics[diagnostics->size];
+    diagnostic->code = code;
+    diagnostic->severity = kinds[code].severity;
+    diagnostic->line = line;
+    diagnostic->column = column;
+    diagnostic->argument = NULL;
+
+    if (argument != NULL){
+        diagnostic->argument = arena_copy_string(diagnostics->arena, argument,
+                                                 (length < MAX_LINE_LENGTH) ? length : MAX_LINE_LENGTH);
+        if (diagnostic->argument == NULL){
+            diagnostics->lost++;
+            return;
+        }
+    }
+
+    diagnostics->size++;
+}
+
+/* Input: the diagnostics, and the line the scan is about to handle.
+ * Output: returns 1 if the limit of the errors was reached, 0 otherwise.
+ *
+ * Algorithm: the limit is reached once there are at least max_errors errors. The note is reported only when the limit
+ * is first reached - it is the last diagnostic from then on.
+ */
+int error_limit_reached(Diagnostics *diagnostics, unsigned int line){
+    if (diagnostics->max_errors == 0 || diagnostics->errors < diagnostics->max_errors){
+        return 0;
+    }
+
+    if (diagnostics->size == 0 || diagnostics->diagnostics[diagnostics->size - 1].code != DIAG_TOO_MANY_ERRORS){
+        report(diagnostics, DIAG_TOO_MANY_ERRORS, line, 0, NULL, 0);
+    }
+
+    return 1;
+}
+
+/* Input: a diagnostic, the name of the source (NULL for none), the format and the stream to write to.
+ * Output: returns nothing.
+ *
+ * Algorithm: write the argument into the message of the code. For the text format, lay the line number out around
+ * the message as its code does. For the JSON format, write the name of the source, the properties of the diagnostic
+ * and the message as the members of a single object, in one line - the argument only if there is.
+ */
+static void print_diagnostic_of(Diagnostic *diagnostic, char *filename, enum diagnostics_format format, FILE *out){
+    const struct DiagnosticKind *kind = &kinds[diagnostic->code];
+    char message[MAX_MESSAGE_LENGTH];
+
+    sprintf(message, kind->message, (diagnostic->argument != NULL) ? diagnostic->argument : "");
+
+    if (format == JSON_DIAGNOSTICS){
+        fputc('{', out);
+        if (filename != NULL){
+            fprintf(out, "\"file\": ");
+            print_json_string(filename, out);
+            fprintf(out, ", ");
+        }
+        fprintf(out, "\"severity\": \"%s\", \"code\": \"%s\", \"line\": %u, \"column\": %u, ",
+                severity_names[diagnostic->severity], kind->name, diagnostic->line, diagnostic->column);
+        if (diagnostic->argument != NULL){
+            fprintf(out, "\"argument\": ");
+            print_json_string(diagnostic->argument, out);
+            fprintf(out, ", ");
+        }
+        fprintf(out, "\"message\": ");
+        print_json_string(message, out);
+        fprintf(out, "}\n");
+        return;
+    }
+
+    switch (kind->layout){
+        case ERROR_LAYOUT:
+            fprintf(out, "Error in line %u: %s\n", diagnostic->line, message);
+            break;
+        case EXTERN_ERROR_LAYOUT:
+            fprintf(out, "Error in line: %u: %s\n", diagnostic->line, message);
+            break;
+        case WARNING_LAYOUT:
+            fprintf(out, "line %u - Warning: %s\n", diagnostic->line, message);
+            break;
+        case LINE_SUFFIX_LAYOUT:
+            fprintf(out, "%s, line %u\n", message, diagnostic->line);
+            break;
+        default:
+            fprintf(out, "%s\n", message);
+    }
+}
+
+/* Input: a diagnostic, the format and the stream to write to.
+ * Output: returns nothing.
+ */
+void print_diagnostic(Diagnostic *diagnostic, enum diagnostics_format format, FILE *out){
+    print_diagnostic_of(diagnostic, NULL, format, out);
+}
+
+/* Input: the diagnostics, a diagnostic to fill and a buffer of a line for its argument.
+ * Output: returns the received diagnostic, or NULL if no diagnostics were lost.
+ *
+ * Algorithm: fill a diagnostic that says how many diagnostics were lost - its argument is written into the buffer of
+ * the caller, on the stack, since nothing more can be allocated.
+ */
+static Diagnostic *lost_diagnostic(Diagnostics *diagnostics, Diagnostic *lost, char *amount){
+    if (diagnostics->lost == 0){
+        return NULL;
+    }
+
+    sprintf(amount, "%u", diagnostics->lost);
+    lost->code = DIAG_MESSAGES_LOST;
+    lost->severity = kinds[DIAG_MESSAGES_LOST].severity;
+    lost->line = lost->column = 0;
+    lost->argument = amount;
+
+    return lost;
+}
+
+/* Input: the diagnostics, the name of the source, the format and the stream to write to.
+ * Output: returns nothing.
+ *
+ * Algorithm: print every diagnostic in order. If diagnostics were lost, end with a diagnostic that says how many.
+ */
+void print_diagnostics(Diagnostics *diagnostics, char *filename, enum diagnostics_format format, FILE *out){
+    Diagnostic lost;
+    char amount[MAX_LINE_LENGTH];
+    unsigned int i;
+
+    for (i = 0; i < diagnostics->size; i++){
+        print_diagnostic_of(&diagnostics->diagnostics[i], filename, format, out);
+    }
+
+    if (lost_diagnostic(diagnostics, &lost, amount) != NULL){
+        print_diagnostic_of(&lost, filename, format, out);
+    }
+}
+
+/* Input: a diagnostic and the stream to write to.
+ * Output: returns nothing.
+ *
+ * Algorithm: write the code, the line, the column and the length of the argument plus 1 (0 for no argument), each
+ * followed by a space, then the argument and a '\n'. The argument is written as is - it may hold any char.
+ */
+static void save_diagnostic(Diagnostic *diagnostic, FILE *out){
+    size_t length = (diagnostic->argument != NULL) ? strlen(diagnostic->argument) : 0;
+
+    fprintf(out, "%u %u %u %lu ", (unsigned int)diagnostic->code, diagnostic->line, diagnostic->column,
+            (diagnostic->argument != NULL) ? (unsigned long)length + 1 : 0UL);
+    fwrite((diagnostic->argument != NULL) ? diagnostic->argument : "", 1, length, out);
+    fputc('\n', out);
+}
+
+/* Input: the diagnostics and the stream to write to.
+ * Output: returns nothing.
+ *
+ * Algorithm: save every diagnostic in order, followed by the diagnostic that says how many were lost, if any - just
+ * as print_diagnostics prints them.
+ */
+void save_diagnostics(Diagnostics *diagnostics, FILE *out){
+    Diagnostic lost;
+    char amount[MAX_LINE_LENGTH];
+    unsigned int i;
+
+    for (i = 0; i < diagnostics->size; i++){
+        save_diagnostic(&diagnostics->diagnostics[i], out);
+    }
+
+    if (lost_diagnostic(diagnostics, &lost, amount) != NULL){
+        save_diagnostic(&lost, out);
+    }
+}
+
+/* Input: the next char of saved diagnostics, their end, and the number to read.
+ * Output: returns the char after the space that follows the number, or NULL if there is no valid number.
+ */
+static char *read_saved_number(char *p, char *end, unsigned long *number){
+    char *start = p;
+
+    for (*number = 0; p < end && *p >= '0' && *p <= '9'; p++){
+        if (*number > UINT_MAX / 10){
+            return NULL;
+        }
+        *number = *number * 10 + (*p - '0');
+    }
+
+    return (p != start && p < end && *p == ' ' && *number <= UINT_MAX) ? p + 1 : NULL;
+}
+
+/* Input: diagnostics saved by save_diagnostics and their length, the name of the source, the format and the stream to
+ * write to (NULL to only check the records).
+ * Output: returns 0 if the records are valid, 1 otherwise.
+ *
+ * Algorithm: read the numbers of every record, and ensure the code exists and the argument - at most a line, as
+ * report keeps it - is followed by the '\n' of the record. Copy the argument to be terminated, and print the
+ * diagnostic with the properties of its code.
+ */
+int print_saved_diagnostics(char *saved, size_t length, char *filename, enum diagnostics_format format, FILE *out){
+    char *p = saved, *end = saved + length, argument[MAX_LINE_LENGTH + 1];
+    unsigned long numbers[SAVED_FIELDS], argument_length;
+    Diagnostic diagnostic;
+    int i;
+
+    while (p < end){
+        for (i = 0; i < SAVED_FIELDS && p != NULL; i++){
+            p = read_saved_number(p, end, &numbers[i]);
+        }
+
+        if (p == NULL || numbers[0] > DIAG_TOO_MANY_ERRORS || numbers[3] > MAX_LINE_LENGTH + 1){
+            return 1;
+        }
+
+        argument_length = (numbers[3] > 0) ? numbers[3] - 1 : 0;
+        if ((size_t)(end - p) <= argument_length || p[argument_length] != '\n'){
+            return 1;
+        }
+
+        memcpy(argument, p, argument_length);
+        argument[argument_length] = '\0';
+        p += argument_length + 1;
+
+        if (out != NULL){
+            diagnostic.code = (enum diagnostic_code)numbers[0];
+            diagnostic.severity = kinds[diagnostic.code].severity;
+            diagnostic.line = numbers[1];
+            diagnostic.column = numbers[2];
+            diagnostic.argument = (numbers[3] > 0) ? argument : NULL;
+            print_diagnostic_of(&diagnostic, filename, format, out);
+        }
+    }
+
+    return 0;
+}
+
+/* Input: the diagnostics.
+ * Output: returns nothing.
+ */
+void free_diagnostics(Diagnostics *diagnostics){
+    free(diagnostics->diagnostics);
+    diagnostics->diagnostics = NULL;
+    diagnostics->size = diagnostics->capacity = diagnostics->errors = diagnostics->lost = 0;
+}
@@ -0,0 +1,112 @@
+#ifndef DIAGNOSTICS_H
+#define DIAGNOSTICS_H
+
+#include <stdio.h>
+#include "arena.h"
+
+/* the messages the assembler reports about a source. The text of every message is in the table of diagnostics.c */
+enum diagnostic_code {
+    DIAG_OUT_OF_MEMORY, DIAG_ARGUMENT_OUT_OF_MEMORY, DIAG_SYMBOL_TABLE_ERROR, DIAG_MESSAGES_LOST,
+    DIAG_NO_SPACE_AFTER_LABEL, DIAG_ILLEGAL_SYMBOL, DIAG_SYMBOL_RULES, DIAG_EMPTY_LABEL, DIAG_SYMBOL_REDEFINED,
+    DIAG_EMPTY_STRING, DIAG_EMPTY_DATA, DIAG_ILLEGAL_SCALAR, DIAG_DATA_ENDS_WITH_COMMA,
+    DIAG_LABEL_BEFORE_ENTRY, DIAG_LABEL_BEFORE_EXTERN, DIAG_ILLEGAL_EXTERN, DIAG_EXTERN_REDECLARED,
+    DIAG_INVALID_COMMAND, DIAG_MISSING_COMMA, DIAG_MISSING_ARGUMENT, DIAG_INVALID_ADDRESSING, DIAG_ILLEGAL_ARGUMENT,
+    DIAG_EXTRA_TEXT, DIAG_UNDEFINED_ENTRY, DIAG_ENTRY_IS_EXTERN, DIAG_UNDEFINED_SYMBOL, DIAG_SYMBOL_WITHOUT_VALUE,
+    DIAG_RELATIVE_EXTERN, DIAG_RELATIVE_DATA, DIAG_ILLEGAL_MACRO, DIAG_MACRO_REDEFINED, DIAG_NESTED_MACRO,
+    DIAG_MACRO_NOT_CLOSED, DIAG_MACRO_END_WITHOUT_START, DIAG_TOO_MANY_ERRORS
+};
+
+/* the severity of a diagnostic. Only errors count towards the limit */
+enum diagnostic_severity {DIAGNOSTIC_ERROR, DIAGNOSTIC_WARNING, DIAGNOSTIC_NOTE};
+
+/* the formats the diagnostics are printed in: the lines the assembler always printed, or a JSON object per line */
+enum diagnostics_format {TEXT_DIAGNOSTICS, JSON_DIAGNOSTICS};
+
+/* a message about a source, kept until the source was assembled */
+struct Diagnostic{
+    enum diagnostic_code code;
+    enum diagnostic_severity severity;
+    unsigned int line; /* the line of the source the message is about */
+    unsigned int column; /* the column the message is about, starting from 1. 0 if it is about the whole line */
+    char *argument; /* the token or symbol the message is about, or NULL */
+};
+
+typedef struct Diagnostic Diagnostic;
+
+/* the diagnostics of a source - a growable array, in the order they were reported - and the limit of the errors */
+struct Diagnostics{
+    Diagnostic *diagnostics;
+    unsigned int size; /* the amount of diagnostics */
+    unsigned int capacity; /* the amount of diagnostics allocated */
+    unsigned int errors; /* the amount of diagnostics that are errors */
+    unsigned int max_errors; /* the amount of errors after which the scan is stopped, 0 for no limit */
+    unsigned int lost; /* the amount of diagnostics that could not be kept, since memory allocation failed */
+    Arena *arena; /* the arena the arguments are copied to */
+};
+
+typedef struct Diagnostics Diagnostics;
+
+/* Input: the diagnostics to initialize, the limit of the errors (0 for none) and the arena to copy the arguments to.
+ * Output: returns nothing.
+ *
+ * This function prepares an empty list of diagnostics. Nothing is allocated until the first diagnostic is reported.
+ */
+void init_diagnostics(Diagnostics *diagnostics, unsigned int max_errors, Arena *arena);
+
+/* Input: the diagnostics, the code of the message, its line and column, and its argument and the length of the
+ * argument (NULL and 0 for none).
+ * Output: returns nothing.
+ *
+ * This function adds a diagnostic at the end of the list, with a copy of the argument - which needs not be terminated.
+ * A diagnostic that cannot be kept, since memory allocation failed, is only counted: the list reports it once printed.
+ */
+void report(Diagnostics *diagnostics, enum diagnostic_code code, unsigned int line, unsigned int column,
+            char *argument, int length);
+
+/* Input: the diagnostics, and the line the scan is about to handle.
+ * Output: returns 1 if the limit of the errors was reached, 0 otherwise.
+ *
+ * This function checks whether the scan should stop. The first time it should, a note saying so is reported.
+ */
+int error_limit_reached(Diagnostics *diagnostics, unsigned int line);
+
+/* Input: a diagnostic, the format and the stream to write to.
+ * Output: returns nothing.
+ *
+ * This function prints the received diagnostic - as a line of text, exactly as the assembler always printed it, or as
+ * a JSON object in a single line.
+ */
+void print_diagnostic(Diagnostic *diagnostic, enum diagnostics_format format, FILE *out);
+
+/* Input: the diagnostics, the name of the source, the format and the stream to write to.
+ * Output: returns nothing.
+ *
+ * This function prints all the diagnostics, in order. In the JSON format, every object names the source as well.
+ */
+void print_diagnostics(Diagnostics *diagnostics, char *filename, enum diagnostics_format format, FILE *out);
+
+/* Input: the diagnostics and the stream to write to.
+ * Output: returns nothing.
+ *
+ * This function saves the diagnostics as records of their codes, lines, columns and arguments - without the name of
+ * the source or a format - so print_saved_diagnostics can print them again for any source, in any format.
+ */
+void save_diagnostics(Diagnostics *diagnostics, FILE *out);
+
+/* Input: diagnostics saved by save_diagnostics and their length, the name of the source, the format and the stream to
+ * write to (NULL to only check the records).
+ * Output: returns 0 if the records are valid, 1 otherwise.
+ *
+ * This function prints the saved diagnostics exactly as print_diagnostics printed the diagnostics they were saved from.
+ * The records need not be terminated.
+ */
+int print_saved_diagnostics(char *saved, size_t length, char *filename, enum diagnostics_format format, FILE *out);
+
+/* Input: the diagnostics.
+ * Output: returns nothing.
+ *
+ * This function frees the list of diagnostics - the arguments belong to the arena. The list is left empty.
+ */
+void free_diagnostics(Diagnostics *diagnostics);
+
+#endif
@@ -0,0 +1,690 @@
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "binaryObject.h"
+
+#define USAGE "Usage: disassembler file1 file2....\n"
+
+/* the suffix of the base filename of a listing - the listing of ps is ps.dis.as, which assembles to ps.dis.ob */
+#define LISTING_SUFFIX ".dis"
+
+/* the amount of different values an address takes in a word - the words refer to addresses modulo it */
+#define WORD_ADDRESSES (1 << WORD_SIZE)
+
+/* the amount of command words: the operation code and the funct, which are the leftmost bits of a command word */
+#define COMMAND_CODES (1 << (OPCODE_LENGTH + FUNCT_LENGTH))
+
+/* the most values in a .data line, and the most chars in a .string line - so every line is shorter than a line of
+ * the assembler, even with the longest label */
+#define MAX_DATA_VALUES 5
+#define MAX_STRING_LENGTH 36
+
+/* the size of the buffer of a listing file */
+#define LISTING_BUFFER_SIZE (1 << 16)
+
+/* the flags of an address a word refers to - an address modulo WORD_ADDRESSES */
+#define REFERENCED 1 /* a word refers to the address */
+#define DEFINED 2 /* a line that starts at the address has its label */
+#define CLAIMED 4 /* an entry starts at the address - its label is the name of the entry */
+
+/* a disassembler of the output files of the assembler: it reads the .ob file of every file, with its .ent and .ext files,
+ * and writes an assembly source that assembles back to exactly the same files - a listing, named after the file with
+ * LISTING_SUFFIX. The entries and externals keep their names; any other address a word refers to gets a label made of
+ * a prefix and the address.
+ *
+ * The .ob file is read in two streams: one reads the code once ahead, to find the addresses the code refers to, and
+ * then reads the data; the other decodes the code. Every command word is decoded by a table indexed by its operation
+ * code and funct, and every line of the listing is written as soon as it was decoded - so nothing but the .ent and .ext
+ * files is held in memory, no matter how large the .ob file is. The lines of code and data are interleaved, so the
+ * entries are defined in the order that gives back the .ent file - within a bucket of output_order_bucket, from the
+ * last entry of the file. The externals are declared from the last one of the .ext file, for the same reason. */
+
+/* the state of the listing of a file */
+struct Listing{
+    char *base_filename;
+    FILE *out; /* the listing file */
+    ObjectReader code; /* the stream of the code */
+    ObjectReader data; /* the stream that reads the code ahead, and then the data */
+    BinCodeNode next_data; /* the next word of the data, read ahead */
+    int has_next_data; /* marks whether next_data holds a word */
+    unsigned int code_start; /* the address of the first word of the code */
+    unsigned int data_start; /* the address of the first word of the data */
+    unsigned int code_address; /* the address of the next command to decode */
+    ObjectSymbol *entries; /* the entries, in the order of the .ent file */
+    unsigned int entries_size;
+    ObjectSymbol **sorted_entries; /* the entries by their addresses */
+    unsigned int code_entry, data_entry; /* the next entries of the code and of the data, in sorted_entries */
+    ObjectSymbol **defined_order; /* the entries, in the order their lines are written */
+    ObjectSymbol *externs; /* the usages of externals, in the order of the .ext file */
+    unsigned int externs_size;
+    ObjectSymbol *usages; /* the usages of externals, by their addresses */
+    unsigned int next_usage; /* the next usage, in usages */
+    unsigned int defined_entries; /* the amount of entries whose lines were written */
+    unsigned char flags[WORD_ADDRESSES]; /* REFERENCED, DEFINED and CLAIMED of every address */
+    char *names[WORD_ADDRESSES]; /* the name of the entry that claimed every address */
+    char prefix[MAX_SYMBOL_LENGTH]; /* the prefix of the labels of the addresses */
+    Word run[MAX_STRING_LENGTH]; /* the data words that were read, and not written yet */
+    unsigned int run_size;
+    int run_is_string; /* marks whether the words of the run may be a .string */
+    char run_label[MAX_SYMBOL_LENGTH]; /* the label of the first word of the run, or "" */
+    int errors;
+};
+
+/* the index of the command of every command word by its operation code and funct, or -1 */
+static signed char commands_by_code[COMMAND_CODES];
+
+/* Input: none.
+ * Output: returns nothing.
+ *
+ * This function fills the table of the commands by their codes, out of the instruction set.
+ */
+static void build_commands_table(void){
+    unsigned int code;
+
+    for (code = 0; code < COMMAND_CODES; code++){
+        commands_by_code[code] = (signed char)find_command_by_code(code >> FUNCT_LENGTH, code & ((1 << FUNCT_LENGTH) - 1));
+    }
+}
+
+/* Input: two symbols.
+ * Output: returns a negative number, 0 or a positive number, as the value of the first is lower, equal or higher.
+ */
+static int compare_symbols(const void *first, const void *second){
+    unsigned int a = ((const ObjectSymbol *)first)->value, b = ((const ObjectSymbol *)second)->value;
+
+    return (a > b) - (a < b);
+}
+
+/* Input: two pointers to symbols.
+ * Output: compares the symbols as compare_symbols does.
+ */
+static int compare_symbol_pointers(const void *first, const void *second){
+    return compare_symbols(*(ObjectSymbol * const *)first, *(ObjectSymbol * const *)second);
+}
+
+/* Input: the listing, an address and a buffer of MAX_SYMBOL_LENGTH chars.
+ * Output: returns the label of the address, written into the buffer unless it is the name of an entry.
+ */
+static char *label_of(struct Listing *listing, unsigned int address, char *buffer){
+    address &= WORD_MASK;
+
+    if (listing->flags[address] & CLAIMED){
+        return listing->names[address];
+    }
+
+    sprintf(buffer, "%s%u", listing->prefix, address);
+
+    return buffer;
+}
+
+/* Input: a name and a prefix.
+ * Output: returns 1 if the name is the prefix followed by digits only - a label of an address - 0 otherwise.
+ */
+static int is_address_label(char *name, char *prefix){
+    size_t length = strlen(prefix);
+
+    if (strncmp(name, prefix, length) != 0 || name[length] == '\0'){
+        return 0;
+    }
+
+    for (name += length; isdigit(*name); name++)
+        ;
+
+    return *name == '\0';
+}
+
+/* Input: the listing, an entry, the ranks of the entries and the amount of entries defined in every bucket.
+ * Output: returns 1 if the entry is the next one to define in its bucket, 0 otherwise.
+ */
+static int is_next_of_bucket(struct Listing *listing, ObjectSymbol *entry, unsigned int *ranks, unsigned int *counts){
+    return ranks[entry - listing->entries] == counts[output_order_bucket(entry->name)];
+}
+
+/* Input: the listing, and an arena. Assumption: the entries are sorted, and data_entry is the first one of the data.
+ * Output: returns 0 if succeeded, 1 if memory allocation failed.
+ *
+ * Algorithm: the .ent file lists the entries of every bucket from the last one defined, so an entry is defined only
+ * after the entries that follow it in its bucket. Rank every entry by the amount of entries that follow it in its
+ * bucket. Then merge the entries of the code and of the data, both by their addresses: the next entry of the code comes
+ * first, unless it is not the next one of its bucket and the next entry of the data is. If neither is - a .ent file
+ * the assembler did not write - the entry of the code comes first anyway.
+ */
+static int order_entries(struct Listing *listing, Arena *arena){
+    unsigned int *ranks = (unsigned int *)arena_alloc(arena, sizeof(unsigned int) * listing->entries_size + 1);
+    unsigned int counts[OUTPUT_ORDER_BUCKETS]; /* the amount of entries ranked, and then defined, in every bucket */
+    unsigned int i, code = 0, data = listing->data_entry;
+    ObjectSymbol *entry;
+    int take_data;
+
+    listing->defined_order = (ObjectSymbol **)arena_alloc(arena, sizeof(ObjectSymbol *) * listing->entries_size + 1);
+    RETURN_IF_MEMORY_ALLOC_ERROR(ranks, 1)
+    RETURN_IF_MEMORY_ALLOC_ERROR(listing->defined_order, 1)
+
+    memset(counts, 0, sizeof(counts));
+    for (i = listing->entries_size; i-- > 0;){
+        ranks[i] = counts[output_order_bucket(listing->entries[i].name)]++;
+    }
+
+    memset(counts, 0, sizeof(counts));
+    for (i = 0; i < listing->entries_size; i++){
+        take_data = code == listing->data_entry ||
+                    (data < listing->entries_size &&
+                     !is_next_of_bucket(listing, listing->sorted_entries[code], ranks, counts) &&
+                     is_next_of_bucket(listing, listing->sorted_entries[data], ranks, counts));
+
+        entry = take_data ? listing->sorted_entries[data++] : listing->sorted_entries[code++];
+        counts[output_order_bucket(entry->name)]++;
+        listing->defined_order[i] = entry;
+    }
+
+    return 0;
+}
+
+/* Input: the listing, and an arena.
+ * Output: returns 0 if succeeded, 1 if memory allocation failed.
+ *
+ * Algorithm: sort copies of the usages of externals and of the entries by their addresses, so both are found while the words are
+ * read in order. Every entry claims its address - the first entry at an address modulo WORD_ADDRESSES, if the addresses
+ * wrapped. Order the entries as their lines are written. Then, choose the prefix of the labels of the other
+ * addresses: 'L', repeated until no entry or external is the prefix followed by digits.
+ */
+static int prepare_symbols(struct Listing *listing, Arena *arena){
+    unsigned int i, address;
+    int collides = 1;
+
+    listing->usages = (ObjectSymbol *)arena_alloc(arena, sizeof(ObjectSymbol) * listing->externs_size + 1);
+    RETURN_IF_MEMORY_ALLOC_ERROR(listing->usages, 1)
+
+    memcpy(listing->usages, listing->externs, sizeof(ObjectSymbol) * listing->externs_size);
+    qsort(listing->usages, listing->externs_size, sizeof(ObjectSymbol), compare_symbols);
+
+    listing->sorted_entries = (ObjectSymbol **)arena_alloc(arena, sizeof(ObjectSymbol *) * listing->entries_size + 1);
+    RETURN_IF_MEMORY_ALLOC_ERROR(listing->sorted_entries, 1)
+
+    for (i = 0; i < listing->entries_size; i++){
+        listing->sorted_entries[i] = &listing->entries[i];
+    }
+    qsort(listing->sorted_entries, listing->entries_size, sizeof(ObjectSymbol *), compare_symbol_pointers);
+
+    for (i = 0; i < listing->entries_size; i++){
+        address = listing->sorted_entries[i]->value & WORD_MASK;
+        if (!(listing->flags[address] & CLAIMED)){
+            listing->flags[address] |= CLAIMED;
+            listing->names[address] = listing->sorted_entries[i]->name;
+        }
+    }
+
+    for (listing->data_entry = 0; listing->data_entry < listing->entries_size &&
+                                  listing->sorted_entries[listing->data_entry]->value < listing->data_start;
+         listing->data_entry++)
+        ;
+    if (order_entries(listing, arena) != 0){
+        return 1;
+    }
+
+    strcpy(listing->prefix, "L");
+    while (collides && strlen(listing->prefix) < MAX_SYMBOL_LENGTH - MAX_DECIMAL_DIGITS - 1){
+        collides = 0;
+        for (i = 0; i < listing->entries_size && !collides; i++){
+            collides = is_address_label(listing->entries[i].name, listing->prefix);
+        }
+        for (i = 0; i < listing->externs_size && !collides; i++){
+            collides = is_address_label(listing->externs[i].name, listing->prefix);
+        }
+        if (collides){
+            strcat(listing->prefix, "L");
+        }
+    }
+
+    return 0;
+}
+
+/* Input: a command word, and the addressing methods of its source and destination operands to set.
+ * Output: returns nothing.
+ */
+static void operand_methods(Word code, unsigned int *src_method, unsigned int *dst_method){
+    *src_method = WORD_FIELD(code, SRC_ADDR_METHOD_SHIFT, SRC_ADDR_METHOD_LENGTH);
+    *dst_method = WORD_FIELD(code, DST_ADDR_METHOD_SHIFT, DST_ADDR_METHOD_LENGTH);
+}
+
+/* Input: the listing.
+ * Output: returns the amount of errors.
+ *
+ * Algorithm: read the code through the stream of the data, which is left at the first word of the data. Decode every
+ * command word by the table, and mark the addresses its operands refer to: the address in a relocatable (R) word, and
+ * the address at the distance in a relative word from the word itself.
+ */
+static int find_references(struct Listing *listing){
+    BinCodeNode word;
+    const Command *command;
+    unsigned int i, j, src_method, dst_method, method;
+    int index;
+
+    for (i = 0; i < listing->data.code_size; i += 1 + command->num_of_args){
+        if (read_object_word(&listing->data, &word) != 1){
+            printf("Error in %s%s: invalid line %u\n", listing->base_filename, OBJ_EXTENSION, i + 2);
+            return 1;
+        }
+
+        index = commands_by_code[word.code >> FUNCT_SHIFT];
+        if (word.are != A || index < 0){
+            printf("Error in %s%s: %03X at address %u is not a command\n", listing->base_filename,
+                    OBJ_EXTENSION, word.code, word.IC);
+            return 1;
+        }
+
+        command = get_command(index);
+        operand_methods(word.code, &src_method, &dst_method);
+
+        for (j = 1; j <= command->num_of_args && i + j < listing->data.code_size; j++){
+            method = (j == command->num_of_args) ? dst_method : src_method;
+            if (read_object_word(&listing->data, &word) != 1){
+                printf("Error in %s%s: invalid line %u\n", listing->base_filename, OBJ_EXTENSION, i + j + 2);
+                return 1;
+            }
+
+            if (word.are == R){
+                listing->flags[word.code & WORD_MASK] |= REFERENCED;
+            } else if (method == RELATIVE){
+                listing->flags[(word.IC + SIGNED_WORD(word.code)) & WORD_MASK] |= REFERENCED;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/* Input: the listing, the address of a line, the cursor of the entries of its image, and a buffer of
+ * MAX_SYMBOL_LENGTH chars.
+ * Output: returns the label of the line, or NULL if it has none.
+ *
+ * Algorithm: a line at the address of an entry is labeled with its name. Otherwise, if a word refers to the address
+ * and no other line has its label, the line takes it.
+ */
+static char *label_of_line(struct Listing *listing, unsigned int address, unsigned int *entry, char *buffer){
+    unsigned int residue = address & WORD_MASK;
+
+    for (; *entry < listing->entries_size && listing->sorted_entries[*entry]->value < address; (*entry)++)
+        ;
+
+    if (*entry < listing->entries_size && listing->sorted_entries[*entry]->value == address){
+        listing->flags[residue] |= DEFINED;
+        listing->defined_entries++;
+        return listing->sorted_entries[(*entry)++]->name;
+    }
+
+    if ((listing->flags[residue] & (REFERENCED | DEFINED | CLAIMED)) == REFERENCED){
+        listing->flags[residue] |= DEFINED;
+        return label_of(listing, residue, buffer);
+    }
+
+    return NULL;
+}
+
+/* Input: the listing, and an operand word with its addressing method. Writes the operand to the end of the line.
+ * Output: returns 0 if the operand was written, 1 otherwise.
+ *
+ * Algorithm: an immediate operand is its value as a signed number, and a register operand is the register of its
+ * single bit. A direct operand is the name of the external used at its address, if it is external, and the label of
+ * the address in it otherwise. A relative operand is the label of the address at its distance from the word.
+ */
+static int write_operand(struct Listing *listing, BinCodeNode *word, unsigned int method, char *line){
+    char buffer[MAX_SYMBOL_LENGTH];
+    int reg;
+
+    line += strlen(line);
+
+    switch (method){
+        case IMMEDIATE:
+            sprintf(line, "#%d", SIGNED_WORD(word->code));
+            return 0;
+        case DIRECT:
+            if (word->are == E){
+                for (; listing->next_usage < listing->externs_size &&
+                       listing->usages[listing->next_usage].value < word->IC; listing->next_usage++)
+                    ;
+
+                if (listing->next_usage == listing->externs_size ||
+                    listing->usages[listing->next_usage].value != word->IC){
+                    printf("Error in %s: the external word at address %u has no usage in the %s file\n",
+                            listing->base_filename, word->IC, EXT_EXTENSION);
+                    return 1;
+                }
+                strcpy(line, listing->usages[listing->next_usage].name);
+            } else if (word->are == R){
+                strcpy(line, label_of(listing, word->code, buffer));
+            } else{
+                printf("Error in %s: the direct word at address %u is not relocatable\n",
+                        listing->base_filename, word->IC);
+                return 1;
+            }
+            return 0;
+        case RELATIVE:
+            sprintf(line, "%%%s", label_of(listing, word->IC + SIGNED_WORD(word->code), buffer));
+            return 0;
+        default:
+            for (reg = 0; reg < NUM_OF_REGISTERS && word->code != (1 << reg); reg++)
+                ;
+
+            if (reg == NUM_OF_REGISTERS){
+                printf("Error in %s: invalid register word %03X at address %u\n", listing->base_filename,
+                        word->code, word->IC);
+                return 1;
+            }
+            sprintf(line, "r%d", reg);
+            return 0;
+    }
+}
+
+/* Input: the listing, its label (or NULL), and the rest of the line.
+ * Output: returns nothing. Writes the line to the listing - unless it is too long for the assembler.
+ */
+static void write_line(struct Listing *listing, char *label, char *rest){
+    if ((label != NULL ? strlen(label) + 1 : 0) + strlen(rest) + 1 > MAX_LINE_LENGTH - 2){
+        printf("Error in %s: the line of %s is too long\n", listing->base_filename,
+                (label != NULL) ? label : rest);
+        listing->errors++;
+        return;
+    }
+
+    if (label != NULL){
+        fputs(label, listing->out);
+        putc(':', listing->out);
+    }
+    putc('\t', listing->out);
+    fputs(rest, listing->out);
+    putc('\n', listing->out);
+}
+
+/* Input: the listing.
+ * Output: returns nothing.
+ *
+ * Algorithm: write the run of data words: as a .string if it is one - the run ended with a '\0' that is not a part of
+ * it - and as .data lines of up to MAX_DATA_VALUES values otherwise. Only the first line has the label of the run.
+ */
+static void flush_run(struct Listing *listing, int is_string){
+    char line[MAX_LINE_LENGTH * 2], *end;
+    char *label = (listing->run_label[0] != '\0') ? listing->run_label : NULL;
+    unsigned int i, j;
+
+    if (is_string){
+        /* two spaces before the quote: the first scan finds it after a single space only if the line has a label */
+        end = line + sprintf(line, ".string  \"");
+        for (i = 0; i < listing->run_size; i++){
+            *end++ = (char)listing->run[i];
+        }
+        strcpy(end, "\"");
+        write_line(listing, label, line);
+    } else{
+        for (i = 0; i < listing->run_size; i = j, label = NULL){
+            end = line + sprintf(line, ".data ");
+            for (j = i; j < listing->run_size && j < i + MAX_DATA_VALUES; j++){
+                end += sprintf(end, (j == i) ? "%d" : ", %d", SIGNED_WORD(listing->run[j]));
+            }
+            write_line(listing, label, line);
+        }
+    }
+
+    listing->run_size = 0;
+    listing->run_label[0] = '\0';
+}
+
+/* Input: the listing, and the address to stop at.
+ * Output: returns 0 if succeeded, 1 otherwise.
+ *
+ * Algorithm: write the run of the data, if code follows it. Decode the commands whose addresses are lower than the
+ * received address, and write a line for each: find its command by the table, and write the name and the operands of
+ * the command - the source first.
+ */
+static int write_code_until(struct Listing *listing, unsigned int stop){
+    char line[MAX_LINE_LENGTH * 2], buffer[MAX_SYMBOL_LENGTH], *label;
+    unsigned int j, src_method, dst_method, end = listing->code_start + listing->code.code_size;
+    const Command *command;
+    BinCodeNode word;
+
+    if (listing->code_address < stop && listing->code_address < end && listing->run_size > 0){
+        flush_run(listing, 0); /* the data before the code */
+    }
+
+    while (listing->code_address < stop && listing->code_address < end){
+        if (read_object_word(&listing->code, &word) != 1){
+            return 1; /* the stream of the data has already read the whole code */
+        }
+
+        command = get_command(commands_by_code[word.code >> FUNCT_SHIFT]);
+        operand_methods(word.code, &src_method, &dst_method);
+        label = label_of_line(listing, word.IC, &listing->code_entry, buffer);
+
+        if (word.IC + 1 + command->num_of_args > end){
+            printf("Error in %s: the operands of %s at address %u are missing\n", listing->base_filename,
+                    command->name, word.IC);
+            return 1;
+        }
+
+        strcpy(line, command->name);
+        for (j = 1; j <= command->num_of_args; j++){
+            BinCodeNode operand;
+
+            read_object_word(&listing->code, &operand); /* the words of the code were already validated */
+            strcat(line, (j == 1) ? " " : ", ");
+            listing->errors += write_operand(listing, &operand, (j == command->num_of_args) ? dst_method : src_method,
+                                             line);
+        }
+
+        write_line(listing, label, line);
+        listing->code_address = word.IC + 1 + command->num_of_args;
+    }
+
+    return 0;
+}
+
+/* Input: the listing, and the address to stop at.
+ * Output: returns 0 if succeeded, 1 otherwise.
+ *
+ * Algorithm: add the data words whose addresses are up to the received address to the run. A word that needs a label
+ * starts a new run. A run of printable chars may become a .string, once a '\0' follows it - a char that is not
+ * printable, or a full run, writes it as .data; a printable char after other words starts a new run. Other runs are
+ * written whenever they have enough values for a line.
+ */
+static int write_data_until(struct Listing *listing, unsigned int stop){
+    char buffer[MAX_SYMBOL_LENGTH], *label;
+    Word code;
+    int printable;
+
+    while (listing->has_next_data && listing->next_data.IC <= stop){
+        code = listing->next_data.code;
+        label = label_of_line(listing, listing->next_data.IC, &listing->data_entry, buffer);
+        printable = code < 128 && isgraph(code) && code != '"';
+
+        if (label != NULL){
+            if (listing->run_size > 0){
+                flush_run(listing, 0);
+            }
+            strcpy(listing->run_label, label);
+        }
+
+        if (printable){
+            if ((!listing->run_is_string || listing->run_size == MAX_STRING_LENGTH) && listing->run_size > 0){
+                flush_run(listing, 0);
+            }
+            listing->run_is_string = 1;
+            listing->run[listing->run_size++] = code;
+        } else if (code == '\0' && listing->run_is_string && listing->run_size > 0){
+            flush_run(listing, 1);
+        } else{
+            if (listing->run_is_string && listing->run_size > 0){
+                flush_run(listing, 0);
+            }
+            listing->run_is_string = 0;
+            listing->run[listing->run_size++] = code;
+            if (listing->run_size == MAX_DATA_VALUES){
+                flush_run(listing, 0);
+            }
+        }
+
+        listing->has_next_data = read_object_word(&listing->data, &listing->next_data);
+        if (listing->has_next_data < 0){
+            printf("Error in %s%s: invalid line %u\n", listing->base_filename, OBJ_EXTENSION,
+                    listing->data.words + 2);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/* Input: the listing.
+ * Output: returns 0 if succeeded, 1 otherwise.
+ *
+ * Algorithm: declare the externals, from the last one of the .ext file, and the entries. Then write the lines so the
+ * entries are defined in the order of defined_order: for an entry of the code, the code up to its line. For an entry
+ * of the data, the code up to the next entry of the code (as much code as possible comes first), and then the data up
+ * to its line. The run of the data is written before any code that follows it. Write the rest of the code, and then
+ * the rest of the data. Finally, ensure every entry and every address a word refers to got its line.
+ */
+static int write_listing(struct Listing *listing, Table *declared){
+    unsigned int i, j, address;
+
+    for (i = listing->externs_size; i-- > 0;){ /* the .ext file lists the latest declaration first in a bucket */
+        if (lookup(listing->externs[i].name, declared) == NULL){
+            RETURN_IF_MEMORY_ALLOC_ERROR(install(listing->externs[i].name, listing, declared), 1)
+            fprintf(listing->out, ".extern %s\n", listing->externs[i].name);
+        }
+    }
+    for (i = 0; i < listing->entries_size; i++){
+        fprintf(listing->out, ".entry %s\n", listing->entries[i].name);
+    }
+
+    for (i = 0; i < listing->entries_size; i++){
+        for (j = i; j < listing->entries_size && listing->defined_order[j]->value >= listing->data_start; j++)
+            ; /* the next entry of the code */
+        address = (j < listing->entries_size) ? listing->defined_order[j]->value : listing->data_start;
+
+        if (write_code_until(listing, (j == i) ? address + 1 : address) != 0 ||
+            (j > i && write_data_until(listing, listing->defined_order[i]->value) != 0)){
+            return 1;
+        }
+    }
+
+    if (write_code_until(listing, listing->data_start) != 0 || write_data_until(listing, (unsigned int)-1) != 0){
+        return 1;
+    }
+    if (listing->run_size > 0){
+        flush_run(listing, 0);
+    }
+
+    if (listing->defined_entries < listing->entries_size){
+        printf("Error in %s: %u entries are not at the start of a command or data\n", listing->base_filename,
+                listing->entries_size - listing->defined_entries);
+        listing->errors++;
+    }
+
+    for (address = 0; address < WORD_ADDRESSES; address++){
+        if ((listing->flags[address] & (REFERENCED | DEFINED | CLAIMED)) == REFERENCED){
+            printf("Error in %s: address %u is referred to, but no line starts there\n",
+                    listing->base_filename, address);
+            listing->errors++;
+        }
+    }
+
+    return 0;
+}
+
+/* Input: the base filename, and an arena.
+ * Output: returns 0 if the listing was written, 1 otherwise.
+ *
+ * Algorithm: read the .ent and .ext files, and open both streams of the .ob file. Find the addresses the code refers
+ * to, read the first word of the data, and write the listing through a large buffer.
+ */
+static int disassemble(char *base_filename, Arena *arena){
+    struct Listing *listing = (struct Listing *)calloc(1, sizeof(struct Listing));
+    unsigned int flags = 0;
+    char *filename;
+    Table declared; /* the externals declared in the listing */
+    int errors = 1;
+
+    RETURN_IF_MEMORY_ALLOC_ERROR(listing, 1)
+    memset(&declared, 0, sizeof(Table));
+    declared.arena = arena;
+    listing->base_filename = base_filename;
+
+    filename = (char *)arena_alloc(arena, strlen(base_filename) + strlen(LISTING_SUFFIX INPUT_FILE_EXT) + 1);
+    if (filename == NULL ||
+        read_symbols_file(base_filename, ENT_EXTENSION, &listing->entries, &listing->entries_size, &flags,
+                          HAS_ENTRY_FILE, arena, stdout) != 0 ||
+        read_symbols_file(base_filename, EXT_EXTENSION, &listing->externs, &listing->externs_size, &flags,
+                          HAS_EXTERN_FILE, arena, stdout) != 0){
+        free(listing);
+        return 1;
+    }
+
+    if (open_object_reader(&listing->code, base_filename, stdout) != 0){
+        free(listing);
+        return 1;
+    }
+
+    if (open_object_reader(&listing->data, base_filename, stdout) == 0){
+        listing->code_start = listing->data_start = CODE_LOADING_ADDRESS;
+
+        if (find_references(listing) == 0){
+            listing->has_next_data = read_object_word(&listing->data, &listing->next_data);
+            if (listing->data.code_size > 0){
+                listing->code_start = listing->data.base;
+            } else if (listing->has_next_data == 1){
+                listing->code_start = listing->next_data.IC;
+            }
+            listing->data_start = listing->code_start + listing->data.code_size;
+            listing->code_address = listing->code_start;
+
+            sprintf(filename, "%s%s%s", base_filename, LISTING_SUFFIX, INPUT_FILE_EXT);
+            if (listing->has_next_data < 0){
+                printf("Error in %s%s: invalid line %u\n", base_filename, OBJ_EXTENSION,
+                        listing->data.words + 2);
+            } else if (prepare_symbols(listing, arena) != 0){
+                printf("Memory allocation failed. Terminating...\n");
+            } else if ((listing->out = fopen(filename, "w")) == NULL){
+                printf("Error creating file: %s\n", filename);
+            } else{
+                setvbuf(listing->out, NULL, _IOFBF, LISTING_BUFFER_SIZE);
+                errors = write_listing(listing, &declared) != 0 || listing->errors != 0;
+                errors |= (fclose(listing->out) != 0);
+            }
+        }
+
+        close_object_reader(&listing->data);
+    }
+
+    close_object_reader(&listing->code);
+    free_table(&declared);
+    free(listing);
+
+    return errors;
+}
+
+int main(int argc, char *argv[]) {
+
+    int errors = 0, i;
+    Arena arena = {NULL, NULL}; /* the names of the symbols, reused by all the files */
+
+    if (argc < 2){ /* check enough arguments were provided */
+        printf("Too few arguments!\n" USAGE); /* inform the user */
+        return MISSING_ARGS_ERROR;
+    }
+
+    build_commands_table();
+
+    for (i = 1; i < argc; i++){
+        if (disassemble(argv[i], &arena) != 0){
+            printf("Error disassembling file: %s\n", argv[i]);
+            errors = 1;
+        } else{
+            printf("Disassembled %s to %s%s%s\n", argv[i], argv[i], LISTING_SUFFIX, INPUT_FILE_EXT);
+        }
+        reset_arena(&arena);
+    }
+
+    free_arena(&arena);
+
+    return errors;
+}
@@ -0,0 +1,113 @@
+#!/bin/sh
+# Assembles the examples and compares the results with the expected files next to them:
+#   NAME_out                            - the messages printed for NAME.as, assembled alone
+#   NAME.ob, NAME.ent, NAME.ext, NAME.lst - the output files of NAME.as
+#   all_files_output                    - the messages printed for ps, ps1, scan1errs and scan2errs together
+#   summed_out                          - what the simulator prints, with -r, for sum.as linked with show.as
+# that a source restored from the build cache is reported under its own name, as if it was assembled, and that every
+# example that assembles - and a generated program - disassembles to a source that assembles back to the same files.
+# The binary object file (.obj) of every example is converted back to exactly the expected text files, and the text
+# files to exactly the same .obj. Every example assembled through libassembler.a prints the same messages and writes
+# the same files.
+# Usage: examples/check.sh [assembler] - run from the root of the repository, with ./assembler by default. The other
+# tools (disassembler, generateProgram, objectConverter, linker, simulator, libraryCheck) are taken from the directory
+# of the assembler.
+
+assembler=$(cd "$(dirname "${1:-./assembler}")" && pwd)/$(basename "${1:-./assembler}")
+tools=$(dirname "$assembler")
+examples=$(cd "$(dirname "$0")" && pwd)
+work=$(mktemp -d)
+failures=0
+
+trap 'rm -rf "$work"' EXIT
+
+# compares two files, and counts a failure if they differ
+same(){
+    if ! cmp -s "$1" "$2"; then
+        echo "FAIL: $2 differs from $1"
+        failures=$((failures + 1))
+    fi
+}
+
+# compares an expected file with the one made in the work directory
+expect(){
+    same "$examples/$1" "$work/$2"
+}
+
+cp "$examples"/*.as "$work"
+cd "$work" || exit 1
+
+for source in *.as; do
+    name=${source%.as}
+    "$assembler" --listing "$name" > "${name}_out"
+    [ -f "$examples/${name}_out" ] && expect "${name}_out" "${name}_out"
+    for extension in ob ent ext lst; do
+        [ -f "$examples/$name.$extension" ] && expect "$name.$extension" "$name.$extension"
+    done
+done
+
+"$assembler" ps ps1 scan1errs scan2errs > all_files_output
+expect all_files_output all_files_output
+
+# assemble_buffer reports the same diagnostics as the assembler, and returns the same words and symbols
+mkdir library
+for source in *.as; do
+    name=${source%.as}
+    cp "$source" library
+    (cd library && "$tools/libraryCheck" "$name" > "${name}_out")
+    [ -f "$examples/${name}_out" ] && expect "${name}_out" "library/${name}_out"
+    for extension in ob ent ext; do
+        [ -f "$examples/$name.$extension" ] && expect "$name.$extension" "library/$name.$extension"
+    done
+done
+
+# sum.as and show.as call each other - linked, the program prints its total and its registers
+"$tools/linker" -o summed sum show > /dev/null
+"$tools/simulator" -r summed > summed_out 2> /dev/null
+expect summed_out summed_out
+
+# the .obj file of every example with expected output files holds them all: converted back, in a directory of its own
+mkdir binary
+for expected in "$examples"/*.ob; do
+    name=$(basename "${expected%.ob}")
+    cp "$name.as" binary
+    (cd binary && "$assembler" --binary "$name" > /dev/null && mv "$name.obj" "$name.expected.obj" &&
+     rm -f "$name.ob" "$name.ent" "$name.ext" && cp "$name.expected.obj" "$name.obj" &&
+     "$tools/objectConverter" -t "$name" > /dev/null && "$tools/objectConverter" "$name" > /dev/null)
+    for extension in ob ent ext; do
+        [ -f "$examples/$name.$extension" ] && expect "$name.$extension" "binary/$name.$extension"
+    done
+    same "binary/$name.expected.obj" "binary/$name.obj"
+done
+
+# the disassembly of every file that was assembled, NAME.dis.as, assembles back to the same .ob, .ent and .ext files
+"$tools/generateProgram" 300 > generated.as
+"$assembler" generated > /dev/null
+for object in *.ob; do
+    name=${object%.ob}
+    "$tools/disassembler" "$name" > /dev/null
+    "$assembler" "$name.dis" > /dev/null
+    for extension in ob ent ext; do
+        if [ -f "$name.$extension" ] || [ -f "$name.dis.$extension" ]; then
+            same "$name.$extension" "$name.dis.$extension"
+        fi
+    done
+done
+
+# identical sources share an entry of the cache: the copy is restored from the entry made for warning.as, in JSON
+cp warning.as copy.as
+"$assembler" --cache cache --diagnostics=json warning > /dev/null
+for option in --diagnostics=json ""; do
+    "$assembler" $option copy > copy_expected
+    rm -f copy.ob copy.ent copy.ext
+    "$assembler" --cache cache $option copy > copy_out
+    same copy_expected copy_out
+    expect warning.ob copy.ob
+done
+
+if [ $failures -ne 0 ]; then
+    echo "$failures checks failed"
+    exit 1
+fi
+
+echo "all the examples passed"
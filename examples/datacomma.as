@@ -0,0 +1,3 @@
+MAIN:	prn #1
+LIST:	.data 6, -9,
+	stop
@@ -0,0 +1,76 @@
+/* a check of the in-process API of libassembler.a: assembles every file out of memory with assemble_buffer, prints its
+ * diagnostics just as the assembler prints them, and writes the object of the result as the text files - so both can
+ * be compared with the expected files of the examples.
+ * Usage: libraryCheck file1 file2 ... - the files are given without the .as extension, just like to the assembler. */
+#include "../assemblerLibrary.h"
+#include "../generals.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* the most chars of a source that are read */
+#define MAX_SOURCE_SIZE 1048576
+
+/* Input: the base filename of a source, and a buffer of MAX_SOURCE_SIZE chars.
+ * Output: returns 0 if the source was read, 1 otherwise. The messages and the files are compared by the caller.
+ *
+ * Algorithm: read the whole source into the buffer, and assemble it. Print the diagnostics in the text format, and
+ * write the object - only if the assembling succeeded - followed by the line the assembler ends the file with.
+ */
+static int check_file(char *base_filename, char *text){
+    char filename[MAX_FILENAME_LENGTH];
+    AssemblyResult result;
+    size_t size;
+    int failed;
+    FILE *fp;
+
+    if (strlen(base_filename) + strlen(INPUT_FILE_EXT) >= MAX_FILENAME_LENGTH){
+        printf("The filename is too long: %s\n", base_filename);
+        return 1;
+    }
+    sprintf(filename, "%s%s", base_filename, INPUT_FILE_EXT);
+
+    if ((fp = fopen(filename, "r")) == NULL){
+        printf("Cannot read %s\n", filename);
+        return 1;
+    }
+    size = fread(text, 1, MAX_SOURCE_SIZE, fp);
+    fclose(fp);
+
+    failed = assemble_buffer(text, size, 0, &result);
+    print_diagnostics(&result.diagnostics, filename, TEXT_DIAGNOSTICS, stdout);
+
+    if (!failed){
+        failed = write_text_object(&result.object, base_filename, stdout);
+    }
+
+    if (failed){
+        printf("Error compiling file: %s\n", filename);
+    } else{
+        printf("Compilation completed successfully for %s\n", filename);
+    }
+
+    free_assembly_result(&result);
+
+    return 0;
+}
+
+int main(int argc, char *argv[]){
+    char *text = (char *)malloc(MAX_SOURCE_SIZE);
+    int errors = 0, i;
+
+    if (argc < 2){
+        printf("Too few arguments!\nUsage: libraryCheck file1 file2....\n");
+        free(text);
+        return MISSING_ARGS_ERROR;
+    }
+    RETURN_IF_MEMORY_ALLOC_ERROR(text, MEMORY_ALLOC_ERROR)
+
+    for (i = 1; i < argc; i++){
+        errors |= check_file(argv[i], text);
+    }
+
+    free(text);
+
+    return errors;
+}
@@ -0,0 +1,3 @@
+AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA: add r1, r2
+jmp AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAXYZ
+stop
@@ -0,0 +1,19 @@
+; file macro.as - macros, listed with their definitions and calls
+
+.entry LOOP
+.extern OUT
+mcr count
+	inc r2
+	cmp r2, LIMIT
+endmcr
+MAIN:	mov #0, r2
+LOOP:	prn r2
+	count
+	bne %LOOP
+mcr leave
+	jsr OUT
+	stop
+endmcr
+	leave
+LIMIT:	.data 5
+MSG:	.string "done"
@@ -0,0 +1,6 @@
+; file show.as - prints the total of sum.as, and a constant
+.entry SHOW
+.extern TOTAL
+SHOW:	prn TOTAL
+	prn #-7
+	rts
@@ -0,0 +1,13 @@
+; file sum.as - sums 5 + 4 + 3 + 2 + 1, and prints the total with SHOW of show.as
+.entry TOTAL
+.extern SHOW
+MAIN:	mov #5, r3
+	clr r2
+LOOP:	add r3, r2
+	dec r3
+	cmp #0, r3
+	bne %LOOP
+	mov r2, TOTAL
+	jsr SHOW
+	stop
+TOTAL:	.data 0
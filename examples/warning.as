@@ -0,0 +1,8 @@
+; file warning.as - a label before .entry or .extern is only a warning
+
+.extern W
+MAIN:	add r3, LIST
+	jsr W
+NOTE:	.entry MAIN
+END:	stop
+LIST:	.data 6, -9
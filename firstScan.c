@@ -1,24 +1,26 @@
 #include "numberingSystems.h"
 #include "buildOutputFiles.h"
+#include "imageTools.h"
+#include "assemblyStats.h"
+#include "listingFile.h"
+#include "macroExpander.h"
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
 
 /* a constant to use whenever the program exits and needs to free all the dynamically allocated resources */
-#define FREE_ALL free(line_holder); \
-                free(token); \
-                free(newSymbol); \
-                free_list(instList);\
-                free_list(dataList);  \
-                free(arg1);         \
-                free(arg2); \
-                free_table(symbols_table, 1); \
-                free(symbols_table); \
-                free(symbol); \
+#define FREE_ALL free_image(&codeImage); \
+                free_image(&dataImage); \
+                free_fixups(&fixups); \
+                free_entry_refs(&entries); \
+                free_symbol_list(&dataSymbols); \
+                free_source_lines(&lines); \
+                free_macro_expander(&expander); \
+                free_table(symbols_table); \
 
 /* free the dynamically allocated variables and exit with an error code if memory allocation failed */
 #define CHECK_MEMORY_ALLOC(x) if (x == NULL) { \
-                                    printf("Memory allocation error. Terminating!\n"); \
+                                    report(diagnostics, DIAG_OUT_OF_MEMORY, line_counter, 0, NULL, 0); \
                                     FREE_ALL \
                                     return 1; \
                                 }
@@ -27,50 +29,61 @@
 #define MARK_ERROR_AND_CONTINUE errors = 1; \
                                 continue;
 
+/* the column of a char of the current line, starting from 1 */
+#define COLUMN(p) ((unsigned int)((p) - line_start) + 1)
+
 /* both macros check if the argument addressing method is valid for the command.
  * If not, inform the user, mark that there was an error, and skip further processing */
-#define CHECK_SRC_ADDRESSING_METHOD(curCommand, addr_method) if (currentCommand->valid_src_addr_methods[addr_method] != '1') \
-                                                                ADDR_METHOD_ERROR
+#define CHECK_SRC_ADDRESSING_METHOD(curCommand, arg, addr_method) if (currentCommand->valid_src_addr_methods[addr_method] != '1') \
+                                                                ADDR_METHOD_ERROR(arg)
 
-#define CHECK_DST_ADDRESSING_METHOD(curCommand, addr_method) if (currentCommand->valid_dst_addr_methods[addr_method] != '1') \
-                                                                ADDR_METHOD_ERROR
+#define CHECK_DST_ADDRESSING_METHOD(curCommand, arg, addr_method) if (currentCommand->valid_dst_addr_methods[addr_method] != '1') \
+                                                                ADDR_METHOD_ERROR(arg)
 
-#define ADDR_METHOD_ERROR { \
-                            printf("Error in line %d: invalid addressing method!\n", line_counter); \
+#define ADDR_METHOD_ERROR(arg) { \
+                            report(diagnostics, DIAG_INVALID_ADDRESSING, line_counter, COLUMN(arg.start), NULL, 0); \
                             MARK_ERROR_AND_CONTINUE \
                             }
 
-#define CHECK_MISSING_ARG(arg) if (strcmp(arg, "") == 0) { \
-                            printf("Error in line %d: missing argument!\n", line_counter); \
+#define CHECK_MISSING_ARG(arg) if (arg.length == 0) { \
+                            report(diagnostics, DIAG_MISSING_ARGUMENT, line_counter, COLUMN(arg.start), NULL, 0); \
                             MARK_ERROR_AND_CONTINUE \
                             }
 
-#define CHECK_LEGAL_ARG(arg, method, table) if (legal_arg(arg, method, table) != 1) { \
-                            printf("Error in line %d: illegal argument! %s\n", line_counter, arg); \
+#define CHECK_LEGAL_ARG(arg, lexeme) if (legal_arg(&lexeme) != 1) { \
+                            report(diagnostics, DIAG_ILLEGAL_ARGUMENT, line_counter, COLUMN(arg.start), arg.start, arg.length); \
                             MARK_ERROR_AND_CONTINUE \
                             }
 
 /* check every char left in the line, and if it isn't a space indicate error */
-#define CHECK_EXTRA_TEXT while (*line != '\0'){ \
+#define CHECK_EXTRA_TEXT while (line < line_end){ \
                                     if(!isspace(*line++)) { \
-                                        printf("Error in line %d: unrecognized extra text!\n", line_counter); \
                                         line--; \
+                                        report(diagnostics, DIAG_EXTRA_TEXT, line_counter, COLUMN(line), NULL, 0); \
                                         break; \
                                     } \
                                 } \
-                          if (!isspace(*line) && *line != '\0'){ \
+                          if (line < line_end && !isspace(*line)){ \
                               MARK_ERROR_AND_CONTINUE \
                           } \
 
 /* to get to the last char in the line - before the \n */
 #define TO_LAST_CHAR 2
 
-/* Input: an assembly file, the commands table and the base filename.
- * Output: returns nothing.
+/* Input: an assembly source file, the base filename, the diagnostics of the file, the stream to write the errors of the
+ * output files to, the statistics of the file, the arena of the file, the flags of the optional output files and an
+ * object to fill instead of building them.
+ * Output: returns 0 if no errors occurred, non-zero value otherwise.
  *
- * Algorithm: First, declare necessary variables, ensure all memory allocations succeeded. Then, read every line in the input
- * assembly file. For each line:
- *  1. reset the relevant variables, update the line counter.
+ * Algorithm: First, declare necessary variables, ensure all memory allocations succeeded. The symbols table, the
+ * symbols, their names and usages and the names in the fix-up table and the .entry instructions are all allocated out
+ * of the arena, so they are not freed here - the caller releases them at once with the arena. Then, read every line in
+ * the input assembly file, in place - the tokens point into the line, and only the names that are stored are copied.
+ * The lines are read through the macro stage, which leaves the definitions of the macros out and replaces their calls
+ * with their lines, read in place as well. Every error and warning is reported to the diagnostics, with the column of
+ * the token it is about. For each line:
+ *  1. reset the relevant variables, update the line counter. Stop reading the file if the limit of the errors was
+ *     reached. If the listing file is built, record where the line is, and the size of both images before it.
  *  2. get the first token, skip the read chars. If it is a symbol definition, mark it and ensure it is followed by a space.
  *  3. if a new symbol is defined, ensure its name is legal, and it is not empty. If either is correct, issue an explained
  *      error, mark it and continue to the next line of the file. If not, create a new symbol with the received name, after
@@ -81,182 +94,219 @@
  *          For every value, ensure it is a legal scalar, create a node for it and add it to the data image. Issue an error
  *          if the last scalar is followed by a comma.
  *     Check there isn't unnecessary extra text in the line, and continue to the next line.
- *  5. if .entry is encountered, issue a warning in case of symbol definition and skip it, since it will be handled in the
- *     second scan.
+ *  5. if .entry is encountered, issue a warning in case of symbol definition, and record the name of the symbol, so it
+ *     will be handled in the second scan.
  *  6. if .extern is encountered, read the symbol name, ensure it's valid, create a new symbol and add it to the table.
  *     Mark an error if the symbol is was already defined not as an external one, if it was already declared, or if something failed.
  *     Initialize its usages property, and ensure no extra text is written. Continue to the next line.
  *
  *  If the code arrived this stage, it means the token must be a command if it is indeed a legal keyword.
- *  7. search for the command in the table. If not found, issue an error and skip further processing. If the command is found,
+ *  7. search for the command in the instruction set. If not found, issue an error and skip further processing. If the command is found,
  *      set the current symbol's (if there is) isCode property to true. Then, encode the necessary arguments (if needed),
  *      ensuring they are legal, considering both addressing method and the argument itself (a legal scalar, legal register, etc.)
  *     Check there isn't unnecessary extra text in the line.
  *  8. encode the command and its arguments, and add them to the instructions image. If something failed, mark an error and continue.
  *
  *
- * If errors occurred during the first scan, free all the dynamically-allocated variables and return 1 to indicate error.
- * Set the values of ICF & DCF, and then update all the symbols that are .data values - increase by ICF, as well as the
- * Data Image nodes ICs. Return to the beginning of the file, and launch the second scan. If errors occurred during it,
- * free all the dynamically-allocated variables and return 1 to indicate error. Otherwise, create the output files, and
- * free all the dynamically-allocated variables. If files creation failed, 1 is returned. Otherwise, we return 0.
+ * Record the counts and the time of every phase in the received statistics. If errors occurred during the first scan,
+ * free all the dynamically-allocated variables and return 1 to indicate error. Set the value of ICF, and relocate the
+ * words of the data image and its symbols - recorded in the order of their addresses while the file was read - by ICF,
+ * in a single sweep. Launch the second scan, which completes the encoding using the recorded .entry instructions and
+ * references - the file is read only once. If errors occurred during it, free all the dynamically-allocated variables
+ * and return 1 to indicate error. Otherwise, create the output files, and the listing file if requested - out of the
+ * lines recorded while the file was read, which are still in the source - and free all the dynamically-allocated
+ * variables. If files creation failed, 1 is returned. Otherwise, we return 0.
  */
-int first_scan(FILE *asmfile, Table *commands_table, char *filename){
+int first_scan(SourceFile *source, char *filename, Diagnostics *diagnostics, FILE *log, AssemblyStats *stats,
+               Arena *arena, unsigned int outputs, struct ObjectFile *object){
+    double start = now_ms(); /* the time the current phase started */
     int IC = CODE_LOADING_ADDRESS; /* initialize the instruction counter */
     int DC = 0; /* initialize the data counter */
     int L = 0; /* the number of words the current command is taking */
     int line_counter = 0; /* indicates the current line the assembler handles */
+    unsigned int line_number; /* the line number of the current line in the source, after the macros were expanded */
+    MacroExpander expander; /* the macro stage, which the lines are read through */
     int errors = 0; /* indicates whether errors were encountered */
     int illegal_scalar = 0; /* marks whether an illegal scalar was encountered in .data */
-    char *token = (char *)malloc(sizeof(char) * MAX_LINE_LENGTH); /* used to hold the current token */
-    char *symbol = (char *)malloc(sizeof(char) * MAX_SYMBOL_LENGTH); /* used to hold the current symbol's name */
+    Token token; /* the current token */
+    Lexeme lexeme, lexeme2; /* the current token as the lexer classified it, and the second argument of a command */
+    char *line_start; /* the first char of the input line */
     char *line; /* used to traverse through the input line */
-    char *word; /* the current encoded word */
-    char *arg1 = (char *)malloc(sizeof(char) * ARG_SIZE); /* allocate memory for the first argument */
-    char *arg2 = (char *)malloc(sizeof(char) * ARG_SIZE); /* allocate memory for the second argument */
+    char *line_end; /* the char after the last one of the input line */
+    Word word; /* the current encoded word */
+    Token arg1, arg2; /* the arguments of the command */
     enum addr_method arg1_addr_method, arg2_addr_method; /* to hold the addressing method of each argument */
 
-    Command *currentCommand; /* the current command handled */
-    cell *currentCell; /* the current cell of the table from which the current command or symbol would be taken */
-    Symbol *newSymbol = (Symbol *)malloc(sizeof(Symbol)); /* allocate memory for the symbol variable */
-
-    BinCodeNode *instList = (BinCodeNode *)calloc(1, sizeof(BinCodeNode)); /* allocate memory for the head of the instructions List */
-    BinCodeNode *currentInstNode = instList; /* holds the current node of the instructions list */
-    BinCodeNode *newNode; /* to create more nodes */
-    BinCodeNode *dataList = (BinCodeNode *)calloc(1, sizeof(BinCodeNode)); /* allocate memory for the head of the data List */
-    BinCodeNode *currentDataNode = dataList; /* holds the current node int the data list */
-
-    /* the table to hold the different commands and their properties */
-    Table *symbols_table = (Table *)calloc(1, sizeof(Table));
-
-    int ICF, DCF; /* the final values of IC and DC */
-
-    char *line_holder = (char *)malloc(sizeof(char) * MAX_LINE_LENGTH); /* allocate memory for to read the file's lines into */
+    const Command *currentCommand; /* the current command handled */
+    Symbol *newSymbol = NULL; /* the symbol defined in the current line */
+
+    Image codeImage = {NULL, 0, 0}; /* the instructions image, indexed by IC - CODE_LOADING_ADDRESS */
+    Image dataImage = {NULL, 0, 0}; /* the data image, indexed by DC */
+    FixupList fixups = {NULL, 0, 0}; /* the words of the code image that refer to symbols */
+    EntryList entries = {NULL, 0, 0}; /* the .entry instructions, applied once the whole file was read */
+    EntryRef *entry; /* the current .entry instruction */
+    SymbolList dataSymbols = {NULL, 0, 0}; /* the symbols of the data image, in the order of their addresses */
+    LineList lines = {NULL, 0, 0}; /* the lines of the file, recorded only for the listing file */
+    SourceLine *sourceLine; /* the current recorded line */
+    int listing = (outputs & LISTING_OUTPUT) && object == NULL; /* marks whether the listing file is built */
+    BinCodeNode *newNode; /* to create more words */
+    unsigned int fixups_size; /* the amount of references before an argument is encoded */
+
+    /* the table to hold the symbols of the file, with its keys and values allocated out of the arena */
+    Table *symbols_table = (Table *)arena_calloc(arena, 1, sizeof(Table));
+
+    int ICF; /* the final value of IC */
+
+    /* ensure the memory allocation succeeded. If not, exit the function with an error code */
+    if (symbols_table == NULL){
+        report(diagnostics, DIAG_OUT_OF_MEMORY, 0, 0, NULL, 0);
+        return 1;
+    }
+    symbols_table->arena = arena;
 
-    /* ensure all memory allocations succeeded. If not, exit the function with an error code */
-    CHECK_MEMORY_ALLOC(token)
-    CHECK_MEMORY_ALLOC(symbol)
-    CHECK_MEMORY_ALLOC(line_holder)
-    CHECK_MEMORY_ALLOC(arg1)
-    CHECK_MEMORY_ALLOC(arg2)
-    CHECK_MEMORY_ALLOC(newSymbol)
-    CHECK_MEMORY_ALLOC(instList)
-    CHECK_MEMORY_ALLOC(dataList)
+    if (init_macro_expander(&expander, source, diagnostics, arena) != 0){
+        report(diagnostics, DIAG_OUT_OF_MEMORY, 0, 0, NULL, 0);
+        return 1;
+    }
+    expander.listed = listing ? &lines : NULL; /* the definitions and calls of the macros are listed as well */
 
-    while (fgets(line_holder, MAX_LINE_LENGTH, asmfile) != NULL){ /* read the file, line by line, until EOF is encountered */
-        int read; /* to hold the amount of chars read by get_token() */
+    /* read the file, line by line, until EOF is encountered - with the calls of the macros replaced by their lines */
+    while (next_expanded_line(&expander, &line_start, &line_end, &line_number)){
+        int read; /* to hold the amount of chars read by the lexer */
         int data_store_inst = 0; /* marks whether a data store instruction is in force, and which */
         int new_symbol_flag = 0; /* indicates whether a new symbol is declared */
-        line_counter++; /* update the line number */
+        unsigned int hashval; /* the hash value of the name of a symbol, for both its lookup and its installation */
+        line_counter = (int)line_number; /* update the line number */
 
-        line = line_holder;
+        if (error_limit_reached(diagnostics, line_counter)){ /* the rest of the file is not checked */
+            errors = 1;
+            break;
+        }
+
+        line = line_start;
 
-        if (is_empty_or_comment_line(line_holder)){
+        if (listing){ /* record where the line is, and where its words will be */
+            sourceLine = add_source_line(&lines);
+            CHECK_MEMORY_ALLOC(sourceLine)
+            sourceLine->start = line_start;
+            sourceLine->length = (unsigned int)(line_end - line_start);
+            sourceLine->code = codeImage.size;
+            sourceLine->data = dataImage.size;
+            sourceLine->number = line_number;
+        }
+
+        if (is_empty_or_comment_line(line_start, line_end)){
             continue; /* if the current line is a comment line or an empty one, we should ignore it */
         }
 
-        read = get_token(line, token, " :"); /* find the next token, might be separated by a space or a colon for a symbol */
+        read = lex_token(line, line_end, &lexeme, CHAR_SPACE | CHAR_COLON); /* find the next token, might be separated by a space or a colon for a symbol */
+        token = lexeme.token;
         line += read; /* continue to the next chars */
 
         if (*line++ == ':'){ /* check if the delimiter is :, thus a new symbol is declared, and skip it */
             new_symbol_flag = 1; /* mark that there is a new symbol to store in the symbols table */
 
-            if(!isspace(*line)){ /* ensure there is a space after the colon */
-                printf("Error in line %d: no space after label name!\n", line_counter);
+            if(line >= line_end || !isspace(*line)){ /* ensure there is a space after the colon */
+                report(diagnostics, DIAG_NO_SPACE_AFTER_LABEL, line_counter, COLUMN(line), NULL, 0);
                 MARK_ERROR_AND_CONTINUE
             }
         }
 
         if (new_symbol_flag){ /* if a new symbol is defined in the current row */
-            if (!legal_symbol(token, commands_table)){ /* mark an error if the symbol's name isn't valid */
-                printf("Error in line %d: Illegal symbol name! %s\n", line_counter, token); /* inform the user about the error */
-                printf("A legal symbol is at most %d chars length, begins with a letter, not a command nor register"
-                       " or keyword, and contains letters and digits only.\n", MAX_SYMBOL_LENGTH); /* explain the rules for a symbol */
+            if (!lexeme.legal){ /* mark an error if the symbol's name isn't valid - the lexer checked the label */
+                report(diagnostics, DIAG_ILLEGAL_SYMBOL, line_counter, COLUMN(token.start), token.start, token.length); /* inform the user about the error */
+                report(diagnostics, DIAG_SYMBOL_RULES, line_counter, 0, NULL, 0); /* explain the rules for a symbol */
                 MARK_ERROR_AND_CONTINUE
-            } else if (is_empty_or_comment_line(line)){ /* ensure the symbol is not empty */
-                printf("Error in line %d: an empty label was defined! %s\n", line_counter, token); /* inform the user about the error */
+            } else if (is_empty_or_comment_line(line, line_end)){ /* ensure the symbol is not empty */
+                report(diagnostics, DIAG_EMPTY_LABEL, line_counter, COLUMN(token.start), token.start, token.length); /* inform the user about the error */
                 MARK_ERROR_AND_CONTINUE
             }
 
-            newSymbol = create_new_symbol(token);
+            /* check if the symbol was already defined */
+            hashval = hash_n(token.start, token.length);
+            if (lookup_hashed(token.start, token.length, hashval, symbols_table) != NULL){
+                report(diagnostics, DIAG_SYMBOL_REDEFINED, line_counter, COLUMN(token.start), token.start,
+                       token.length); /* inform the user about the error */
+                MARK_ERROR_AND_CONTINUE
+            }
+
+            newSymbol = create_new_symbol(token, arena);
             CHECK_MEMORY_ALLOC(newSymbol)
 
-            /* check if the symbol was already defined */
-            if (lookup(newSymbol->name, symbols_table) != NULL){
-                printf("Error in line %d: Redefining a symbol %s\n", line_counter, newSymbol->name); /* inform the user about the error */
+            /* install the new symbol under the name it holds out of the arena, with the hash value of the lookup */
+            if (install_hashed(newSymbol->name, hashval, newSymbol, symbols_table) == NULL){
+                report(diagnostics, DIAG_SYMBOL_TABLE_ERROR, line_counter, 0, NULL, 0);
                 MARK_ERROR_AND_CONTINUE
-            } else { /* install the new symbol only if it wasn't already defined */
-                if (install(newSymbol->name, newSymbol, symbols_table) == NULL){ /* add the symbol to the table. Ensure operation succeeded */
-                    printf("Error while adding symbol to table.\n");
-                    MARK_ERROR_AND_CONTINUE
-                }
             }
 
-            read = get_token(line, token, " "); /* store the "real" token in token */
+            read = lex_token(line, line_end, &lexeme, CHAR_SPACE); /* store the "real" token in token */
+            token = lexeme.token;
             line += read; /* skip the chars we have just read */
         }
 
-        if ((data_store_inst = is_data_store_inst(token))){ /* check whether a data storing instruction was encountered */
+        if (lexeme.type == TOKEN_DIRECTIVE){ /* check whether a data storing instruction was encountered */
+            data_store_inst = (lexeme.keyword == DATA_DIRECTIVE) ? DATA_INST :
+                              (lexeme.keyword == STRING_DIRECTIVE) ? STRING_INST : 0;
+        }
+
+        if (data_store_inst){
             if (new_symbol_flag){
                 newSymbol->isData = true; /* mark that the symbol is associated with data storing instruction */
                 newSymbol->value = DC; /* add the address of the symbol */
+                CHECK_MEMORY_ALLOC(add_symbol(&dataSymbols, newSymbol)) /* it is relocated with the data image */
             }
 
             if (data_store_inst == STRING_INST){ /* check if the instruction is .string */
-                read = get_token(line, token, "\""); /* store the string in token */
+                read = get_token(line, line_end, &token, CHAR_QUOTE); /* store the string in token */
                 line += read + 1;
 
-                if (strcmp(token, "") == 0){ /* ensure no empty .string is provided */
-                    printf("Error in line %d: empty .string is declared!\n", line_counter);
+                if (token.length == 0){ /* ensure no empty .string is provided */
+                    report(diagnostics, DIAG_EMPTY_STRING, line_counter, COLUMN(token.start), NULL, 0);
                     MARK_ERROR_AND_CONTINUE
                 }
 
-                currentDataNode->next = encode_string(token, &DC);
-
-                /* proceed to the last item in the list */
-                while (currentDataNode->next != NULL){
-                    currentDataNode = currentDataNode->next;
+                if (encode_string(token, &dataImage, &DC) != 0){ /* add the string to the data image, exit if memory allocation failed */
+                    report(diagnostics, DIAG_OUT_OF_MEMORY, line_counter, 0, NULL, 0);
+                    FREE_ALL
+                    return 1;
                 }
 
                 /* ensure no extra text is written */
                 CHECK_EXTRA_TEXT
             } else { /* if the instruction is .data */
-                read = get_token(line, token, ","); /* store the string in token */
+                read = lex_token(line, line_end, &lexeme, CHAR_COMMA); /* store the string in token */
+                token = lexeme.token;
                 line += read + 1;
 
-                if (strcmp(token, "") == 0){ /* ensure no empty .data is provided */
-                    printf("Error in line %d: empty .data is declared!\n", line_counter);
+                if (token.length == 0){ /* ensure no empty .data is provided */
+                    report(diagnostics, DIAG_EMPTY_DATA, line_counter, COLUMN(token.start), NULL, 0);
                     MARK_ERROR_AND_CONTINUE
                 }
 
-                while (strcmp(token, "") != 0){ /* read all the data */
-                    if (!legal_scalar(token)){ /* ensure only legal scalars are provided */
+                while (token.length != 0){ /* read all the data */
+                    if (lexeme.type != TOKEN_SCALAR){ /* ensure only legal scalars are provided */
                         errors = 1; /* indicate that there was an error, and print it */
                         illegal_scalar = 1; /* indicate that an invalid scalar was encountered */
-                        printf("Error in line %d: Illegal scalar in .data, or no comma between arguments! %s\n", line_counter, token); /* inform the user about the error */
+                        report(diagnostics, DIAG_ILLEGAL_SCALAR, line_counter, COLUMN(token.start), token.start, token.length); /* inform the user about the error */
                         break;
                     }
 
-                    newNode = (BinCodeNode *)calloc(1, sizeof(BinCodeNode)); /* allocate memory for the new node */
+                    newNode = add_word(&dataImage); /* add a word to the data image */
                     CHECK_MEMORY_ALLOC(newNode) /* ensure memory allocation completed successfully */
-                    newNode->code = decimal_to_bin(atoi(token)); /* encode the number */
-                    if (newNode->code == NULL){
-                        MARK_ERROR_AND_CONTINUE
-                    }
+                    newNode->code = decimal_to_word(lexeme.value); /* encode the number, read by the lexer */
 
                     newNode->IC = DC++; /* set data node value and update DC */
                     newNode->are = A; /* specify ARE attribute */
 
-                    /* add the new node to the list and move the pointer to the current node to the end of the list */
-                    ADD_TO_LIST(currentDataNode, newNode)
-
-                    read = get_token(line, token, ","); /* read the next scalar */
+                    read = lex_token(line, line_end, &lexeme, CHAR_COMMA); /* read the next scalar */
+                    token = lexeme.token;
                     line += read + 1; /* skip the chars we read */
                 }
 
                 /* check if data ends with a comma */
-                if (*(line - TO_LAST_CHAR) == ','){
-                    printf("Error in line %d: .data cannot end with a comma!\n", line_counter);
+                if (*(line - TO_LAST_CHAR) == ','){ /* an error like any other - the file is not assembled */
+                    report(diagnostics, DIAG_DATA_ENDS_WITH_COMMA, line_counter, COLUMN(line - TO_LAST_CHAR), NULL, 0);
+                    errors = 1;
                 }
 
                 /* ensure no extra text is written */
@@ -268,50 +318,65 @@ int first_scan(FILE *asmfile, Table *commands_table, char *filename){
             continue; /* continue to the next line */
         }
 
-        if (strcmp(token, ".entry") == 0){
+        if (lexeme.type == TOKEN_DIRECTIVE && lexeme.keyword == ENTRY_DIRECTIVE){
             if (new_symbol_flag){ /* issue a warning if a symbol id declared before .entry */
-                printf("line %d - Warning: Symbol definition before .entry\n", line_counter);
+                report(diagnostics, DIAG_LABEL_BEFORE_ENTRY, line_counter, 0, NULL, 0);
             }
 
-            continue; /* if it is an .entry instruction, skip to the next line, since .entry will be handled in the second scan */
+            read = get_token(line, line_end, &token, CHAR_SPACE); /* read the name of the entry symbol */
+            line += read + 1; /* skip the characters we read and the delimiter */
+
+            /* record the instruction - the symbol might be defined later in the file, so it is applied in the second scan */
+            entry = add_entry_ref(&entries, token, line_counter, arena);
+            CHECK_MEMORY_ALLOC(entry)
+            entry->column = COLUMN(token.start);
+
+            for (; line < line_end && isspace(*line); line++); /* skip the spaces after the name */
+            entry->hasExtraText = (line < line_end) ? true : false; /* extra text is reported in the second scan, in order */
+
+            continue; /* the rest of the instruction will be handled in the second scan */
         }
 
-        if (strcmp(token, ".extern") == 0){ /* if an external symbol is defined, add it to the symbols table with isExtern=true */
+        if (lexeme.type == TOKEN_DIRECTIVE && lexeme.keyword == EXTERN_DIRECTIVE){ /* if an external symbol is defined, add it to the symbols table with isExtern=true */
             Symbol *curSymbol;
             cell *curCell;
 
             if (new_symbol_flag){ /* issue a warning if a symbol id declared before .extern */
-                printf("line %d - Warning: Symbol definition before .extern\n", line_counter);
+                report(diagnostics, DIAG_LABEL_BEFORE_EXTERN, line_counter, 0, NULL, 0);
             }
 
-            read = get_token(line, token, " "); /* read the external symbol name */
+            read = lex_token(line, line_end, &lexeme, CHAR_SPACE); /* read the external symbol name */
+            token = lexeme.token;
             line += read + 1; /* skip the characters we read */
 
-            curCell = (cell *)lookup(token, symbols_table); /* search for the name of the label in the current table */
+            hashval = hash_n(token.start, token.length);
+            /* search for the name of the label in the current table */
+            curCell = lookup_hashed(token.start, token.length, hashval, symbols_table);
 
             /* indicate an error if the symbol name isn't valid */
-            if (!legal_symbol(token, commands_table)){
-                printf("Error in line: %d: problematic external symbol %s\n", line_counter, token); /* inform the user regarding the error */
+            if (lexeme.type != TOKEN_SYMBOL || !lexeme.legal){
+                report(diagnostics, DIAG_ILLEGAL_EXTERN, line_counter, COLUMN(token.start), token.start, token.length); /* inform the user regarding the error */
                 MARK_ERROR_AND_CONTINUE
             } else if (curCell != NULL && ((Symbol *)curCell->value)->isExternal == false){ /* error if the symbol is already defined without the external property */
-                printf("Error in line: %d: multiple declarations of external symbol %s\n", line_counter, token); /* inform the user regarding the error */
+                report(diagnostics, DIAG_EXTERN_REDECLARED, line_counter, COLUMN(token.start), token.start, token.length); /* inform the user regarding the error */
                 MARK_ERROR_AND_CONTINUE
             } else if (curCell != NULL && ((Symbol *)curCell->value)->isExternal == true){/* error if an external symbol is re-declared */
-                printf("Error in line: %d: multiple declarations of external symbol %s\n", line_counter, token); /* inform the user regarding the error */
+                report(diagnostics, DIAG_EXTERN_REDECLARED, line_counter, COLUMN(token.start), token.start, token.length); /* inform the user regarding the error */
                 MARK_ERROR_AND_CONTINUE
             }
 
-            curSymbol = create_new_symbol(token);
+            curSymbol = create_new_symbol(token, arena);
             CHECK_MEMORY_ALLOC(curSymbol)
 
             curSymbol->isExternal = true;
 
-            curSymbol->usage = (Usage *)calloc(1, sizeof(Usage));
+            curSymbol->usage = (Usage *)arena_calloc(arena, 1, sizeof(Usage));
             CHECK_MEMORY_ALLOC(curSymbol->usage)
+            curSymbol->lastUsage = curSymbol->usage; /* the list is empty - its head is its end */
 
             curSymbol->value = 0; /* external symbols value is always 0 */
-            if (install(curSymbol->name, curSymbol, symbols_table) == NULL){ /* add the symbol to the table. Ensure operation succeeded */
-                printf("Error while adding symbol to table.\n");
+            if (install_hashed(curSymbol->name, hashval, curSymbol, symbols_table) == NULL){ /* add it to the table */
+                report(diagnostics, DIAG_SYMBOL_TABLE_ERROR, line_counter, 0, NULL, 0);
                 MARK_ERROR_AND_CONTINUE
             }
 
@@ -321,16 +386,15 @@ int first_scan(FILE *asmfile, Table *commands_table, char *filename){
         }
 
         /* if we arrived here, it means the line is an instruction line, an assembly command line */
-        currentCell = lookup(token, commands_table); /* get the cell of the command */
-        if (currentCell == NULL){
-            printf("Error in line %d: Invalid command! %s\n", line_counter, token); /* inform the user about the error */
+        currentCommand = (lexeme.type == TOKEN_MNEMONIC) ? get_command(lexeme.keyword) : NULL; /* get the command */
+        if (currentCommand == NULL){
+            report(diagnostics, DIAG_INVALID_COMMAND, line_counter, COLUMN(token.start), token.start, token.length); /* inform the user about the error */
             MARK_ERROR_AND_CONTINUE
         }
 
         L = 1; /* the current command's size is at least one word - the command name */
 
-        /* if we arrived here, it means the command was found in the table, so we extract it */
-        currentCommand = (Command *)currentCell->value;
+        /* if we arrived here, it means the command was found */
         L += currentCommand->num_of_args; /* update the num of words - add the amount of arguments */
 
         if (new_symbol_flag){
@@ -343,47 +407,50 @@ int first_scan(FILE *asmfile, Table *commands_table, char *filename){
         if (currentCommand->num_of_args == 0){
             word = encode_command(currentCommand->opcode, currentCommand->funct, 0, 0);
         } else if (currentCommand->num_of_args == 1){
-            read = get_token(line, arg1, " "); /* get the argument */
+            read = lex_token(line, line_end, &lexeme, CHAR_SPACE); /* get the argument */
+            arg1 = lexeme.token;
             line += read; /* skip the chars we have already read */
 
-            arg1_addr_method = get_addressing_method(arg1); /* determine the addressing method */
+            arg1_addr_method = get_addressing_method(&lexeme); /* determine the addressing method */
 
             CHECK_MISSING_ARG(arg1) /* ensure there was provided an argument */
 
             /* check if the addressing method is valid for the command */
-            CHECK_DST_ADDRESSING_METHOD(currentCommand, arg1_addr_method)
+            CHECK_DST_ADDRESSING_METHOD(currentCommand, arg1, arg1_addr_method)
 
             /* check if the argument is legal */
-            CHECK_LEGAL_ARG(arg1, arg1_addr_method, commands_table)
+            CHECK_LEGAL_ARG(arg1, lexeme)
 
             word = encode_command(currentCommand->opcode, currentCommand->funct, 0, arg1_addr_method);
         } else {
-            read = get_token(line, arg1, ","); /* get the first argument */
+            read = lex_token(line, line_end, &lexeme, CHAR_COMMA); /* get the first argument */
+            arg1 = lexeme.token;
             line += read; /* skip the chars we have already read */
 
             /* check if there is a separating comma. Ensure that the problem is indeed the comma - only if two args were indeed supplied */
-            if (*line++ != ',' && is_containing_space_between_words(arg1)){
-                printf("Error in line %d: no comma between arguments!\n", line_counter);
+            if (*line++ != ',' && lexeme.spaced){
+                report(diagnostics, DIAG_MISSING_COMMA, line_counter, COLUMN(line - 1), NULL, 0);
                 MARK_ERROR_AND_CONTINUE
             }
 
-            arg1_addr_method = get_addressing_method(arg1); /* determine the addressing method */
+            arg1_addr_method = get_addressing_method(&lexeme); /* determine the addressing method */
 
-            read = get_token(line, arg2, " "); /* get the argument */
+            read = lex_token(line, line_end, &lexeme2, CHAR_SPACE); /* get the argument */
+            arg2 = lexeme2.token;
             line += read; /* skip the chars we have already read */
 
-            arg2_addr_method = get_addressing_method(arg2); /* determine the addressing method */
+            arg2_addr_method = get_addressing_method(&lexeme2); /* determine the addressing method */
 
             CHECK_MISSING_ARG(arg1)
             CHECK_MISSING_ARG(arg2)
 
             /* check if the addressing methods are valid for the command */
-            CHECK_SRC_ADDRESSING_METHOD(currentCommand, arg1_addr_method)
-            CHECK_DST_ADDRESSING_METHOD(currentCommand, arg2_addr_method)
+            CHECK_SRC_ADDRESSING_METHOD(currentCommand, arg1, arg1_addr_method)
+            CHECK_DST_ADDRESSING_METHOD(currentCommand, arg2, arg2_addr_method)
 
             /* check if the arguments arg legal */
-            CHECK_LEGAL_ARG(arg1, arg1_addr_method, commands_table)
-            CHECK_LEGAL_ARG(arg2, arg2_addr_method, commands_table)
+            CHECK_LEGAL_ARG(arg1, lexeme)
+            CHECK_LEGAL_ARG(arg2, lexeme2)
 
             word = encode_command(currentCommand->opcode, currentCommand->funct, arg1_addr_method, arg2_addr_method);
         }
@@ -391,186 +458,178 @@ int first_scan(FILE *asmfile, Table *commands_table, char *filename){
         /* ensure no extra text is written */
         CHECK_EXTRA_TEXT
 
-        if (word == NULL){ /* if word encoding failed, mark an error and continue */
-            printf("Memory allocation error during compilation, line %d\n", line_counter);
-            MARK_ERROR_AND_CONTINUE
-        }
-
-        newNode = (BinCodeNode *)calloc(1, sizeof(BinCodeNode));
+        newNode = add_word(&codeImage); /* add the word of the command to the instructions image */
         CHECK_MEMORY_ALLOC(newNode)
         newNode->code = word;
         newNode->IC = IC++; /* set the address value of the node */
         newNode->L = L; /* set the L attribute */
         newNode->are = A; /* the address of an instruction line is absolute */
 
-        /* add the new node to the list and move the pointer to the current node to the end of the list */
-        ADD_TO_LIST(currentInstNode, newNode)
-
         if (currentCommand->num_of_args == 0){
             continue; /* skip addition of arguments */
         }
 
         /* add the arguments */
 
-        /* allocate memory for the new node and check if it failed */
-        newNode = (BinCodeNode *)calloc(1, sizeof(BinCodeNode));
+        /* add a word for the argument and check if it failed */
+        newNode = add_word(&codeImage);
         CHECK_MEMORY_ALLOC(newNode)
         newNode->are = A; /* the default ARE is A */
-
-        if (constructArg(newNode, arg1, arg1_addr_method) != 0){ /* if argument encoding failed, mark an error and continue */
-            printf("Memory allocation error during compilation, line %d\n", line_counter);
-            MARK_ERROR_AND_CONTINUE
-        }
-
         newNode->IC = IC++; /* set the address value of the node */
         newNode->L = line_counter; /* for an argument, set the L property to the line number */
 
-        /* add the new node to the list and move the pointer to the current node to the end of the list */
-        ADD_TO_LIST(currentInstNode, newNode)
+        fixups_size = fixups.size;
+        if (constructArg(newNode, codeImage.size - 1, arg1, arg1_addr_method, &fixups, arena) != 0){ /* if argument encoding failed, mark an error and continue */
+            report(diagnostics, DIAG_ARGUMENT_OUT_OF_MEMORY, line_counter, COLUMN(arg1.start), NULL, 0);
+            MARK_ERROR_AND_CONTINUE
+        }
+        if (fixups.size > fixups_size){ /* the argument refers to a symbol */
+            fixups.fixups[fixups_size].column = COLUMN(arg1.start);
+        }
 
         if (currentCommand->num_of_args == 1){
             continue; /* skip addition of second argument */
         }
 
-        /* allocate memory for the new node and check if it failed */
-        newNode = (BinCodeNode *)calloc(1, sizeof(BinCodeNode));
+        /* add a word for the argument and check if it failed */
+        newNode = add_word(&codeImage);
         CHECK_MEMORY_ALLOC(newNode)
         newNode->are = A; /* the default ARE is A */
+        newNode->IC = IC++;/* set the address value of the node */
+        newNode->L = line_counter; /* for an argument, set the L property to the line number */
 
-        if (constructArg(newNode, arg2, arg2_addr_method) != 0){ /* if argument encoding failed, mark an error and continue */
-            printf("Memory allocation error during compilation, line %d\n", line_counter);
+        fixups_size = fixups.size;
+        if (constructArg(newNode, codeImage.size - 1, arg2, arg2_addr_method, &fixups, arena) != 0){ /* if argument encoding failed, mark an error and continue */
+            report(diagnostics, DIAG_ARGUMENT_OUT_OF_MEMORY, line_counter, COLUMN(arg2.start), NULL, 0);
             MARK_ERROR_AND_CONTINUE
         }
+        if (fixups.size > fixups_size){ /* the argument refers to a symbol */
+            fixups.fixups[fixups_size].column = COLUMN(arg2.start);
+        }
+    }
 
-        newNode->IC = IC++;/* set the address value of the node */
-        newNode->L = line_counter; /* for an argument, set the L property to the line number */
-
-        /* add the new node to the list and move the pointer to the current node to the end of the list */
-        ADD_TO_LIST(currentInstNode, newNode)
+    if (expander.errors > 0){ /* the definition or the call of a macro was wrong */
+        errors = 1;
     }
 
+    /* record what the first scan went over */
+    stats->first_scan_ms = now_ms() - start;
+    stats->lines = expander.lines;
+    stats->code_words = codeImage.size;
+    stats->data_words = dataImage.size;
+    stats->symbols = symbols_table->count;
+    stats->max_probe_length = max_probe_length(symbols_table);
+
     if (errors){ /* skip further processing if an error was occurred*/
         FREE_ALL
         return 1;
     }
 
-    currentInstNode = instList->next; /* skip the beginning node */
-    currentDataNode = dataList->next; /* skip the beginning node */
-
+    start = now_ms();
     ICF = IC;
-    DCF = DC;
-
-    while (currentDataNode != NULL){
-        currentDataNode->IC += ICF;
-        currentDataNode = currentDataNode->next;
-    }
+    relocate_data(&dataImage, &dataSymbols, ICF); /* the data image is placed right after the instructions image */
+    stats->relocation_ms = now_ms() - start;
 
-    update_all_symbols_value(symbols_table, ICF);
-
-    rewind(asmfile); /* return to the beginning of the file */
-    errors += secondScan(asmfile, symbols_table, instList->next);
+    start = now_ms();
+    errors += secondScan(symbols_table, &codeImage, &fixups, &entries, diagnostics); /* resolve the references without reading the file again */
+    stats->second_scan_ms = now_ms() - start;
 
     if (errors){
         FREE_ALL
         return 1;
     }
 
-    errors += build_output_files(instList->next, dataList->next, symbols_table, filename, ICF - CODE_LOADING_ADDRESS, DCF);
+    errors += build_output_files(&codeImage, &dataImage, symbols_table, filename, log, stats, outputs, object);
+
+    if (!errors && listing){ /* the lines are still in the source, and the words are all encoded */
+        start = now_ms();
+        errors += build_listing_file(&lines, &codeImage, &dataImage, filename, log);
+        stats->listing_file_ms = now_ms() - start;
+        stats->output_files |= LISTING_FILE_BUILT;
+    }
+
+    if (object != NULL && !errors){ /* the images were moved to the object */
+        memset(&codeImage, 0, sizeof(Image));
+        memset(&dataImage, 0, sizeof(Image));
+    }
 
     FREE_ALL
 
     return errors; /* indicate whether some errors occurred */
 }
 
-/* Input: the symbols table and a value - ICF.
- * Output: returns nothing. Adds to every cell in the table the value to add, to the "value" attribute.
+/* Input: the data image, the symbols of the data image in the order of their addresses, and ICF.
+ * Output: returns nothing. Adds ICF to the address of every word of the data image and to the value of every symbol
+ * of it.
  *
- * Algorithm:
+ * Algorithm: the symbols of the data image were defined in the order of their addresses, as the data counter only
+ * grows - so a single sweep over the data image relocates them together with its words: relocate the words up to the
+ * address of the next symbol, then the symbol, and finally the words after the last symbol. The symbols of the code
+ * and the externals are not visited at all.
  */
-void update_all_symbols_value(Table *symbols_table, unsigned int to_add){
-    int i;
-    cell *c;
+void relocate_data(Image *dataImage, SymbolList *dataSymbols, unsigned int ICF){
+    Symbol **symbol = dataSymbols->symbols, **symbols_end = dataSymbols->symbols + dataSymbols->size;
+    BinCodeNode *word = dataImage->words, *end = dataImage->words + dataImage->size, *next;
 
-    for (i = 0; i < TABLE_SIZE; i++) { /* go over all the cells */
-        for (c = symbols_table->storage[i];  c != NULL ; c = c->next) {
-            Symbol *symbol = (Symbol *)c->value; /* get the current symbol */
+    for (; symbol < symbols_end; symbol++){
+        next = ((*symbol)->value < dataImage->size) ? dataImage->words + (*symbol)->value : end; /* the word of the symbol */
 
-            if (symbol->isData == true){ /* if it is a data symbol, update its value */
-                symbol->value += to_add;
-            }
+        for (; word < next; word++){ /* the words before it */
+            word->IC += ICF;
         }
+        (*symbol)->value += ICF;
+    }
+
+    for (; word < end; word++){ /* the words after the last symbol */
+        word->IC += ICF;
     }
 }
 
-/* Input: a string of valid ascii chars.
- * Output: returns a list of nodes that represent the string. Updates the data counter received. If something failed,
- * NULL is returned.
+/* Input: a token of valid ascii chars, the data image and a pointer to the data counter.
+ * Output: adds the words that represent the string to the data image. Updates the data counter received. Returns 0 if
+ * succeeded, 1 if memory allocation failed.
  *
- * Algorithm: Create the first node of the string, ensuring memory allocation succeeded. Then, we skip the opening " if
- * included, and iterate through every char in the received string. For each one, we create a node, setting its value
- * to the binary representation of its numeric value, specifying its address value (and updating the received IC),
- * setting its ARE to A, and finally adding it to the list. We repeat the process to add the last node with the char '\0'.
- * If something failed, NULL is returned. If everything succeeded, we return the node of the first char in the received string.
+ * Algorithm: skip the opening " if included, and iterate through every char in the received token. For each one, we
+ * add a word to the data image, setting its value to its numeric value, specifying its address value (and updating
+ * the received DC) and setting its ARE to A. We repeat the process to add the last word with the char '\0'.
+ * If something failed, 1 is returned. If everything succeeded, we return 0.
  */
-BinCodeNode *encode_string(char *string, int *DC){
-    BinCodeNode *first = (BinCodeNode *)calloc(1, sizeof(BinCodeNode)); /* allocate memory for the first node of the string */
-    BinCodeNode *cur = first; /* used to add new nodes */
+int encode_string(Token string, Image *dataImage, int *DC){
     BinCodeNode *newNode;
+    int i;
 
-    RETURN_IF_MEMORY_ALLOC_ERROR(first, NULL)
-
-    if (*string == '\"'){ /* check if the opening " of the string is included */
-        string++; /* skip the opening " */
+    if (string.length > 0 && string.start[0] == '\"'){ /* check if the opening " of the string is included */
+        string = skip_chars(string, 1); /* skip the opening " */
     }
 
-    for (; *string != '\0'; string++){ /* iterate through the string */
-        newNode = (BinCodeNode *)calloc(1, sizeof(BinCodeNode)); /* allocate memory for the node of the current char */
-        RETURN_IF_MEMORY_ALLOC_ERROR(newNode, NULL)
+    for (i = 0; i <= string.length; i++){ /* iterate through the string, and add the terminating '\0' after it */
+        newNode = add_word(dataImage); /* add a word for the current char */
+        RETURN_IF_MEMORY_ALLOC_ERROR(newNode, 1)
 
-        newNode->code = decimal_to_bin(*string); /* encode the character */
-        RETURN_IF_MEMORY_ALLOC_ERROR(newNode->code, NULL) /* ensure encoding succeeded */
+        newNode->code = decimal_to_word((i < string.length) ? string.start[i] : '\0'); /* encode the character */
         newNode->IC = *DC; /* specify the memory address of the current char */
         *DC += 1; /* update the data counter */
         newNode->are = A;
-
-        /* add the new node to the list and move the pointer to the current node to the end of the list */
-        ADD_TO_LIST(cur, newNode)
     }
 
-    /* add the \0 char to mark the end of the string */
-    newNode = (BinCodeNode *)calloc(1, sizeof(BinCodeNode)); /* allocate memory for the node of the current char */
-    RETURN_IF_MEMORY_ALLOC_ERROR(newNode, NULL)
-
-    newNode->code = decimal_to_bin('\0'); /* encode the character */
-    RETURN_IF_MEMORY_ALLOC_ERROR(newNode->code, NULL) /* ensure encoding succeeded */
-    newNode->IC = *DC; /* specify the memory address of the current char */
-    *DC += 1; /* update the data counter */
-    newNode->are = A;
-
-    /* add the new node to the list and move the pointer to the current node to the end of the list */
-    ADD_TO_LIST(cur, newNode)
-
-    cur = first->next; /* save the node to be returned */
-    free(first); /* free the first, dummy node */
-    return cur; /* return the beginning of the string */
+    return 0;
 }
 
-/* Input: a string representing the name of the symbol.
+/* Input: a token representing the name of the symbol, and the arena of the file.
  * Output: returns a symbol with the provided name, all additional attributes set to false. If memory Allocation failed,
  * NULL is returned.
  *
- * Algorithm: First, allocate memory for the symbol and its name, and ensure it was completed successfully. If not, return NULL
- * Then, copy the received name to the symbol's name, reset the properties, and return the symbol.
+ * Algorithm: First, allocate memory for the symbol and its name out of the arena, and ensure it was completed
+ * successfully. If not, return NULL. The name is copied out of the line while it is allocated. Then, reset the
+ * properties, and return the symbol.
  */
-Symbol *create_new_symbol(char *name){
-    Symbol *newSymbol = (Symbol *)malloc(sizeof(Symbol)); /* allocate memory for the symbol variable */
+Symbol *create_new_symbol(Token name, Arena *arena){
+    Symbol *newSymbol = (Symbol *)arena_alloc(arena, sizeof(Symbol)); /* allocate memory for the symbol variable */
     RETURN_IF_MEMORY_ALLOC_ERROR(newSymbol, NULL)
 
-    newSymbol->name = (char *) malloc(sizeof(char) * MAX_SYMBOL_LENGTH); /* allocate memory for the name of the symbol */
+    newSymbol->name = arena_copy_string(arena, name.start, name.length); /* the only copy of the name */
     RETURN_IF_MEMORY_ALLOC_ERROR(newSymbol->name, NULL)
 
-    strcpy(newSymbol->name, name);
-
     /* reset the fields that might not change */
     newSymbol->isData = false;
     newSymbol->isCode = false;
@@ -578,21 +637,4 @@ Symbol *create_new_symbol(char *name){
     newSymbol->isExternal = false;
 
     return newSymbol; /* return the created symbol */
-}
-
-/* Input: a list of binary codes to free.
- * Output: returns nothing.
- *
- * Algorithm: Create a variable to store the remaining of the list. Then, until the received pointer is NULL, store in
- * the created node the rest of the list, free the current node, and then use the stored node to "return" to the list.
- */
-void free_list(BinCodeNode *head){
-    BinCodeNode *curNode = head; /* used to iterate through the received list */
-
-    while (head != NULL){ /* go over the whole list */
-        curNode = head->next; /* hold the remaining of the list */
-        free(head->code); /* free the code property of the current node */
-        free(head); /* free the current node */
-        head = curNode; /* proceed to the next node */
-    }
 }
\ No newline at end of file
@@ -1,42 +1,51 @@
 #include <stdio.h>
 #include "secondScan.h"
+#include "sourceReader.h"
+#include "assemblyStats.h"
 
-/* Input: an assembly file, the commands table, and the base filename.
- * Output: returns nothing.
+/* the whole output of the assembler in memory, defined in binaryObject.h */
+struct ObjectFile;
+
+/* Input: an assembly source file, the base filename, the diagnostics of the file, the stream to write the errors of the
+ * output files to, the statistics of the file, the arena of the file, the flags of the optional output files and an
+ * object to fill instead of building the output files (NULL for none).
+ * Output: returns 0 if no errors occurred, non-zero value otherwise.
  *
  * This function begins the process of the assembler, returns 0 if no errors occurred, non-zero value otherwise.
+ * Errors and warnings are reported to the received diagnostics, which the caller prints once the file was assembled -
+ * so that files assembled at the same time don't mix them. Once the limit of the errors of the diagnostics is reached,
+ * the file is not scanned any further. Failures to build the output files are written to the received stream.
+ * The time of every phase and the amount of lines, words and symbols are recorded in the received statistics.
+ * The symbols of the file and their names are allocated out of the received arena, which the caller releases at once.
+ * The optional output files to build besides the text files are set in the received flags.
+ * If an object is received, no file is written: on success, the images are moved to the object and its symbols are
+ * named by the symbols of the arena.
  */
-int first_scan(FILE *asmfile, Table *commands_table, char *filename);
+int first_scan(SourceFile *source, char *filename, Diagnostics *diagnostics, FILE *log, AssemblyStats *stats,
+               Arena *arena, unsigned int outputs, struct ObjectFile *object);
 
-/* Input: the symbols table and a value - ICF.
- * Output: returns nothing. Adds to every cell in the table the value to add, to the "value" attribute.
+/* Input: the data image, the symbols of the data image in the order of their addresses, and ICF.
+ * Output: returns nothing. Adds ICF to the address of every word of the data image and to the value of every symbol
+ * of it.
  *
- * This function receives the symbols table and the ICF, and adds it to the value of every cell.
+ * This function places the data image right after the code image, relocating its words and its symbols in a single
+ * pass over both.
  */
-void update_all_symbols_value(Table *symbols_table, unsigned int to_add);
+void relocate_data(Image *dataImage, SymbolList *dataSymbols, unsigned int ICF);
 
-/* Input: a string of valid ascii chars and a pointer to the data counter.
- * Output: returns a list of nodes that represents the string. Updates the data counter received. If something failed,
- * NULL is returned.
+/* Input: a token of valid ascii chars, the data image and a pointer to the data counter.
+ * Output: adds the words that represent the string to the data image. Updates the data counter received. Returns 0 if
+ * succeeded, 1 if memory allocation failed.
  *
- * This function receives a string and encodes it, returns it as a list of nodes. It also updates
- * the data counter value.
+ * This function receives a string and encodes it to the data image. It also updates the data counter value.
  */
-BinCodeNode *encode_string(char *string, int *DC);
+int encode_string(Token string, Image *dataImage, int *DC);
 
-/* Input: a string representing the name of the symbol.
+/* Input: a token representing the name of the symbol, and the arena of the file.
  * Output: returns a symbol with the provided name, all additional attributes set to false. If memory Allocation failed,
  * NULL is returned.
  *
- * This function receives a name, creates a symbol with it, resets its properties and returns it, or NULL if something
- * failed.
- */
-Symbol *create_new_symbol(char *name);
-
-
-/* Input: a list of binary codes to free.
- * Output: returns nothing.
- *
- * This function receives a list of binary code nodes, and frees the dynamically-allocated memory it uses.
+ * This function receives a name, creates a symbol with it out of the arena, resets its properties and returns it, or
+ * NULL if something failed.
  */
-void free_list(BinCodeNode *head);
+Symbol *create_new_symbol(Token name, Arena *arena);
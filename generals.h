@@ -1,8 +1,25 @@
+#ifndef GENERALS_H
+#define GENERALS_H
+
+#include <stdint.h>
+
 /* error codes for the program to exit with */
 #define MISSING_ARGS_ERROR 1
-#define COMMANDS_TABLE_ERROR 2
 #define MEMORY_ALLOC_ERROR 3
 
+/* the version of the assembler, which is a part of the key of the build cache - it must be changed whenever the output
+ * files of the assembler change */
+#define ASSEMBLER_VERSION "1.20"
+
+/* flags of the optional output files, built besides the text files */
+#define BINARY_OBJECT_OUTPUT 1
+
+/* a flag of the format of the messages: print the diagnostics of the files as JSON objects, instead of text */
+#define JSON_DIAGNOSTICS_OUTPUT 2
+
+/* a flag of the optional output files: build a listing file, which shows every line of the source with its words */
+#define LISTING_OUTPUT 4
+
 /* the required extension for input files */
 #define INPUT_FILE_EXT ".as"
 
@@ -28,6 +45,9 @@
 /* the size of the word is as the above 4 fields size sum */
 #define WORD_SIZE 12
 
+/* masks a value to the bits of a word */
+#define WORD_MASK ((1 << WORD_SIZE) - 1)
+
 /* a for-bits binary converts to a one char hexadecimal */
 #define BIN_TO_HEX_CURRENCY 4
 
@@ -42,11 +62,6 @@
                                     return y; \
                                 }
 
-/* add new_node to the list after cur_node, and update cur_node to point at the current last node. Make sure new_node ends the list */
-#define ADD_TO_LIST(cur_node, new_node) cur_node->next = new_node; \
-                                        cur_node = cur_node->next; \
-                                        new_node->next = NULL;
-
 /* an enum that describes the addressing methods */
 enum addr_method {IMMEDIATE=0, DIRECT=1, RELATIVE=2, IMD_REGISTER=3};
 
@@ -69,20 +84,129 @@ struct Symbol{
     enum boolean isEntry; /* marks whether the symbol is an entry */
     enum boolean isExternal; /* marks whether the symbol is an external variable */
     Usage *usage; /* stores addresses of usage for .extern symbols */
+    Usage *lastUsage; /* the last usage of a .extern symbol, after which the next one is added */
 };
 
 typedef struct Symbol Symbol;
 
+/* a struct that represents the symbols defined before data storing instructions, in the order they were defined - which
+ * is the order of their addresses - a growable array of pointers to the symbols */
+struct SymbolList{
+    Symbol **symbols; /* the symbols, owned by the symbols table */
+    unsigned int size; /* the amount of symbols in the list */
+    unsigned int capacity; /* the amount of symbols allocated */
+};
+
+typedef struct SymbolList SymbolList;
+
+/* a token read in place from a line of the source file - a view of its chars, which are not terminated */
+struct Token{
+    char *start; /* the first char of the token */
+    int length; /* the amount of chars in the token */
+};
+
+typedef struct Token Token;
+
+/* the types of the tokens of a line, as the lexer classifies them */
+enum token_type {TOKEN_EMPTY, TOKEN_LABEL, TOKEN_MNEMONIC, TOKEN_DIRECTIVE, TOKEN_REGISTER, TOKEN_IMMEDIATE,
+                 TOKEN_RELATIVE, TOKEN_SYMBOL, TOKEN_SCALAR, TOKEN_STRING, TOKEN_COMMA, TOKEN_OTHER};
+
+/* a token together with its type and what was learned about it while it was read */
+struct Lexeme{
+    Token token; /* the chars of the token */
+    enum token_type type; /* the type of the token, by its first char and its shape */
+    enum boolean legal; /* marks whether the token is valid as its type - a legal label or symbol, scalar, etc. */
+    enum boolean reserved; /* marks whether the token is the name of a command, a directive or a register */
+    enum boolean spaced; /* marks whether the token has a space between two words */
+    int keyword; /* the index of the command or directive the token names (without the dot), or -1 */
+    int value; /* the value of a scalar, an immediate or a register */
+};
+
+typedef struct Lexeme Lexeme;
+
 /* an enum for the ARE property of binary code nodes */
 enum ARE{A='A', R='R', E='E'};
 
-/* a struct that represents a node in a list of binary codes */
+/* a machine word. Only the lowest WORD_SIZE bits are used */
+typedef uint16_t Word;
+
+/* a struct that represents a word in an image of binary codes */
 struct BinCodeNode{
-    struct BinCodeNode *next; /* the next node */
-    char *code; /* the string that represents the binary code - the word value */
+    Word code; /* the binary code - the word value */
     unsigned int IC; /* the instruction counter value of the command */
     unsigned int L; /* the amount of words the command takes, or line number in case of an argument */
     enum ARE are; /* the A,R,E attribute */
 };
 
-typedef struct BinCodeNode BinCodeNode;
\ No newline at end of file
+typedef struct BinCodeNode BinCodeNode;
+
+/* a struct that represents the "code image" or the "data image" - a growable array of words, in the order of their addresses */
+struct Image{
+    BinCodeNode *words; /* the words of the image */
+    unsigned int size; /* the amount of words in the image */
+    unsigned int capacity; /* the amount of words allocated */
+};
+
+typedef struct Image Image;
+
+/* a struct that represents a word of the code image that refers to a symbol, and is encoded only after the first scan */
+struct Fixup{
+    unsigned int index; /* the index of the word in the code image */
+    char *symbol; /* the name of the symbol the word refers to */
+    enum boolean isRelative; /* marks whether the symbol is referred to with the relative addressing method */
+    unsigned int line; /* the line number of the reference */
+    unsigned int column; /* the column of the argument in the line */
+};
+
+typedef struct Fixup Fixup;
+
+/* a struct that represents the fix-up table - a growable array of the unresolved references, in the order of the code image */
+struct FixupList{
+    Fixup *fixups; /* the references */
+    unsigned int size; /* the amount of references in the table */
+    unsigned int capacity; /* the amount of references allocated */
+};
+
+typedef struct FixupList FixupList;
+
+/* a struct that represents a .entry instruction, which is applied only after the whole file was read */
+struct EntryRef{
+    char *symbol; /* the name of the symbol declared as an entry */
+    unsigned int line; /* the line number of the instruction */
+    unsigned int column; /* the column of the name of the symbol in the line */
+    enum boolean hasExtraText; /* marks whether unrecognized text follows the name of the symbol */
+};
+
+typedef struct EntryRef EntryRef;
+
+/* a struct that represents the .entry instructions of a file, in the order they were written */
+struct EntryList{
+    EntryRef *entries; /* the .entry instructions */
+    unsigned int size; /* the amount of instructions in the list */
+    unsigned int capacity; /* the amount of instructions allocated */
+};
+
+typedef struct EntryList EntryList;
+
+/* a struct that represents a line of the source file, recorded for the listing file while the file is scanned */
+struct SourceLine{
+    char *start; /* the first char of the line, in the source file */
+    unsigned int length; /* the amount of chars in the line, including its '\n' */
+    unsigned int code; /* the index in the code image of the first word of the line, if it has any */
+    unsigned int data; /* the index in the data image of the first word of the line, if it has any */
+    unsigned int number; /* the line number - the lines of a macro have the line numbers of its definition */
+    enum boolean isListedOnly; /* marks a line of the definition or the call of a macro, which has no words */
+};
+
+typedef struct SourceLine SourceLine;
+
+/* a struct that represents the lines of a source file, in their order - a growable array */
+struct LineList{
+    SourceLine *lines; /* the lines */
+    unsigned int size; /* the amount of lines in the list */
+    unsigned int capacity; /* the amount of lines allocated */
+};
+
+typedef struct LineList LineList;
+
+#endif
\ No newline at end of file
@@ -0,0 +1,188 @@
+#include "imageTools.h"
+#include "assemblyStats.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Input: an image.
+ * Output: returns a pointer to the new word, with all its properties reset. If memory allocation failed, NULL is returned.
+ *
+ * Algorithm: if the image is full, double the amount of words allocated for it (or allocate the initial capacity for
+ * an empty image), and return NULL if the reallocation failed. Then, reset the next free word, update the size of the
+ * image and return the word.
+ */
+BinCodeNode *add_word(Image *image){
+    BinCodeNode *word;
+
+    if (image->size == image->capacity){ /* ensure there is room for another word */
+        unsigned int capacity = (image->capacity == 0) ? IMAGE_INITIAL_CAPACITY : image->capacity * 2;
+        BinCodeNode *words = (BinCodeNode *)counted_realloc(image->words, sizeof(BinCodeNode) * image->capacity,
+                                                             sizeof(BinCodeNode) * capacity);
+        RETURN_IF_MEMORY_ALLOC_ERROR(words, NULL)
+
+        image->words = words;
+        image->capacity = capacity;
+    }
+
+    word = &image->words[image->size++]; /* take the next free word */
+    memset(word, 0, sizeof(BinCodeNode)); /* reset its properties */
+
+    return word;
+}
+
+/* Input: an image.
+ * Output: returns nothing. Frees all the memory used by the image.
+ *
+ * Algorithm: free the array of words and reset the image.
+ */
+void free_image(Image *image){
+    free(image->words);
+    memset(image, 0, sizeof(Image)); /* mark the image as empty */
+}
+
+/* Input: the fix-up table.
+ * Output: returns a pointer to the new reference, with all its properties reset. If memory allocation failed, NULL is
+ * returned.
+ *
+ * Algorithm: if the table is full, double the amount of references allocated for it (or allocate the initial capacity
+ * of an image for an empty table), and return NULL if the reallocation failed. Then, reset the next free reference,
+ * update the size of the table and return the reference.
+ */
+Fixup *add_fixup(FixupList *list){
+    Fixup *fixup;
+
+    if (list->size == list->capacity){ /* ensure there is room for another reference */
+        unsigned int capacity = (list->capacity == 0) ? IMAGE_INITIAL_CAPACITY : list->capacity * 2;
+        Fixup *fixups = (Fixup *)counted_realloc(list->fixups, sizeof(Fixup) * list->capacity,
+                                                 sizeof(Fixup) * capacity);
+        RETURN_IF_MEMORY_ALLOC_ERROR(fixups, NULL)
+
+        list->fixups = fixups;
+        list->capacity = capacity;
+    }
+
+    fixup = &list->fixups[list->size++]; /* take the next free reference */
+    memset(fixup, 0, sizeof(Fixup)); /* reset its properties */
+
+    return fixup;
+}
+
+/* Input: the fix-up table.
+ * Output: returns nothing. Frees all the memory used by the table.
+ *
+ * Algorithm: free the array and reset the table. The names of the symbols belong to the arena of the file.
+ */
+void free_fixups(FixupList *list){
+    free(list->fixups);
+    memset(list, 0, sizeof(FixupList)); /* mark the table as empty */
+}
+
+/* Input: the list of .entry instructions, the name of the symbol as a token, the line number of the instruction and
+ * the arena of the file.
+ * Output: returns a pointer to the new instruction. If memory allocation failed, NULL is returned.
+ *
+ * Algorithm: if the list is full, double the amount of instructions allocated for it (or allocate the initial capacity
+ * of an image for an empty list), and return NULL if the reallocation failed. Then, copy the name out of the line into
+ * the arena and fill the next free instruction. Update the size of the list only when all succeeded, and return the instruction.
+ */
+EntryRef *add_entry_ref(EntryList *list, Token symbol, unsigned int line, Arena *arena){
+    EntryRef *entry;
+
+    if (list->size == list->capacity){ /* ensure there is room for another instruction */
+        unsigned int capacity = (list->capacity == 0) ? IMAGE_INITIAL_CAPACITY : list->capacity * 2;
+        EntryRef *entries = (EntryRef *)counted_realloc(list->entries, sizeof(EntryRef) * list->capacity,
+                                                        sizeof(EntryRef) * capacity);
+        RETURN_IF_MEMORY_ALLOC_ERROR(entries, NULL)
+
+        list->entries = entries;
+        list->capacity = capacity;
+    }
+
+    entry = &list->entries[list->size]; /* take the next free instruction */
+    entry->symbol = arena_copy_string(arena, symbol.start, symbol.length); /* copy the name out of the line */
+    RETURN_IF_MEMORY_ALLOC_ERROR(entry->symbol, NULL)
+
+    entry->line = line;
+    entry->column = 0;
+    entry->hasExtraText = false;
+    list->size++;
+
+    return entry;
+}
+
+/* Input: the list of .entry instructions.
+ * Output: returns nothing. Frees all the memory used by the list.
+ *
+ * Algorithm: free the array and reset the list. The names of the symbols belong to the arena of the file.
+ */
+void free_entry_refs(EntryList *list){
+    free(list->entries);
+    memset(list, 0, sizeof(EntryList)); /* mark the list as empty */
+}
+
+/* Input: a list of symbols and a symbol.
+ * Output: returns a pointer to the place of the symbol in the list. If memory allocation failed, NULL is returned.
+ *
+ * Algorithm: if the list is full, double the amount of symbols allocated for it (or allocate the initial capacity of
+ * an image for an empty list), and return NULL if the reallocation failed. Then, put the symbol in the next free place.
+ */
+Symbol **add_symbol(SymbolList *list, Symbol *symbol){
+    if (list->size == list->capacity){ /* ensure there is room for another symbol */
+        unsigned int capacity = (list->capacity == 0) ? IMAGE_INITIAL_CAPACITY : list->capacity * 2;
+        Symbol **symbols = (Symbol **)counted_realloc(list->symbols, sizeof(Symbol *) * list->capacity,
+                                                       sizeof(Symbol *) * capacity);
+        RETURN_IF_MEMORY_ALLOC_ERROR(symbols, NULL)
+
+        list->symbols = symbols;
+        list->capacity = capacity;
+    }
+
+    list->symbols[list->size] = symbol;
+
+    return &list->symbols[list->size++];
+}
+
+/* Input: a list of symbols.
+ * Output: returns nothing. Frees all the memory used by the list.
+ *
+ * Algorithm: free the array and reset the list. The symbols belong to the arena of the file.
+ */
+void free_symbol_list(SymbolList *list){
+    free(list->symbols);
+    memset(list, 0, sizeof(SymbolList)); /* mark the list as empty */
+}
+
+/* Input: the lines of a source file.
+ * Output: returns a pointer to the new line, with all its properties reset. If memory allocation failed, NULL is
+ * returned.
+ *
+ * Algorithm: if the list is full, double the amount of lines allocated for it (or allocate the initial capacity of an
+ * image for an empty list), and return NULL if the reallocation failed. Then, reset the next free line and return it.
+ */
+SourceLine *add_source_line(LineList *list){
+    SourceLine *line;
+
+    if (list->size == list->capacity){ /* ensure there is room for another line */
+        unsigned int capacity = (list->capacity == 0) ? IMAGE_INITIAL_CAPACITY : list->capacity * 2;
+        SourceLine *lines = (SourceLine *)counted_realloc(list->lines, sizeof(SourceLine) * list->capacity,
+                                                          sizeof(SourceLine) * capacity);
+        RETURN_IF_MEMORY_ALLOC_ERROR(lines, NULL)
+
+        list->lines = lines;
+        list->capacity = capacity;
+    }
+
+    line = &list->lines[list->size++]; /* take the next free line */
+    memset(line, 0, sizeof(SourceLine)); /* reset its properties */
+
+    return line;
+}
+
+/* Input: the lines of a source file.
+ * Output: returns nothing. Frees all the memory used by the list.
+ *
+ * Algorithm: free the array and reset the list. The chars of the lines belong to the source file.
+ */
+void free_source_lines(LineList *list){
+    free(list->lines);
+    memset(list, 0, sizeof(LineList)); /* mark the list as empty */
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+#include "generals.h"
+#include "arena.h"
+
+/* the amount of words allocated for an image on its first insertion */
+#define IMAGE_INITIAL_CAPACITY 256
+
+/* Input: an image.
+ * Output: returns a pointer to the new word, with all its properties reset. If memory allocation failed, NULL is returned.
+ *
+ * This function adds a word at the end of the received image, and returns it. The returned pointer is valid until
+ * the next word is added to the image.
+ */
+BinCodeNode *add_word(Image *image);
+
+/* Input: an image.
+ * Output: returns nothing. Frees all the memory used by the image.
+ *
+ * This function receives an image and frees the dynamically-allocated memory it uses. The image is left empty.
+ */
+void free_image(Image *image);
+
+/* Input: the fix-up table.
+ * Output: returns a pointer to the new reference, with all its properties reset. If memory allocation failed, NULL is
+ * returned.
+ *
+ * This function adds a reference at the end of the fix-up table, and returns it. The returned pointer is valid until
+ * the next reference is added to the table.
+ */
+Fixup *add_fixup(FixupList *list);
+
+/* Input: the fix-up table.
+ * Output: returns nothing. Frees all the memory used by the table.
+ *
+ * This function receives a fix-up table and frees the dynamically-allocated memory it uses - the names of the symbols
+ * belong to the arena of the file. The table is left empty.
+ */
+void free_fixups(FixupList *list);
+
+/* Input: the list of .entry instructions, the name of the symbol as a token, the line number of the instruction and
+ * the arena of the file.
+ * Output: returns a pointer to the new instruction. If memory allocation failed, NULL is returned.
+ *
+ * This function adds a .entry instruction at the end of the list, with a copy of the received name allocated out of
+ * the arena, and returns it. The returned pointer is valid until the next instruction is added to the list.
+ */
+EntryRef *add_entry_ref(EntryList *list, Token symbol, unsigned int line, Arena *arena);
+
+/* Input: the list of .entry instructions.
+ * Output: returns nothing. Frees all the memory used by the list.
+ *
+ * This function receives a list of .entry instructions and frees the dynamically-allocated memory it uses - the names
+ * of the symbols belong to the arena of the file. The list is left empty.
+ */
+void free_entry_refs(EntryList *list);
+
+/* Input: a list of symbols and a symbol.
+ * Output: returns a pointer to the place of the symbol in the list. If memory allocation failed, NULL is returned.
+ *
+ * This function adds the received symbol at the end of the list. The returned pointer is valid until the next symbol
+ * is added to the list.
+ */
+Symbol **add_symbol(SymbolList *list, Symbol *symbol);
+
+/* Input: a list of symbols.
+ * Output: returns nothing. Frees all the memory used by the list.
+ *
+ * This function frees the array of the list - the symbols belong to the arena of the file. The list is left empty.
+ */
+void free_symbol_list(SymbolList *list);
+
+/* Input: the lines of a source file.
+ * Output: returns a pointer to the new line, with all its properties reset. If memory allocation failed, NULL is
+ * returned.
+ *
+ * This function adds a line at the end of the received list, and returns it. The returned pointer is valid until the
+ * next line is added to the list.
+ */
+SourceLine *add_source_line(LineList *list);
+
+/* Input: the lines of a source file.
+ * Output: returns nothing. Frees all the memory used by the list.
+ *
+ * This function receives a list of lines and frees the dynamically-allocated memory it uses - the chars of the lines
+ * belong to the source file. The list is left empty.
+ */
+void free_source_lines(LineList *list);
\ No newline at end of file
@@ -3,24 +3,89 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
-
-
-/* Input: a string representing a line of the assembly file
+#include <limits.h>
+
+/* the class of a char - the CHAR_ bits of the table below */
+#define CHAR_CLASS(c) (char_classes[(unsigned char)(c)])
+
+/* short names of the classes, for the table */
+#define SP CHAR_SPACE
+#define LT CHAR_LETTER
+#define DG CHAR_DIGIT
+#define SG CHAR_SIGN
+#define CL CHAR_COLON
+#define CM CHAR_COMMA
+#define QT CHAR_QUOTE
+#define SC CHAR_SEMICOLON
+
+/* the class of every char, as isspace, isalpha and isdigit classify them in the "C" locale, and the punctuation the
+ * lexer stops at. It is never written to, so all the threads share it */
+static const unsigned char char_classes[UCHAR_MAX + 1] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, SP, SP, SP, SP, SP, 0, 0, /* '\t' to '\r' */
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    SP, 0, QT, 0, 0, 0, 0, 0, 0, 0, 0, SG, CM, SG, 0, 0, /* ' ' to '/' */
+    DG, DG, DG, DG, DG, DG, DG, DG, DG, DG, CL, SC, 0, 0, 0, 0, /* '0' to '?' */
+    0, LT, LT, LT, LT, LT, LT, LT, LT, LT, LT, LT, LT, LT, LT, LT, /* '@' to 'O' */
+    LT, LT, LT, LT, LT, LT, LT, LT, LT, LT, LT, 0, 0, 0, 0, 0, /* 'P' to '_' */
+    0, LT, LT, LT, LT, LT, LT, LT, LT, LT, LT, LT, LT, LT, LT, LT, /* '`' to 'o' */
+    LT, LT, LT, LT, LT, LT, LT, LT, LT, LT, LT, 0, 0, 0, 0, 0, /* 'p' to DEL */
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, /* the chars above 127 are in no class */
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+#undef SP
+#undef LT
+#undef DG
+#undef SG
+#undef CL
+#undef CM
+#undef QT
+#undef SC
+
+/* the states of reading a scalar: before it, after its sign, in its digits, in the spaces after it, in a scalar that
+ * began with a space (legal only if it is all spaces) and in an illegal one */
+enum scalar_state {SCALAR_START, SCALAR_SIGN, SCALAR_DIGITS, SCALAR_SPACES, SCALAR_BLANK, SCALAR_BAD};
+
+/* the kind of a char, as the states of a scalar see it: a space, a sign, a digit or any other char */
+#define SCALAR_KIND(class) (((class) & CHAR_SPACE) ? 0 : ((class) & CHAR_SIGN) ? 1 : ((class) & CHAR_DIGIT) ? 2 : 3)
+
+/* the next state of a scalar, by its current state and the kind of the next char */
+static const unsigned char scalar_moves[SCALAR_BAD + 1][4] = {
+    {SCALAR_BLANK, SCALAR_SIGN, SCALAR_DIGITS, SCALAR_BAD}, /* SCALAR_START */
+    {SCALAR_SPACES, SCALAR_BAD, SCALAR_DIGITS, SCALAR_BAD}, /* SCALAR_SIGN */
+    {SCALAR_SPACES, SCALAR_BAD, SCALAR_DIGITS, SCALAR_BAD}, /* SCALAR_DIGITS */
+    {SCALAR_SPACES, SCALAR_BAD, SCALAR_BAD, SCALAR_BAD}, /* SCALAR_SPACES */
+    {SCALAR_BLANK, SCALAR_BAD, SCALAR_BAD, SCALAR_BAD}, /* SCALAR_BLANK */
+    {SCALAR_BAD, SCALAR_BAD, SCALAR_BAD, SCALAR_BAD} /* SCALAR_BAD */
+};
+
+/* marks whether a scalar that ended in a state is legal */
+#define SCALAR_LEGAL(state) ((state) == SCALAR_DIGITS || (state) == SCALAR_SPACES || (state) == SCALAR_BLANK)
+
+/* Input: the start and the end of a line of the assembly file
  * Output: returns 1 if the line contains white spaces only or is a comment line, 0 otherwise
  *
- * Algorithm: iterate through the whole string. In each iteration:
+ * Algorithm: iterate through the whole line. In each iteration:
  *              1. check if a ; encountered. If so, its a comment line so we return 1
  *              2. check if the char is not a space - if its neither a ; nor a space, we should return false
  *              3. increase line to continue check the rest
  */
-int is_empty_or_comment_line(char *line){
-    while (*line != '\0'){ /* scan the whole string */
-        if (*line == ';'){ /* if the first non-space char is a ;, it is a comment line so we return 1 "true" */
+int is_empty_or_comment_line(char *line, char *line_end){
+    while (line < line_end){ /* scan the whole line */
+        unsigned int class = CHAR_CLASS(*line++);
+
+        if (class & CHAR_SEMICOLON){ /* if the first non-space char is a ;, it is a comment line so we return 1 "true" */
             return 1;
         }
 
         /* if we encountered a char that isn't a ; nor a space, it is not an empty/comment line, return 0 "false" */
-        if (!isspace(*line++)){
+        if (!(class & CHAR_SPACE)){
             return 0;
         }
     }
@@ -28,284 +93,301 @@ int is_empty_or_comment_line(char *line){
     return 1; /* if we arrived here, it means all the chars are white spaces so we return 1 "true" */
 }
 
-/* Input: receives 2 strings, one representing a line of text, and the other is a destination string
- * Output: returns the amount of chars read.
- *         Extracts the next token (from the first no-space char until a char in {delims} is reached) and stores it in the destination string
+/* Input: the first char of a token, which is a part of it, the end of the line, the classes the token ends at and a
+ * destination lexeme.
+ * Output: returns a pointer to the char after the token. Sets the lexeme to the token, classified.
  *
- * Algorithm: iterate through line until its end (or until we manually break out of the loop), in each iteration increment the amount of chars read.
- * Skip all the spaces until the token is reached. Then, until a char in {delims} was encountered (in this case we manually break),
- * copy the chars we read to the destination string.
- * */
-int get_token(char *line, char *dest, char *delims){
-    int read_chars = 0; /* counter for amount of characters read */
-    int reached_token = (isspace(line[0])) ? 0 : 1; /* states whether we have reached the token yet */
-    int i; /* used in the for loop */
-
-    for (i = 0; line[i] != '\0'; ++i) { /* scan the line until its end */
-        read_chars++; /* update amount of characters read */
-        if (reached_token == 0){ /* if we haven't reached the command yet */
-            if (isspace(line[i])){ /* continue if the current char is a white space */
-                continue;
-            } else{ /* if we reached the first char of the token */
-                *dest++ = line[i]; /* copy the first char to the destination string */
-                reached_token = 1; /* mark that the token was reached */
-            }
-        } else{ /* this means we have already reached the token */
-            if (is_char_in_delims(line[i], delims)){ /* exit the loop if a delimiter was encountered */
-                break;
-            }
-            *dest++ = line[i]; /* if the token isn't finished yet, copy the current char to the destination string */
-        }
+ * Algorithm: read the chars of the token until a char of one of the classes or the end of the line, and learn about
+ * the token on the way, out of the class of every char: whether it is a word - a letter followed by letters and
+ * digits - whether it has a space between two words, and the state and value of the scalar it holds. The scalar
+ * begins after the # of an immediate or the r of a register (or of a relative reference to a register), so its state
+ * tells if the rest of the token is a legal scalar. Once the token was read, its first char and what was learned give
+ * its type: # is an immediate, % a relative reference, . a directive if a directive is named after it, r followed by
+ * a scalar in the range of the registers a register, a command name a mnemonic, a word a symbol, " a string, a comma a
+ * comma, and a legal scalar a scalar. Only a token that begins with a letter is looked up among the keywords, with a
+ * single comparison.
+ */
+static char *lex_chars(char *p, char *line_end, unsigned int delims, Lexeme *dest){
+    char *start = p; /* the first char of the token */
+    char *scalar = p; /* the first char of the scalar of the token */
+    unsigned int class = CHAR_CLASS(*p);
+    unsigned int state = SCALAR_START; /* the state of the scalar */
+    unsigned long value = 0, limit = (unsigned long)LONG_MAX; /* the value of the scalar, saturated as token_to_int does */
+    int negative = 0, space = 0, spaced = 0;
+    int word = (class & CHAR_LETTER) != 0; /* marks whether the token is a word so far */
+    int symbol; /* marks whether the token is a legal symbol */
+    Token rest;
+
+    if (*p == '#' || *p == 'r'){
+        scalar = p + 1; /* the scalar of an immediate or a register */
+    } else if (*p == '%' && p + 1 < line_end && p[1] == 'r'){
+        scalar = p + 2; /* a relative reference to a register */
     }
 
-    *dest++ = '\0'; /* mark the end of the string */
-    return read_chars - 1; /* return the amount of chars read, minus 1 to show the delimiter */
-}
+    while (1){
+        if (p >= scalar && state != SCALAR_BAD){
+            state = scalar_moves[state][SCALAR_KIND(class)];
 
-/* Input: receive a char an a string.
- * Output: returns 1 if c is in delims, 0 otherwise.
- *
- * Algorithm: iterate through the provided string. For each char, check if it is equal to c, and if so return 1 ("true").
- * If the current char is a space, check c with isspace. If the for loop is done, it means we checked to whole string
- * and c isn't in delims so we return 0 ("false")
- */
-int is_char_in_delims(char c, char *delims){
-    int i; /* used for the for loop */
+            if (class & CHAR_DIGIT){ /* accumulate the value, as token_to_int does */
+                unsigned long digit = *p - '0';
 
-    for (i = 0; delims[i] != '\0'; ++i) { /* iterate through the string */
-        if (delims[i] == ' '){ /* check if the current char in delims is a space */
-            if (isspace(c)){ /* check if c is any white space using isspace */
-                return 1; /* return 1 ("true") if c is a space and space is in delims */
+                value = (value > (limit - digit) / 10) ? limit : value * 10 + digit;
+            } else if (state == SCALAR_SIGN){
+                negative = (*p == '-');
+                limit = negative ? (unsigned long)LONG_MAX + 1 : (unsigned long)LONG_MAX;
             }
-        } else if (c == delims[i]){ /* check if c is identical to the current char in delims */
-            return 1; /* return 1 ("true") if c is in delims */
+        }
+
+        if (class & CHAR_SPACE){ /* a space, which is between two words if another word follows it */
+            space = 1;
+        } else if (space){
+            spaced = 1;
+        }
+
+        if (p > start && !(class & (CHAR_LETTER | CHAR_DIGIT))){
+            word = 0;
+        }
+
+        if (++p >= line_end || ((class = CHAR_CLASS(*p)) & delims)){
+            break;
         }
     }
 
-    return 0; /* if we arrived here, it means c isn't in delims, so we return 0 ("false") */
-}
+    dest->token.start = start;
+    dest->token.length = (int)(p - start);
+    dest->spaced = spaced ? true : false;
+    dest->value = negative ? (int)(long)(0 - value) : (int)(long)value;
+    dest->keyword = -1;
+    dest->reserved = false;
+    dest->legal = false;
+
+    if (*start == '#'){
+        dest->type = TOKEN_IMMEDIATE;
+        dest->legal = SCALAR_LEGAL(state) ? true : false;
+        return p;
+    }
 
-/* Input: receives a string that represents a symbol, and a table in which the symbol must not be.
- * Output: returns 1 if the symbol is legal, 0 otherwise.
- *
- * Algorithm: First, check whether the symbol begins with a letter. Then, iterate through the string, and verify
- * that each char is a letter or a digit only. During the loop, count the length of the string, and ensure it is at most 31.
- * Also ensure the symbol name is not in the received table (the commands table, presumably), not a register nor keyword.
- * If one of these conditions isn't fulfilled, return 0 ("false"). Otherwise, return 1 ("true").
- */
-int legal_symbol(char *symbol, Table *table){
-    int i; /* to use in the for loop */
+    if (*start == '%'){ /* the referred name must not be a keyword nor a register */
+        dest->type = TOKEN_RELATIVE;
+        rest = skip_chars(dest->token, 1);
+        dest->legal = (find_keyword(rest) < 0 && !(scalar == start + 2 && SCALAR_LEGAL(state) &&
+                       dest->value >= 0 && dest->value < NUM_OF_REGISTERS)) ? true : false;
+        return p;
+    }
 
-    if (!isalpha(symbol[0])) { /* return 0 if the symbol doesn't begin with a letter */
-        return 0;
+    if (*start == '.'){
+        dest->type = TOKEN_OTHER;
+        dest->keyword = find_keyword(skip_chars(dest->token, 1));
+        if (dest->keyword >= NUM_OF_COMMANDS){ /* the names of the commands are not directives */
+            dest->type = TOKEN_DIRECTIVE;
+            dest->legal = true;
+        } else{
+            dest->keyword = -1;
+        }
+        return p;
     }
 
-    if (is_key_word(symbol, table)){
-        return 0; /* return 0 if the symbol name is an existing command, a register or a keyword */
+    if (*start == 'r' && SCALAR_LEGAL(state) && dest->value >= 0 && dest->value < NUM_OF_REGISTERS){
+        dest->type = TOKEN_REGISTER;
+        dest->legal = true;
+        dest->reserved = true;
+        return p;
     }
 
-    /* iterate through the string, begin in the second char because we have already checked the first */
-    for (i = 1; symbol[i] != '\0'; ++i) {
-        if (!isalpha(symbol[i]) && !isdigit(symbol[i])) { /* return 0 if the symbol contains an invalid char */
-            return 0;
+    class = CHAR_CLASS(*start);
+    if (class & CHAR_LETTER){
+        dest->keyword = find_keyword(dest->token);
+        dest->reserved = (dest->keyword >= 0) ? true : false;
+        symbol = word && dest->token.length <= MAX_SYMBOL_LENGTH && !dest->reserved;
+
+        if (dest->keyword >= 0 && dest->keyword < NUM_OF_COMMANDS){
+            dest->type = TOKEN_MNEMONIC;
+            dest->legal = true;
+        } else{ /* a symbol - an illegal one if it is not a word, too long, or the name of a directive */
+            dest->type = TOKEN_SYMBOL;
+            dest->legal = symbol ? true : false;
         }
+        return p;
     }
 
-    if (i > MAX_SYMBOL_LENGTH){ /* return 0 ("false") if the symbol name is too long */
-        return 0;
+    if (class & CHAR_QUOTE){
+        dest->type = TOKEN_STRING;
+        dest->legal = true;
+    } else if (class & CHAR_COMMA){
+        dest->type = TOKEN_COMMA;
+        dest->legal = true;
+    } else if (SCALAR_LEGAL(state)){
+        dest->type = TOKEN_SCALAR;
+        dest->legal = true;
+    } else{
+        dest->type = TOKEN_OTHER;
     }
 
-    return 1; /* if we arrived here, it means all the conditions were met and the symbol is legal */
+    return p;
 }
 
-/* Input: a string.
- * Output: returns a non-zero representing the instruction value if the string is a data storing instruction, 0 otherwise.
+/* Input: the start and the end of a line of text, a destination lexeme and the classes of the delimiters.
+ * Output: returns the amount of chars read.
+ *         Sets the destination lexeme to the next token (from the first no-space char until a char of one of the
+ *         classes is reached), classified.
  *
- * Algorithm: use strcmp to check if the received string is either .string or .data, and return the corresponding value.
- * If it is neither, return 0
- */
-int is_data_store_inst(char *token){
-    /* if token is equal to either of them, strcmp will return 0, so we flip it to return a non-zero value - "true" */
-
-    /* check if the token is a .string instruction. If so, return STRING_INST */
-    if (strcmp(token, ".string") == 0){
-        return STRING_INST;
+ * Algorithm: skip the spaces until the token is reached. The first char of the token is a part of it even if it is a
+ * delimiter - unless it is the first char of the line. Read the token with lex_chars, which classifies it while it is
+ * read, and count the chars read until the delimiter - not counting the last char of the line if no delimiter was
+ * reached. A token followed by a colon, when a colon is a delimiter, is a label: a legal one if its name is a legal
+ * symbol.
+ * */
+int lex_token(char *line, char *line_end, Lexeme *dest, unsigned int delims){
+    char *p = line, *end;
+    int read_chars;
+
+    for (; p < line_end && (CHAR_CLASS(*p) & CHAR_SPACE); p++); /* skip the spaces */
+
+    if (p >= line_end || (p == line && (CHAR_CLASS(*p) & delims))){ /* the token is empty */
+        dest->token.start = line;
+        dest->token.length = 0;
+        dest->type = TOKEN_EMPTY;
+        dest->legal = false;
+        dest->reserved = false;
+        dest->spaced = false;
+        dest->keyword = -1;
+        dest->value = 0;
+        end = p;
+    } else{
+        end = lex_chars(p, line_end, delims, dest);
     }
 
-    /* check if the token is a .data instruction. If so, return DATA_INST */
-    if (strcmp(token, ".data") == 0){
-        return DATA_INST;
+    read_chars = (int)(end - line) - (end >= line_end); /* the delimiter, or the last char of the line */
+
+    if ((delims & CHAR_COLON) && read_chars >= 0 && line[read_chars] == ':'){
+        dest->legal = (dest->type == TOKEN_SYMBOL && dest->legal) ? true : false; /* its name must be a legal symbol */
+        dest->type = TOKEN_LABEL;
     }
 
-    return 0; /* if we arrived here, it means the token isn't a dta storing one, so we return 0 */
+    return read_chars;
 }
 
-/* Input: a string representing an argument.
- * Output: the enum value representing the address method.
+/* Input: the start and the end of a line of text, a destination token and the classes of the delimiters.
+ * Output: returns the amount of chars read.
+ *         Sets the destination token to the next token (from the first no-space char until a char of one of the
+ *         classes is reached).
  *
- * Algorithm: if the first char in the string is a #, it means an immediate addressing method. If it is %, it means a
- * relative addressing method. Then, check if the string might represent a register, and if so it is an immediate register
- * addressing method. If non of the above conditions were met, the addressing method is direct - a symbol.
- */
-enum addr_method get_addressing_method(char *arg){
-    if (arg[0] == '#'){
-        return IMMEDIATE; /* if the argument begins with a #, it is an Immediate addressing */
-    } else if (arg[0] == '%'){
-        return RELATIVE; /* if the argument begins with a %, it is a Relative addressing */
-    }
+ * Algorithm: read the token with lex_token, and keep only its chars.
+ * */
+int get_token(char *line, char *line_end, Token *dest, unsigned int delims){
+    Lexeme lexeme;
+    int read_chars = lex_token(line, line_end, &lexeme, delims);
 
-    if (is_register(arg)){ /* check if it is a possible register */
-        return IMD_REGISTER;
-    }
+    *dest = lexeme.token;
 
-    return DIRECT; /* if we reached here, it means the addressing method is Direct - the argument is a symbol */
+    return read_chars;
 }
 
-/* Input: receives a string that represents a scalar.
- * Output: returns 0 if the scalar isn't a valid one, returns 1 otherwise.
+/* Input: a token and a string.
+ * Output: returns 1 if the token is made of the same chars as the string, 0 otherwise.
  *
- * Algorithm: skip all white spaces. Decrement ind by one because the spaces check may have skipped the first important char.
- * Check if the scalar is introduced by a sign, and if so continue to the next char. Then ensure the scalar is not empty,
- * and until the end of the string is reached, we ensure it is a valid scalar: only digits.
- * If we encountered a char that isn't a digit, return 0. If the loop has ended, we return 1 because it means the scalar is valid
+ * Algorithm: the token must have the same length as the string, and the same chars.
  */
-int legal_scalar(char *scalar){
-    int ind = 0; /* current index to read from scalar */
-    int scalar_done = 0; /* marks whether a space was encountered after the scalar */
-
-    for (; isspace(scalar[ind]); ind++); /* skip spaces */
-    ind = (ind > 0) ? ind - 1 : ind; /* the for loop has skipped the first "important" char only if there were spaces, so we decrease ind to re-read it if necessary */
-
-    if (scalar[ind] == '-' || scalar[ind] == '+'){
-        ind++; /* skip the sign if it exists */
-    }
+int token_equals(Token token, char *str){
+    return strlen(str) == (size_t)token.length && strncmp(token.start, str, token.length) == 0;
+}
 
-    if (scalar[ind] == '\0'){
-        return 0; /* an empty scalar is not legal */
+/* Input: a token and an amount of chars.
+ * Output: returns the rest of the token, after the received amount of chars.
+ *
+ * Algorithm: advance the start of the token, and shorten it by the same amount - but never beyond its end.
+ */
+Token skip_chars(Token token, int amount){
+    if (amount > token.length){ /* don't skip beyond the end of the token */
+        amount = token.length;
     }
 
-    while (scalar[ind] != '\0'){ /* check every character of the string */
-        /* if the current character is not a number neither a space, and is not done yet (space wasn't reached), the scalar is invalid so we return 0 */
-        if (!isdigit(scalar[ind]) && scalar_done == 0 && !isspace(scalar[ind])){
-            return 0;
-        } else if (isspace(scalar[ind])){
-            scalar_done = 1; /* mark that the scalar is finished */
-        } else if (scalar_done == 1){ /* if a digit was encountered after the scalar is already done, it isn't a valid scalar */
-            return 0;
-        }
-
-        ind++; /* increment ind to continue to check the next character */
-    }
+    token.start += amount;
+    token.length -= amount;
 
-    return 1; /* if we arrived here, it means the scalar is legal so we return 1 */
+    return token;
 }
 
-/* Input: the argument as a string, its addressing method and the commands table.
- * Output: returns 1 if the argument is valid, 0 otherwise.
+/* Input: a token.
+ * Output: returns the integer the token begins with, or 0 if it doesn't begin with one.
  *
- * Algorithm: if the argument is a scalar (immediate addressing method) return whether it is a valid one. If it is a register,
- * ensure it is in the valid range: 0 to 7 (in our computer). If it is a relative or direct addressing method, ensure that
- * the symbol name is valid: not a command nor a keyword in the assembly language
+ * Algorithm: do as atoi() does - skip the leading spaces, read an optional sign and then all the digits that follow it.
+ * The value saturates at the range of a long, as the strtol() behind atoi() does, and is then converted to an int.
  */
-int legal_arg(char *arg, enum addr_method method, Table *commands_table){
-    if (method == IMMEDIATE){ /* if the addressing method is immediate */
-        return legal_scalar(arg+1); /* return whether the scalar is valid */
-    }
+int token_to_int(Token token){
+    int i = 0, negative = 0;
+    unsigned long value = 0, limit;
 
-    if (method == IMD_REGISTER){ /* if the addressing method is immediate register */
-        int num = atoi(arg+1); /* get the number of the register */
+    for (; i < token.length && isspace(token.start[i]); i++); /* skip spaces */
 
-        if (num >= 0 && num < NUM_OF_REGISTERS){ /* if the register is valid, return 1 */
-            return 1;
-        } else { /* if the register isn't valid, return 0 */
-            return 0;
-        }
+    if (i < token.length && (token.start[i] == '-' || token.start[i] == '+')){
+        negative = (token.start[i++] == '-'); /* read the sign */
     }
 
-    if (*arg == '%'){ /* skip the % if it exists to test the label name */
-        arg++;
-    }
+    limit = negative ? (unsigned long)LONG_MAX + 1 : (unsigned long)LONG_MAX;
 
-    if (is_key_word(arg, commands_table)){ /* an existing command or keyword is not a legal argument */
-        return 0;
+    for (; i < token.length && isdigit(token.start[i]); i++){ /* read the digits */
+        unsigned long digit = token.start[i] - '0';
+
+        value = (value > (limit - digit) / 10) ? limit : value * 10 + digit;
     }
 
-    return 1; /* if we arrived here, it means the argument is legal, so we return 1 */
+    return negative ? (int)(long)(0 - value) : (int)(long)value;
 }
 
-/* Input: a string.
- * Output: returns 1 if the string represents a register, 0 otherwise.
+/* Input: receives a token that represents a symbol.
+ * Output: returns 1 if the symbol is legal, 0 otherwise.
  *
- * Algorithm: First, check if str begins with a small r. If not, return 0. Then, check if all the chars after it represent
- * a scalar. If not, return 0. If yes, get the represented number and check whether it is a valid
- * register number. If so, return 1. Else, return 0.
+ * Algorithm: classify the whole token with lex_chars - it is a legal symbol if it was classified as one: a word that
+ * begins with a letter, at most MAX_SYMBOL_LENGTH chars long, and not a command, register nor keyword.
  */
-int is_register(char *str){
-    int i; /* for the for loop */
+int legal_symbol(Token symbol){
+    Lexeme lexeme;
 
-    /* a name of a register must begin with a small r. If the received string doesn't begin with it, it isn't a register and we can return 0 */
-    if (*str != 'r'){
+    if (symbol.length == 0){
         return 0;
     }
 
-    /* check if all the chars after the r represent a valid scalar, if not - it isn't a register! */
-    if (!legal_scalar(str+1)){
-        return 0;
-    }
-
-    i = atoi(str+1);
-
-    if (i >= 0 && i < NUM_OF_REGISTERS){
-        return 1; /* if the argument was r followed by digits, it is an Immediate Register */
-    }
+    lex_chars(symbol.start, symbol.start + symbol.length, 0, &lexeme);
 
-    return 0; /* if one of the previous conditions is not met, str is not a register so we return 0 */
+    return lexeme.type == TOKEN_SYMBOL && lexeme.legal;
 }
 
-/* Input: a string.
- * Output: returns 1 if the string contains a space between 2 words, 0 otherwise.
+/* Input: an argument, as a lexeme.
+ * Output: the enum value representing the address method.
  *
- * Algorithm: check every character in the string using a for loop. For each char, check whether it is a space.
- * If so, mark it. Else, check if a space was already encountered, and if so return 1 since a non-space char was met
- * after a space. If the for loop is done without returning anything, it means the string doesn't contain a space,
- * so we return 0.
+ * Algorithm: an immediate, a relative reference and a register have addressing methods of their own. Any other
+ * argument is a symbol, so its addressing method is direct.
  */
-int is_containing_space_between_words(char *c){
-    int i; /* to be used in the for loop */
-    int space = 0; /* marks whether a space was encountered */
-
-    for (i = 0; c[i] != '\0'; i++) { /* go over the whole string */
-        if (isspace(c[i])){ /* if the current char is a space, mark it */
-            space = 1;
-        } else if (space == 1){ /* if a space was encountered, and then a non-space char, return 1 */
-            return 1;
-        }
+enum addr_method get_addressing_method(Lexeme *arg){
+    switch (arg->type){
+        case TOKEN_IMMEDIATE:
+            return IMMEDIATE;
+        case TOKEN_RELATIVE:
+            return RELATIVE;
+        case TOKEN_REGISTER:
+            return IMD_REGISTER;
+        default:
+            return DIRECT; /* the argument is a symbol */
     }
-
-    return 0; /* if no space was encountered, or had no other char after itself, we should return 1 */
 }
 
-/* Input: a string and the commands table.
- * Output: returns 1 if the string is a keyword in our assembly language, 0 otherwise.
+/* Input: an argument, as a lexeme.
+ * Output: returns 1 if the argument is valid, 0 otherwise.
  *
- * Algorithm: first, check if the string is a key in the received table. If so, return 1. Then, using strcmp, we compare
- * the received string to all of the other keywords. If it matches one of them, we return 1. Then, we check whether it
- * represents a register, and if so return 1. Else, we return 0.
+ * Algorithm: the lexer has already checked the scalar of an immediate, and the name a relative reference refers to. A
+ * register is always in the range, since it would not be classified as one otherwise. Any other argument is the name
+ * of a symbol, which must not be a command or a keyword - any other mistake in it is reported in the second scan, when
+ * the symbol is not found.
  */
-int is_key_word(char *c, Table *commands_table){
-    if (lookup(c, commands_table) != NULL){ /* return 1 if the symbol is in the commands table */
-        return 1;
-    }
-
-    /* compare the string to all of the other keywords. If it matches one of them, return 1 */
-    if (strcmp(c, "entry") == 0 || strcmp(c, "extern") == 0 || strcmp(c, "data") == 0 || strcmp(c, "string") == 0){
-        return 1;
-    }
-
-    /* check if the string represents a name of a register. If it is, return 1 */
-    if (is_register(c)){
-        return 1;
+int legal_arg(Lexeme *arg){
+    switch (arg->type){
+        case TOKEN_IMMEDIATE:
+        case TOKEN_RELATIVE:
+            return arg->legal;
+        case TOKEN_REGISTER:
+            return 1;
+        default:
+            return !arg->reserved;
     }
-
-    return 0; /* if the code arrives here, it means the string isn't a keyword so 0 is returned */
-}
\ No newline at end of file
+}
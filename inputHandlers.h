@@ -1,89 +1,87 @@
 #include "commands.h"
 
-#define ARG_SIZE 10
-
-/* Input: a string representing a line of the assembly file.
+/* Input: the start and the end of a line of the assembly file.
  * Output: returns 1 if the line contains white spaces only or is a comment line, 0 otherwise.
  *
  * This function receives a line of text, and returns 1 ("true") if its an empty line or a comment line, 0 ("false") otherwise
  */
-int is_empty_or_comment_line(char *line);
+int is_empty_or_comment_line(char *line, char *line_end);
 
-/* Input: receives 2 strings, one representing a line of text, and the other is a destination string.
- * Output: returns the amount of chars read.
- *         Extracts the next token (from the first no-space char until a char in {delims} is reached) and stores it in the destination string.
- *
- * This function receives a line of text and a destination char pointer (dest), and stores in dest the next token as explained earlier.
- * Returns the amount of chars read.
- * */
-int get_token(char *line, char *dest, char *delims);
+/* the classes of the chars, which the lexer reads the lines by. A token ends at a char of one of the classes it is
+ * read until - any white space, for CHAR_SPACE */
+#define CHAR_SPACE 1
+#define CHAR_LETTER 2
+#define CHAR_DIGIT 4
+#define CHAR_SIGN 8
+#define CHAR_COLON 16
+#define CHAR_COMMA 32
+#define CHAR_QUOTE 64
+#define CHAR_SEMICOLON 128
 
-/* Input: receive a char an a string.
- * Output: returns 1 if c is in delims, 0 otherwise.
- *
- * This function receives a char and a string and returns 1 ("true") if the char is in delims, 0 ("false") otherwise.
- * A space in delims is considered as any white tabs, checked using isspace
- */
-int is_char_in_delims(char c, char *delims);
-
-/* Input: receives a string that represents a symbol, and a table in which the symbol must not be.
- * Output: returns 1 if the symbol is legal, 0 otherwise.
+/* Input: the start and the end of a line of text, a destination lexeme and the classes of the delimiters.
+ * Output: returns the amount of chars read.
+ *         Sets the destination lexeme to the next token (from the first no-space char until a char of one of the
+ *         classes is reached), classified.
  *
- * This function receives a string and a table, and returns true if it is a legal symbol.
- * A legal symbol is at most 31 chars length, begins with a letter, not a command (not in the received table) nor register
- * or keyword, and contains letters and digits only.
+ * This function reads the next token of a line in a single pass, in place, and classifies it while it is read - as a
+ * label, a mnemonic, a directive, a register, an immediate, a relative reference, a symbol, a scalar, a string or a
+ * comma - out of a table of the classes of the chars. Whether the token is legal as its type, whether it is a keyword
+ * or has a space between two words, and the value of its scalar are learned on the way, so nothing checks its chars
+ * again. Returns the amount of chars read.
  */
-int legal_symbol(char *symbol, Table *table);
+int lex_token(char *line, char *line_end, Lexeme *dest, unsigned int delims);
 
-/* Input: a string.
- * Output: returns a non-zero value representing the instruction if the string is a data storing instruction, 0 otherwise.
+/* Input: the start and the end of a line of text, a destination token and the classes of the delimiters.
+ * Output: returns the amount of chars read.
+ *         Sets the destination token to the next token (from the first no-space char until a char of one of the
+ *         classes is reached).
  *
- * This function receives a string, and returns a non-zero value ("true") if it is a data storing instruction, and 0 ("false") otherwise
- */
-int is_data_store_inst(char *token);
+ * This function receives a line of text and a destination token (dest), and points dest at the next token as explained
+ * earlier - in place, without copying it. Returns the amount of chars read.
+ * */
+int get_token(char *line, char *line_end, Token *dest, unsigned int delims);
 
-/* Input: a string representing an argument
- * Output: the enum value representing the address method.
+/* Input: a token and a string.
+ * Output: returns 1 if the token is made of the same chars as the string, 0 otherwise.
  *
- * This function receives a string that represents an argument of a command, and returns its addressing method.
+ * This function compares a token to a string, like strcmp() compares two strings for equality.
  */
-enum addr_method get_addressing_method(char *arg);
+int token_equals(Token token, char *str);
 
-/* Input: receives a string that represents a scalar.
- * Output: returns 0 if the scalar isn't a valid one, returns 1 otherwise.
+/* Input: a token and an amount of chars.
+ * Output: returns the rest of the token, after the received amount of chars.
  *
- * This function receives a scalar as a string, and returns 1 if it stands for a valid scalar. If not, 0 is returned.
- * A valid scalar might have a sign (+ or -), and except these contains digits only.
+ * This function receives a token, and returns the token without its first chars - such as a # or a % before an argument.
  */
-int legal_scalar(char *scalar); /* receives a string that should represent a number; returns 0 if it isn't a valid number, 1 otherwise */
+Token skip_chars(Token token, int amount);
 
-/* Input: the argument as a string, its addressing method and the commands table.
- * Output: returns 1 if the argument is valid, 0 otherwise.
+/* Input: a token.
+ * Output: returns the integer the token begins with, or 0 if it doesn't begin with one.
  *
- * This function checks whether the argument is legal - if the method is IMMEDIATE, check if the scalar is legal,
- * if the method is IMD_REGISTER, check if the register is indeed available.
+ * This function converts the beginning of a token to an integer, like atoi() converts a string.
  */
-int legal_arg(char *arg, enum addr_method method, Table *commands_table);
+int token_to_int(Token token);
 
-/* Input: a string.
- * Output: returns 1 if the string represents a register, 0 otherwise.
+/* Input: receives a token that represents a symbol.
+ * Output: returns 1 if the symbol is legal, 0 otherwise.
  *
- * This function receives a string, and returns 1 if it represents a name of an available register.
- * Else, 0 is returned.
+ * This function receives a string, and returns true if it is a legal symbol.
+ * A legal symbol is at most 31 chars length, begins with a letter, not a command nor register or keyword, and contains
+ * letters and digits only.
  */
-int is_register(char *str);
+int legal_symbol(Token symbol);
 
-/* Input: a string.
- * Output: returns 1 if the string contains a space between 2 words, 0 otherwise.
+/* Input: an argument, as a lexeme.
+ * Output: the enum value representing the address method.
  *
- * This function receives a string of text and returns 1 if it contains a space between 2 words. Otherwise, 0 is returned.
+ * This function receives a lexeme that represents an argument of a command, and returns its addressing method.
  */
-int is_containing_space_between_words(char *c);
+enum addr_method get_addressing_method(Lexeme *arg);
 
-/* Input: a string and the commands table.
- * Output: returns 1 if the string is a keyword in our assembly language, 0 otherwise.
+/* Input: an argument, as a lexeme.
+ * Output: returns 1 if the argument is valid, 0 otherwise.
  *
- * This function receives a String and the commands table, and returns 1 if the string is either a command in the table
- * or other keyword in the language - entry, extern, data, string or a register name. Else, 0 is returned.
+ * This function checks whether the argument is legal - if it is an immediate, check if the scalar is legal, and if it
+ * is a symbol or a relative reference, check that it doesn't name a command, a keyword or a register.
  */
-int is_key_word(char *c, Table *commands_table);
\ No newline at end of file
+int legal_arg(Lexeme *arg);
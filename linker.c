@@ -0,0 +1,259 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "binaryObject.h"
+#include "imageTools.h"
+
+/* the option that sets the base filename of the linked program */
+#define OUTPUT_OPTION "-o"
+
+/* the base filename of the linked program, unless another one is set */
+#define DEFAULT_OUTPUT "linked"
+
+#define USAGE "Usage: linker [-o output] file1 file2....\n"
+
+/* a linker of the output files of the assembler: it reads the .ob, .ent and .ext files of every object, and links them
+ * into a single program - the code of all the objects, in the order they were given, followed by all their data. The
+ * entries of the objects are the global symbols; every usage of an external symbol is replaced with the address of
+ * the entry of the same name, and every relocatable (R) word is moved with its object. The program is written as the
+ * .ob file of the output, with a .ent file of all the global symbols - it has no externals left. A program whose
+ * addresses do not fit in a word is not written. */
+
+/* an object being linked */
+struct LinkedObject{
+    char *base; /* the base filename of the object */
+    ObjectFile object; /* the images and symbols of the object */
+    unsigned int load; /* the address of the first word of the object, as it was assembled */
+    unsigned int code_base; /* the address of the code of the object in the program */
+    unsigned int data_base; /* the address of the data of the object in the program */
+};
+
+/* a global symbol - an entry of one of the objects */
+struct GlobalSymbol{
+    unsigned int address; /* the address of the symbol in the program */
+    struct LinkedObject *object; /* the object that defines the symbol */
+};
+
+/* Input: an object, and an address in it, as it was assembled.
+ * Output: returns the address in the program.
+ *
+ * This function moves an address with its object: an address of the code image moves with the code of the object,
+ * while an address of the data image moves with its data.
+ */
+static unsigned int relocate(struct LinkedObject *linked, unsigned int address){
+    unsigned int data_start = linked->load + linked->object.code.size; /* the data follows the code */
+
+    return (address < data_start) ? linked->code_base + (address - linked->load) :
+                                    linked->data_base + (address - data_start);
+}
+
+/* Input: the objects, their amount, the table of the global symbols and the stream to write errors to.
+ * Output: returns the amount of errors.
+ *
+ * This function installs the entries of all the objects in the table, at their addresses in the program. An entry
+ * defined by more than one object is an error.
+ */
+static int install_globals(struct LinkedObject *objects, int amount, Table *globals, FILE *log){
+    struct GlobalSymbol *global;
+    cell *defined;
+    unsigned int i;
+    int errors = 0, j;
+
+    for (j = 0; j < amount; j++){
+        for (i = 0; i < objects[j].object.entries_size; i++){
+            ObjectSymbol *entry = &objects[j].object.entries[i];
+
+            if ((defined = lookup(entry->name, globals)) != NULL){
+                fprintf(log, "Error: symbol %s is an entry of both %s and %s\n", entry->name,
+                        ((struct GlobalSymbol *)defined->value)->object->base, objects[j].base);
+                errors++;
+                continue;
+            }
+
+            global = (struct GlobalSymbol *)arena_alloc(globals->arena, sizeof(struct GlobalSymbol));
+            if (global == NULL || install(entry->name, global, globals) == NULL){
+                fprintf(log, "Memory allocation failed. Terminating...\n");
+                return errors + 1;
+            }
+
+            global->address = relocate(&objects[j], entry->value);
+            global->object = &objects[j];
+        }
+    }
+
+    return errors;
+}
+
+/* Input: an object, the code and data images of the program, the table of the global symbols and the stream to write
+ * errors to.
+ * Output: returns the amount of errors.
+ *
+ * Algorithm: copy the words of the object to their place in the program, in a single pass - a relocatable word holds
+ * an address of the object, which is moved with it; the other words are copied as they are. Then, go over the usages
+ * of externals of the object, and replace every used word with the address of its global symbol, making it
+ * relocatable. A usage of a symbol no object defines, or of a word that is not external, is an error.
+ */
+static int link_object(struct LinkedObject *linked, Image *code, Image *data, Table *globals, FILE *log){
+    BinCodeNode *word, *end, *dest;
+    unsigned int i;
+    int errors = 0;
+    cell *global;
+
+    dest = &code->words[linked->code_base - CODE_LOADING_ADDRESS];
+    for (word = linked->object.code.words, end = word + linked->object.code.size; word < end; word++, dest++){
+        dest->code = (word->are == R) ? (Word)(relocate(linked, word->code) & WORD_MASK) : word->code;
+        dest->IC = (unsigned int)(dest - code->words) + CODE_LOADING_ADDRESS;
+        dest->L = 0;
+        dest->are = word->are;
+    }
+
+    dest = &data->words[linked->data_base - CODE_LOADING_ADDRESS - code->size];
+    for (word = linked->object.data.words, end = word + linked->object.data.size; word < end; word++, dest++){
+        *dest = *word; /* data words are never relocatable */
+        dest->IC = linked->data_base + (unsigned int)(word - linked->object.data.words);
+    }
+
+    for (i = 0; i < linked->object.externs_size; i++){ /* resolve the usages of externals */
+        ObjectSymbol *usage = &linked->object.externs[i];
+
+        if (usage->value < linked->load || usage->value - linked->load >= linked->object.code.size ||
+            code->words[linked->code_base - CODE_LOADING_ADDRESS + usage->value - linked->load].are != E){
+            fprintf(log, "Error in %s: %s is not used as an external at address %u\n", linked->base, usage->name,
+                    usage->value);
+            errors++;
+        } else if ((global = lookup(usage->name, globals)) == NULL){
+            fprintf(log, "Error in %s: undefined external symbol %s, used at address %u\n", linked->base, usage->name,
+                    usage->value);
+            errors++;
+        } else{
+            dest = &code->words[linked->code_base - CODE_LOADING_ADDRESS + usage->value - linked->load];
+            dest->code = (Word)(((struct GlobalSymbol *)global->value)->address & WORD_MASK);
+            dest->are = R;
+        }
+    }
+
+    return errors;
+}
+
+/* Input: the image of a program, an empty image to set, and the amount of words it should hold.
+ * Output: returns 0 if succeeded, 1 if memory allocation failed.
+ */
+static int allocate_words(Image *image, unsigned int size){
+    image->words = (BinCodeNode *)counted_malloc(sizeof(BinCodeNode) * size + 1); /* never 0 bytes */
+    image->size = image->capacity = size;
+
+    return image->words == NULL;
+}
+
+int main(int argc, char *argv[]) {
+
+    int first = 1, amount, errors = 0, i; /* first is the index of the first filename in argv */
+    char *output = DEFAULT_OUTPUT;
+    unsigned int code_size = 0, data_size = 0, unresolved, j;
+    Arena arena = {NULL, NULL}; /* the names of all the symbols, and the global symbols */
+    Table globals; /* the entries of all the objects, by their names */
+    struct LinkedObject *objects;
+    ObjectFile program; /* the linked program */
+
+    if (first + 1 < argc && strcmp(argv[first], OUTPUT_OPTION) == 0){
+        output = argv[first + 1];
+        first += 2;
+    }
+
+    if (argc - first < 1){ /* check enough arguments were provided */
+        printf("Too few arguments!\n" USAGE); /* inform the user */
+        return MISSING_ARGS_ERROR;
+    }
+
+    amount = argc - first;
+    objects = (struct LinkedObject *)calloc(amount, sizeof(struct LinkedObject));
+    RETURN_IF_MEMORY_ALLOC_ERROR(objects, MEMORY_ALLOC_ERROR)
+
+    memset(&globals, 0, sizeof(Table));
+    memset(&program, 0, sizeof(ObjectFile));
+    globals.arena = &arena;
+
+    for (i = 0; i < amount; i++){ /* read all the objects, and place their code one after the other */
+        objects[i].base = argv[first + i];
+
+        if (read_text_object(&objects[i].object, objects[i].base, &arena, stdout) != 0){
+            errors++;
+            continue;
+        }
+
+        objects[i].load = (objects[i].object.code.size > 0) ? objects[i].object.code.words[0].IC :
+                          (objects[i].object.data.size > 0) ? objects[i].object.data.words[0].IC : CODE_LOADING_ADDRESS;
+        objects[i].code_base = CODE_LOADING_ADDRESS + code_size;
+        code_size += objects[i].object.code.size;
+        data_size += objects[i].object.data.size;
+    }
+
+    for (i = 0, j = CODE_LOADING_ADDRESS + code_size; i < amount; i++){ /* place their data after all the code */
+        objects[i].data_base = j;
+        j += objects[i].object.data.size;
+    }
+
+    if (errors == 0 && CODE_LOADING_ADDRESS + code_size + data_size > WORD_MASK + 1){ /* the simulator can't load it */
+        printf("Error: the program takes %u words - addresses above %u do not fit in a word\n", code_size + data_size,
+               WORD_MASK);
+        errors++;
+    }
+
+    if (errors == 0){
+        errors += install_globals(objects, amount, &globals, stdout);
+    }
+
+    if (errors == 0 && (allocate_words(&program.code, code_size) != 0 || allocate_words(&program.data, data_size) != 0)){
+        printf("Memory allocation failed. Terminating...\n");
+        errors++;
+    }
+
+    if (errors == 0){ /* link all the objects, to report all their unresolved externals */
+        for (i = 0; i < amount; i++){
+            errors += link_object(&objects[i], &program.code, &program.data, &globals, stdout);
+        }
+    }
+
+    for (j = 0, unresolved = 0; errors == 0 && j < code_size; j++){ /* an external word without a usage */
+        unresolved += (program.code.words[j].are == E);
+    }
+
+    if (errors == 0 && unresolved > 0){
+        printf("Error: %u external words have no usage in the .ext files\n", unresolved);
+        errors++;
+    }
+
+    if (errors == 0){ /* the entries of the program are all the global symbols, in the order they were defined */
+        program.entries = (ObjectSymbol *)arena_alloc(&arena, sizeof(ObjectSymbol) * globals.count + 1);
+        program.entries_size = globals.count;
+        program.flags = (globals.count > 0) ? HAS_ENTRY_FILE : 0;
+
+        for (j = 0; program.entries != NULL && j < globals.count; j++){
+            program.entries[j].name = globals.cells[j].key;
+            program.entries[j].value = ((struct GlobalSymbol *)globals.cells[j].value)->address;
+        }
+
+        if (program.entries == NULL || write_text_object(&program, output, stdout) != 0){
+            errors++;
+        }
+    }
+
+    if (errors == 0){
+        printf("Linked %d objects into %s%s: %u code words, %u data words, %u global symbols\n", amount, output,
+               OBJ_EXTENSION, code_size, data_size, globals.count);
+    } else{
+        printf("Error linking %s\n", output);
+    }
+
+    for (i = 0; i < amount; i++){
+        free_image(&objects[i].object.code);
+        free_image(&objects[i].object.data);
+    }
+    free_image(&program.code);
+    free_image(&program.data);
+    free_table(&globals);
+    free_arena(&arena);
+    free(objects);
+
+    return errors != 0;
+}
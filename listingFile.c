@@ -0,0 +1,175 @@
+#define _POSIX_C_SOURCE 200809L /* for fdopen */
+
+#include "listingFile.h"
+#include "buildOutputFiles.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* the width of the columns of a word - its address, padded to OBJ_VALUE_PADDING digits, a space, its code, a space and
+ * its ARE */
+#define LISTING_WORD_WIDTH (OBJ_VALUE_PADDING + HEX_WORD_LENGTH + 3)
+
+/* the most chars a line of the listing file takes: the number of the line and the columns of a word - each followed by
+ * two spaces, allowing for long numbers - and the line of the source */
+#define MAX_LISTING_LINE_LENGTH (64 + MAX_LINE_LENGTH)
+
+/* Input: a destination, and the amount of spaces to write.
+ * Output: returns a pointer to the char after the spaces. Nothing is written for an amount below 1.
+ */
+static char *write_spaces(char *dest, int amount){
+    if (amount <= 0){
+        return dest;
+    }
+    memset(dest, ' ', amount);
+
+    return dest + amount;
+}
+
+/* Input: a word and a destination.
+ * Output: returns a pointer to the char after the columns of the word.
+ *
+ * Algorithm: write the word just like a line of the object file - its address, its code and its ARE - without the
+ * '\n'.
+ */
+static char *format_listed_word(BinCodeNode *word, char *dest){
+    dest = unsigned_to_decimal(word->IC, OBJ_VALUE_PADDING, dest);
+    *dest++ = ' ';
+    dest = word_to_hex(word->code, dest);
+    *dest++ = ' ';
+    *dest++ = (char)word->are;
+
+    return dest;
+}
+
+/* Input: the lines of the source file, the index of a line, and the ends of the images to set.
+ * Output: returns nothing. Sets the ends to where the words of the next line the first scan read start - they are left
+ * as they are, the ends of the images, if there is no such line.
+ *
+ * Algorithm: skip the lines of the definitions and calls of the macros, which have no words of their own.
+ */
+static void next_words(LineList *lines, unsigned int i, unsigned int *next_code, unsigned int *next_data){
+    for (i++; i < lines->size && lines->lines[i].isListedOnly; i++);
+
+    if (i < lines->size){
+        *next_code = lines->lines[i].code;
+        *next_data = lines->lines[i].data;
+    }
+}
+
+/* Input: the lines of the source file, the "code image", the "data image", the base filename and the stream to write
+ * errors to.
+ * Output: builds the listing file. Returns 0 if completed successfully, 1 otherwise.
+ *
+ * Algorithm: construct the filename and the temporary name next to it, and create the temporary file - a new one, which
+ * no other writer uses - and open a stream on it. The lines are formatted straight into a buffer of
+ * LISTING_BUFFER_SIZE chars, which is written whenever another line might not fit in it - so the file is written in a
+ * few large writes, with no call per line. For every line, find its words: a line was encoded to the words between
+ * its first word and the first word of the next line the first scan read, in either the code image or the data image.
+ * The lines of the definitions and calls of the macros have no words. Format the number of the line, its first word
+ * (or blanks, if it has none) and the line itself without its '\n'. Then, format every other word of the line in a
+ * line of its own, below the first one. Once all the lines were written, close the file and rename it to the
+ * filename. If something failed, inform the user and remove the temporary file.
+ */
+int build_listing_file(LineList *lines, Image *codeImage, Image *dataImage, char *base_filename, FILE *log){
+    size_t filename_length = strlen(base_filename) + strlen(LST_EXTENSION);
+    char *filename = (char *)counted_malloc(2 * filename_length + MAX_TEMP_SUFFIX_LENGTH + 1); /* both names, '\0's */
+    char *buffer = (char *)counted_malloc(LISTING_BUFFER_SIZE); /* the lines that were not written yet */
+    char *temp_filename, *dest, *line_start, *flush_at;
+    BinCodeNode *word, *end; /* the words of the current line */
+    unsigned int i, length;
+    FILE *fp = NULL;
+    int fd, errors = 0;
+
+    if (filename == NULL || buffer == NULL){ /* ensure memory allocation succeeded */
+        free(filename);
+        free(buffer);
+        return 1;
+    }
+
+    /* construct the filename, and the temporary name right after it */
+    strcpy(filename, base_filename);
+    strcat(filename, LST_EXTENSION);
+    temp_filename = filename + filename_length + 1;
+
+    fd = create_temp_file(filename, temp_filename);
+    if (fd >= 0 && (fp = fdopen(fd, "w")) == NULL){
+        close(fd);
+        remove(temp_filename);
+    }
+
+    if (fp == NULL){ /* ensure file created successfully */
+        fprintf(log, "Error creating listing file for %s!\n", filename);
+        free(filename);
+        free(buffer);
+        return 1;
+    }
+
+    dest = buffer;
+    flush_at = buffer + LISTING_BUFFER_SIZE - MAX_LISTING_LINE_LENGTH; /* another line might not fit after it */
+
+    for (i = 0; i < lines->size; i++){
+        SourceLine *line = &lines->lines[i];
+        unsigned int next_code = codeImage->size, next_data = dataImage->size;
+
+        word = end = NULL; /* a line of the definition or the call of a macro has no words */
+        if (!line->isListedOnly){
+            next_words(lines, i, &next_code, &next_data);
+            if (next_code > line->code){ /* a command line */
+                word = &codeImage->words[line->code];
+                end = &codeImage->words[next_code];
+            } else{ /* a data storing instruction, or a line without words */
+                word = &dataImage->words[line->data];
+                end = &dataImage->words[next_data];
+            }
+        }
+
+        length = line->length;
+        while (length > 0 && (line->start[length - 1] == '\n' || line->start[length - 1] == '\r')){
+            length--; /* the line ends with a '\n' of its own */
+        }
+
+        if (dest > flush_at){
+            fwrite(buffer, 1, dest - buffer, fp);
+            dest = buffer;
+        }
+
+        line_start = dest;
+        dest = write_spaces(dest, LISTING_LINE_NUMBER_WIDTH - decimal_length(line->number, 1));
+        dest = unsigned_to_decimal(line->number, 1, dest);
+        dest = write_spaces(dest, 2);
+        dest = (word < end) ? format_listed_word(word++, dest) : write_spaces(dest, LISTING_WORD_WIDTH);
+        dest = write_spaces(dest, 2);
+        memcpy(dest, line->start, length);
+        dest += length;
+
+        while (dest > line_start && dest[-1] == ' '){ /* a line without words nor text has nothing after its number */
+            dest--;
+        }
+        *dest++ = '\n';
+
+        for (; word < end; word++){ /* the rest of the words of the line */
+            if (dest > flush_at){
+                fwrite(buffer, 1, dest - buffer, fp);
+                dest = buffer;
+            }
+
+            dest = write_spaces(dest, LISTING_LINE_NUMBER_WIDTH + 2);
+            dest = format_listed_word(word, dest);
+            *dest++ = '\n';
+        }
+    }
+
+    fwrite(buffer, 1, dest - buffer, fp); /* the last lines */
+
+    if (ferror(fp) | (fclose(fp) != 0) || rename(temp_filename, filename) != 0){ /* ensure all the lines were written */
+        fprintf(log, "Error writing file %s!\n", filename);
+        remove(temp_filename);
+        errors = 1;
+    }
+
+    free(filename); /* free the names and the buffer */
+    free(buffer);
+
+    return errors;
+}
@@ -0,0 +1,29 @@
+#ifndef LISTING_FILE_H
+#define LISTING_FILE_H
+
+#include <stdio.h>
+#include "generals.h"
+
+#define LST_EXTENSION ".lst"
+
+/* the size of the buffer the lines of the listing file are formatted into, before they are written */
+#define LISTING_BUFFER_SIZE (1 << 16)
+
+/* the width of the line number at the start of every line of the listing file - a longer number takes more */
+#define LISTING_LINE_NUMBER_WIDTH 5
+
+/* Input: the lines of the source file, recorded by the first scan, the "code image", the "data image", the base
+ * filename and the stream to write errors to.
+ * Output: builds the listing file. Returns 0 if completed successfully, 1 otherwise.
+ *
+ * This function writes a line of the listing file for every line of the source - the definitions of the macros and
+ * their calls are listed with no words, and every call is followed by the lines of the macro, numbered as in its
+ * definition. Every line has its number, the first word it was encoded to - the address, the code in hexadecimal base
+ * and the ARE, just like in the object file - and the line itself. Every other word of the line follows in a line of
+ * its own. The lines are read out of the source file, which must still be open, and the words out of the images, so
+ * the source is not scanned again. The lines are formatted into a large buffer, written to a temporary file whenever
+ * it fills, which is renamed over the listing file once it is complete.
+ */
+int build_listing_file(LineList *lines, Image *codeImage, Image *dataImage, char *base_filename, FILE *log);
+
+#endif
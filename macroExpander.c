@@ -0,0 +1,242 @@
+#include "macroExpander.h"
+#include "inputHandlers.h" /* includes tableTools.h */
+#include "imageTools.h"
+#include <string.h>
+#include <ctype.h>
+
+/* the column of a char of a line, starting from 1 */
+#define COLUMN(p, line_start) ((unsigned int)((p) - (line_start)) + 1)
+
+/* the lengths of the keywords of the macros */
+#define MACRO_START_LENGTH ((int)sizeof(MACRO_START) - 1)
+#define MACRO_END_LENGTH ((int)sizeof(MACRO_END) - 1)
+
+/* Input: the start and the end of a line, and a token to set.
+ * Output: returns a pointer to the char after the token.
+ *
+ * Algorithm: skip the spaces, and set the token to the chars until the next space - a single pass, since the first
+ * word of every line is read.
+ */
+static char *first_word(char *line, char *line_end, Token *word){
+    for (; line < line_end && isspace(*line); line++);
+
+    word->start = line;
+    for (; line < line_end && !isspace(*line); line++);
+    word->length = (int)(line - word->start);
+
+    return line;
+}
+
+/* Input: a token, and a keyword of the macros and its length.
+ * Output: returns 1 if the token is the keyword, 0 otherwise.
+ */
+static int is_macro_keyword(Token word, char *keyword, int length){
+    return word.length == length && memcmp(word.start, keyword, length) == 0;
+}
+
+/* Input: the rest of a line, and its end.
+ * Output: returns the first char of the line that isn't a space, or NULL if there is none.
+ */
+static char *extra_text(char *line, char *line_end){
+    for (; line < line_end && isspace(*line); line++);
+
+    return (line < line_end) ? line : NULL;
+}
+
+/* Input: the macro stage, the code of an error, the line and column it is about, and its argument and its length.
+ * Output: returns nothing. Reports the error and counts it.
+ */
+static void macro_error(MacroExpander *expander, enum diagnostic_code code, unsigned int line, unsigned int column,
+                        char *argument, int length){
+    report(expander->diagnostics, code, line, column, argument, length);
+    expander->errors++;
+}
+
+/* Input: the macro stage, the start and the end of a line that is not returned, and its line number.
+ * Output: returns nothing.
+ *
+ * Algorithm: if the lines of the listing file are recorded, record the line as a line with no words. If memory
+ * allocation failed, report it as an error.
+ */
+static void list_line(MacroExpander *expander, char *line_start, char *line_end, unsigned int number){
+    SourceLine *line;
+
+    if (expander->listed == NULL){
+        return;
+    }
+
+    if ((line = add_source_line(expander->listed)) == NULL){
+        macro_error(expander, DIAG_OUT_OF_MEMORY, number, 0, NULL, 0);
+        return;
+    }
+
+    line->start = line_start;
+    line->length = (unsigned int)(line_end - line_start);
+    line->number = number;
+    line->isListedOnly = true;
+}
+
+/* Input: the macro stage, the start and the end of the line that begins the definition, and the char after mcr.
+ * Output: returns nothing.
+ *
+ * Algorithm: read the name of the macro, and ensure it is a legal symbol, not a keyword of the macros, that it was not
+ * defined already and that nothing follows it. Then, read the lines of the body until endmcr - the body is all the
+ * lines between them, so it is kept as a view of the source. A definition inside the body is an error, and so is a
+ * source that ends before endmcr. A macro is added to the table only if its name is legal and new.
+ */
+static void define_macro(MacroExpander *expander, char *line_start, char *line_end, char *line){
+    unsigned int start_line = expander->line; /* the line of mcr */
+    SourceFile *source = expander->source;
+    Token name, word;
+    char *text, *body_start = source->data + source->position;
+    int legal = 1; /* marks whether the macro should be added to the table */
+    Macro *macro;
+
+    list_line(expander, line_start, line_end, start_line);
+    line = first_word(line, line_end, &name);
+
+    if (!legal_symbol(name) || is_macro_keyword(name, MACRO_START, MACRO_START_LENGTH) ||
+        is_macro_keyword(name, MACRO_END, MACRO_END_LENGTH)){
+        macro_error(expander, DIAG_ILLEGAL_MACRO, start_line, COLUMN(name.start, line_start), name.start, name.length);
+        legal = 0;
+    } else if (lookup_n(name.start, name.length, expander->macros) != NULL){
+        macro_error(expander, DIAG_MACRO_REDEFINED, start_line, COLUMN(name.start, line_start), name.start,
+                    name.length);
+        legal = 0;
+    } else if ((text = extra_text(line, line_end)) != NULL){ /* the macro is still defined, not to report its calls */
+        macro_error(expander, DIAG_EXTRA_TEXT, start_line, COLUMN(text, line_start), NULL, 0);
+    }
+
+    while (next_line(source, &line_start, &line_end)){ /* read the body, until endmcr */
+        expander->line++;
+        list_line(expander, line_start, line_end, expander->line);
+        line = first_word(line_start, line_end, &word);
+
+        if (is_macro_keyword(word, MACRO_START, MACRO_START_LENGTH)){
+            macro_error(expander, DIAG_NESTED_MACRO, expander->line, COLUMN(word.start, line_start), NULL, 0);
+        } else if (is_macro_keyword(word, MACRO_END, MACRO_END_LENGTH)){
+            if ((text = extra_text(line, line_end)) != NULL){
+                macro_error(expander, DIAG_EXTRA_TEXT, expander->line, COLUMN(text, line_start), NULL, 0);
+            }
+
+            if (!legal){
+                return;
+            }
+
+            macro = (Macro *)arena_alloc(expander->arena, sizeof(Macro));
+            text = (macro != NULL) ? arena_copy_string(expander->arena, name.start, name.length) : NULL;
+            if (text == NULL || install(text, macro, expander->macros) == NULL){
+                macro_error(expander, DIAG_OUT_OF_MEMORY, start_line, 0, NULL, 0);
+                return;
+            }
+
+            macro->body.data = body_start;
+            macro->body.size = (size_t)(line_start - body_start);
+            macro->body.position = 0;
+            macro->body.isMapped = false;
+            macro->line = start_line + 1;
+            return;
+        }
+    }
+
+    macro_error(expander, DIAG_MACRO_NOT_CLOSED, start_line, 0, name.start, name.length);
+}
+
+/* Input: the macro stage to initialize, a source file, the diagnostics of the file and the arena of the file.
+ * Output: returns 0 if succeeded, 1 if memory allocation failed.
+ */
+int init_macro_expander(MacroExpander *expander, SourceFile *source, Diagnostics *diagnostics, Arena *arena){
+    memset(expander, 0, sizeof(MacroExpander));
+    expander->source = source;
+    expander->diagnostics = diagnostics;
+    expander->arena = arena;
+    expander->expanding = false;
+
+    expander->macros = (Table *)arena_calloc(arena, 1, sizeof(Table));
+    RETURN_IF_MEMORY_ALLOC_ERROR(expander->macros, 1)
+    expander->macros->arena = arena;
+
+    return 0;
+}
+
+/* Input: the macro stage, pointers to the start and the end of the line to set, and a pointer to its line number.
+ * Output: returns 1 if a line was read, 0 at the end of the file.
+ *
+ * Algorithm: while a macro is expanded, return the next line of its body - read with next_line, just like the source,
+ * so a long line is split the same way. Otherwise, read the next line of the source. Until a macro is defined, only
+ * a line that begins with the first char of mcr or endmcr might not be returned as it is - the rest of the lines are
+ * returned after a glance at their first char. Otherwise, look at the first word of the line: mcr begins a definition,
+ * which is read as a whole, and endmcr alone is an error. A word that is the name of a macro - looked up only once a
+ * macro was defined - begins the expansion of the macro, if nothing follows it. Any other line is returned as it is.
+ * The lines that are not returned are recorded for the listing file, as they are read.
+ */
+int next_expanded_line(MacroExpander *expander, char **line, char **line_end, unsigned int *number){
+    Token word;
+    char *rest, *text;
+    cell *defined;
+
+    while (1){
+        if (expander->expanding){
+            if (next_line(&expander->expansion, line, line_end)){
+                *number = expander->expansion_line++;
+                expander->lines++;
+                return 1;
+            }
+            expander->expanding = false; /* the whole macro was read */
+        }
+
+        if (!next_line(expander->source, line, line_end)){
+            return 0;
+        }
+        expander->line++;
+
+        for (rest = *line; rest < *line_end && isspace(*rest); rest++); /* the first char of the line */
+
+        if (expander->macros->count == 0 && (rest == *line_end || (*rest != MACRO_START[0] && *rest != MACRO_END[0]))){
+            break; /* neither a definition nor a call */
+        }
+
+        rest = first_word(rest, *line_end, &word);
+
+        if (is_macro_keyword(word, MACRO_START, MACRO_START_LENGTH)){ /* the definition lists its own lines */
+            define_macro(expander, *line, *line_end, rest);
+            continue;
+        }
+
+        if (is_macro_keyword(word, MACRO_END, MACRO_END_LENGTH)){
+            list_line(expander, *line, *line_end, expander->line);
+            macro_error(expander, DIAG_MACRO_END_WITHOUT_START, expander->line, COLUMN(word.start, *line), NULL, 0);
+            continue;
+        }
+
+        if (expander->macros->count > 0 && word.length > 0 &&
+            (defined = lookup_n(word.start, word.length, expander->macros)) != NULL){
+            list_line(expander, *line, *line_end, expander->line); /* the call, followed by the lines of the macro */
+            if ((text = extra_text(rest, *line_end)) != NULL){
+                macro_error(expander, DIAG_EXTRA_TEXT, expander->line, COLUMN(text, *line), NULL, 0);
+                continue;
+            }
+
+            expander->expansion = ((Macro *)defined->value)->body; /* a view of the body, read from its start */
+            expander->expansion_line = ((Macro *)defined->value)->line;
+            expander->expanding = true;
+            continue;
+        }
+
+        break; /* any other line */
+    }
+
+    *number = expander->line;
+    expander->lines++;
+
+    return 1;
+}
+
+/* Input: the macro stage.
+ * Output: returns nothing.
+ */
+void free_macro_expander(MacroExpander *expander){
+    if (expander->macros != NULL){
+        free_table(expander->macros);
+    }
+}
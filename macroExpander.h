@@ -0,0 +1,70 @@
+#ifndef MACRO_EXPANDER_H
+#define MACRO_EXPANDER_H
+
+#include "sourceReader.h"
+#include "diagnostics.h"
+#include "arena.h"
+
+/* the keywords that begin and end the definition of a macro, each the first token of a line of its own */
+#define MACRO_START "mcr"
+#define MACRO_END "endmcr"
+
+/* the table of the macros, defined in tableTools.h */
+struct Table;
+
+/* a macro: its lines, as they are in the source file */
+struct Macro{
+    SourceFile body; /* the lines between mcr and endmcr - a view of the source file, which is never copied */
+    unsigned int line; /* the line number of the first line of the body */
+};
+
+typedef struct Macro Macro;
+
+/* the macro stage in front of the first scan: it reads a source file line by line, keeps the definitions of the
+ * macros, and replaces every line that calls a macro with the lines of the macro - all in place, in memory */
+struct MacroExpander{
+    SourceFile *source; /* the source file being read */
+    struct Table *macros; /* the macros defined so far, by their names, allocated out of the arena */
+    SourceFile expansion; /* the lines of the macro being expanded, if there is one */
+    unsigned int expansion_line; /* the line number of the next line of the expansion */
+    enum boolean expanding; /* marks whether the lines of a macro are being read */
+    unsigned int line; /* the line number of the last line read from the source file */
+    unsigned long lines; /* the amount of lines returned, after the expansion */
+    unsigned int errors; /* the amount of errors in the definitions and calls of the macros */
+    LineList *listed; /* the lines of the listing file, to record the lines that are not returned in - NULL for none */
+    Diagnostics *diagnostics; /* the diagnostics of the file, to report the errors to */
+    Arena *arena; /* the arena of the file */
+};
+
+typedef struct MacroExpander MacroExpander;
+
+/* Input: the macro stage to initialize, a source file, the diagnostics of the file and the arena of the file.
+ * Output: returns 0 if succeeded, 1 if memory allocation failed.
+ *
+ * This function prepares the macro stage to read the received source file from its current line. The macros, their
+ * names and the table they are kept in are allocated out of the arena.
+ */
+int init_macro_expander(MacroExpander *expander, SourceFile *source, Diagnostics *diagnostics, Arena *arena);
+
+/* Input: the macro stage, pointers to the start and the end of the line to set, and a pointer to its line number.
+ * Output: returns 1 if a line was read, 0 at the end of the file.
+ *
+ * This function sets the received pointers to the next line of the source after the macros were expanded, just like
+ * next_line does: the definitions of the macros are not returned, and a line that calls a macro - its name alone - is
+ * replaced with the lines of the macro. The line is never copied: the lines of a macro are read again out of its
+ * definition, and their line numbers are the ones of the definition, so that the columns and line numbers of the
+ * messages about them point at the text. A macro must be defined before it is called, and a macro is not expanded
+ * within another one. Errors in the definitions and calls are reported to the diagnostics, and counted. If the lines
+ * of the listing file are set, the lines that are not returned - the definitions and the calls - are recorded in them,
+ * in their place among the returned lines, as lines with no words.
+ */
+int next_expanded_line(MacroExpander *expander, char **line, char **line_end, unsigned int *number);
+
+/* Input: the macro stage.
+ * Output: returns nothing.
+ *
+ * This function frees the index of the table of the macros - the macros belong to the arena.
+ */
+void free_macro_expander(MacroExpander *expander);
+
+#endif
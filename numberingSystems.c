@@ -1,150 +1,120 @@
 #include "numberingSystems.h"
-#include "generals.h"
-#include <stdlib.h>
 #include <string.h>
-#include <stdio.h>
 
-#define HEX_DIGITS 16
+/* the rows of the hexadecimal table: the 16 words that share their leading digits, and the 256 words that share the
+ * first digit */
+#define HEX_ROW(a, b) {a, b, '0'}, {a, b, '1'}, {a, b, '2'}, {a, b, '3'}, {a, b, '4'}, {a, b, '5'}, {a, b, '6'}, \
+                      {a, b, '7'}, {a, b, '8'}, {a, b, '9'}, {a, b, 'A'}, {a, b, 'B'}, {a, b, 'C'}, {a, b, 'D'}, \
+                      {a, b, 'E'}, {a, b, 'F'}
+#define HEX_ROWS(a) HEX_ROW(a, '0'), HEX_ROW(a, '1'), HEX_ROW(a, '2'), HEX_ROW(a, '3'), HEX_ROW(a, '4'), \
+                    HEX_ROW(a, '5'), HEX_ROW(a, '6'), HEX_ROW(a, '7'), HEX_ROW(a, '8'), HEX_ROW(a, '9'), \
+                    HEX_ROW(a, 'A'), HEX_ROW(a, 'B'), HEX_ROW(a, 'C'), HEX_ROW(a, 'D'), HEX_ROW(a, 'E'), HEX_ROW(a, 'F')
+
+/* the pairs of decimal digits that share the first one */
+#define DECIMAL_ROW(a) {a, '0'}, {a, '1'}, {a, '2'}, {a, '3'}, {a, '4'}, {a, '5'}, {a, '6'}, {a, '7'}, {a, '8'}, {a, '9'}
+
+/* the hexadecimal digits of every word, indexed by the word - it is built for words of 12 bits, 3 digits each */
+static const char hex_words[1 << WORD_SIZE][HEX_WORD_LENGTH] = {
+    HEX_ROWS('0'), HEX_ROWS('1'), HEX_ROWS('2'), HEX_ROWS('3'), HEX_ROWS('4'), HEX_ROWS('5'), HEX_ROWS('6'),
+    HEX_ROWS('7'), HEX_ROWS('8'), HEX_ROWS('9'), HEX_ROWS('A'), HEX_ROWS('B'), HEX_ROWS('C'), HEX_ROWS('D'),
+    HEX_ROWS('E'), HEX_ROWS('F')
+};
+
+/* the two decimal digits of every number between 0 and 99 */
+static const char decimal_pairs[100][2] = {
+    DECIMAL_ROW('0'), DECIMAL_ROW('1'), DECIMAL_ROW('2'), DECIMAL_ROW('3'), DECIMAL_ROW('4'),
+    DECIMAL_ROW('5'), DECIMAL_ROW('6'), DECIMAL_ROW('7'), DECIMAL_ROW('8'), DECIMAL_ROW('9')
+};
+
+/* masks a value to the lowest x bits */
+#define FIELD_MASK(x) ((1 << (x)) - 1)
 
 /* Input: an integer.
- * Output: returns the num in its binary representation as a string. If something failed, NULL is returned.
+ * Output: returns the num as a word - in two's complement, truncated to WORD_SIZE bits.
  *
- * Algorithm: first, allocate memory for the string and create the index variable for the loop. If memory allocation failed,
- * NULL is returned. Then, start from the end of the string and add the value of the current bit as a char to the string.
- * Shift the num right to proceed to the next bits, and at the end return the created string.
+ * Algorithm: convert the num to unsigned, which keeps its two's complement representation, and keep only the
+ * lowest WORD_SIZE bits.
  */
-char *decimal_to_bin(int num){
-    char *bin = (char *)malloc(sizeof(char) * (WORD_SIZE+1)); /* allocate the result string and the terminating '\0' */
-    int i; /* to be used in the for loop */
-    unsigned int num1 = num;
-
-    RETURN_IF_MEMORY_ALLOC_ERROR(bin, NULL) /* ensure memory allocation succeeded */
-
-    for (i = WORD_SIZE - 1; i >= 0; i--){
-        /* check if the current bit is 1. If so, add '1' to the string. Else, add '0' to the string */
-        bin[i] = (num1 & 1) ? '1' : '0';
-        num1 = num1 >> 1; /* proceed to the next bits */
-    }
-
-    bin[WORD_SIZE] = '\0'; /* mark end of string */
-
-    return bin; /* return the created string */
-
+Word decimal_to_word(int num){
+    return (Word)((unsigned int)num & WORD_MASK);
 }
 
 /* Input: 4 integers representing the operation code, the funct, and the source & destination addressing methods.
- * Output: a string that represents the created word. If something failed, NULL is returned.
+ * Output: the created word.
  *
- * Algorithm: first, allocate memory for the result string and create a variable to iterate through it and update its content later.
- * ensure memory allocation succeeded, and then, encode all the received attributes, truncate the irrelevant chars of them,
- * and copy them in the necessary order to bin using the itr variable. If an encoding failed, NULL is returned.
+ * Algorithm: truncate every field to its length, and shift it to its place in the word - from left to right: the opcode,
+ * the funct, the source addressing method and the destination addressing method.
  */
-char *encode_command(unsigned int opcode, unsigned int funct, unsigned int src_addr_method, unsigned int dst_addr_method){
-    char *bin = (char *)malloc(sizeof(char) * (WORD_SIZE+1)); /* create the word */
-    char *itr = bin; /* to be used to edit bin */
-    char *dam, *sam, *fnc, *opc; /* strings to use to encode the command */
-
-    RETURN_IF_MEMORY_ALLOC_ERROR(bin, NULL) /* ensure memory allocation succeeded */
-
-    dam = decimal_to_bin(dst_addr_method); /* encode the destination address method */
-    sam = decimal_to_bin(src_addr_method); /* encode the source address method */
-    fnc = decimal_to_bin(funct); /* encode the funct */
-    opc = decimal_to_bin(opcode); /* encode the opcode */
-
-    /* ensure all encodings succeeded */
-    RETURN_IF_MEMORY_ALLOC_ERROR(dam, NULL)
-    RETURN_IF_MEMORY_ALLOC_ERROR(sam, NULL)
-    RETURN_IF_MEMORY_ALLOC_ERROR(fnc, NULL)
-    RETURN_IF_MEMORY_ALLOC_ERROR(opc, NULL)
-
-    dam += WORD_SIZE - DST_ADDR_METHOD_LENGTH; /* skip the irrelevant chars of the destination address method encoding */
-    sam += WORD_SIZE - SRC_ADDR_METHOD_LENGTH; /* skip the irrelevant chars of the source address method encoding */
-    fnc += WORD_SIZE - FUNCT_LENGTH; /* skip the irrelevant chars of the funct encoding*/
-    opc += WORD_SIZE - OPCODE_LENGTH; /* skip the irrelevant chars of the opcode encoding */
-
-    /* construct the word */
-    strncpy(itr, opc, OPCODE_LENGTH); /* copy the operation code to the result string */
-    itr += OPCODE_LENGTH; /* proceed to the next chars to edit */
-    strncpy(itr, fnc, FUNCT_LENGTH); /* copy the funct to the result string */
-    itr += FUNCT_LENGTH; /* proceed to the next chars to edit */
-    strncpy(itr, sam, SRC_ADDR_METHOD_LENGTH); /* copy the source address method to the result string */
-    itr += SRC_ADDR_METHOD_LENGTH; /* proceed to the next chars to edit */
-    strncpy(itr, dam, DST_ADDR_METHOD_LENGTH); /* copy the destination address method to the result string */
-
-    bin[WORD_SIZE] = '\0'; /* mark end of string */
-    return bin; /* return the generated word */
+Word encode_command(unsigned int opcode, unsigned int funct, unsigned int src_addr_method, unsigned int dst_addr_method){
+    unsigned int word;
+
+    word = opcode & FIELD_MASK(OPCODE_LENGTH); /* the operation code is the leftmost field */
+    word = (word << FUNCT_LENGTH) | (funct & FIELD_MASK(FUNCT_LENGTH)); /* add the funct */
+    word = (word << SRC_ADDR_METHOD_LENGTH) | (src_addr_method & FIELD_MASK(SRC_ADDR_METHOD_LENGTH)); /* add the source address method */
+    word = (word << DST_ADDR_METHOD_LENGTH) | (dst_addr_method & FIELD_MASK(DST_ADDR_METHOD_LENGTH)); /* add the destination address method */
+
+    return (Word)word; /* return the generated word */
 }
 
-/* Input: a string representing a binary number.
- * Output: returns the received number in hexadecimal base. If something failed, NULL is returned.
+/* Input: a word and a destination of at least HEX_WORD_LENGTH chars.
+ * Output: returns a pointer to the char after the digits. Writes the word in hexadecimal base to the destination.
  *
- * Algorithm: first, calculate the size of the string - the size of the received one divided by the size of chunk -
- * the currency is that 4 bits are equal to one hexadecimal digit. Create the result string and a string for the chunk.
- * If memory allocations failed, return NULL. Create a variable for the for loop, and one to hold the current decimal
- * value of the chunk. Then, iterate through every char in the result string. Store the current 4-bits chunk in chunk,
- * convert it to decimal, and set the value of the current char of the result string to its value in hexadecimal.
- * At the end, return the result string.
+ * Algorithm: the digits of every possible word are already in the table, indexed by the word itself - copy them.
  */
-char *bin_to_hex(char *bin){
-    int size = strlen(bin)/BIN_TO_HEX_CURRENCY; /* determine the size of the hex number */
-    char *hex = (char *)malloc(sizeof(char) * (size+1)); /* the result to be returned */
-    char *chunk = (char *)malloc(sizeof(char) * (BIN_TO_HEX_CURRENCY+1)); /* the current "chunk" - the 4-bit chunk to convert to hex */
-    int i, dec; /* to be used in the for loop, for the iteration and to hold the current decimal value of the chunk */
-
-
-    /* ensure memory allocations succeeded */
-    RETURN_IF_MEMORY_ALLOC_ERROR(hex, NULL)
-    RETURN_IF_MEMORY_ALLOC_ERROR(chunk, NULL)
-
-    for (i = 0; i < size; i++){ /* fill every char of the result */
-        strncpy(chunk, bin, BIN_TO_HEX_CURRENCY); /* copy the current chunk of bits to chunk */
-        chunk[BIN_TO_HEX_CURRENCY] = '\0'; /* mark end of chunk */
-        dec = bin_to_decimal(chunk); /* get the decimal value of the current chunk */
-        bin += BIN_TO_HEX_CURRENCY; /* proceed to the next chunk of bits for later */
-        hex[i] = decimal_to_hex(dec); /* convert the number to hexadecimal base and add it to the result string */
-    }
-
-    hex[size] = '\0'; /* mark end of string */
-
-    return hex; /* return the received number in hexadecimal base */
-
+char *word_to_hex(Word word, char *hex){
+    memcpy(hex, hex_words[word & WORD_MASK], HEX_WORD_LENGTH);
 
+    return hex + HEX_WORD_LENGTH;
 }
 
-/* Input: a string that represents a binary number.
- * Output: returns the received binary number as decimal.
+/* Input: an unsigned number and the least amount of digits to write.
+ * Output: returns the amount of chars unsigned_to_decimal writes for the number.
  *
- * Algorithm: create a result variable and reset it to zero. Also create a variable that holds the "value" of the current
- * bit (the most right is 1, the second is 2, etc.). then, begin from the end of the number (the last char) and for each
- * char multiply its value (0 or 1) by the value of the current index, and add it to the result. Update the index value
- * variable and continue to the next iteration. At the end, return the result.
+ * Algorithm: count the digits of the number by dividing it by 10 until it has a single digit left, and return the
+ * count - or the least amount, if it is larger.
  */
-int bin_to_decimal(char *bin){
-    int result = 0; /* the result to be returned */
-    int currentIndexValue = 1; /* represents the value of the current index. The value of the most right bit is one */
-    int i; /* to be used in the for loop */
-
-    for (i = strlen(bin)-1; i >= 0; i--){ /* iterate through all the chars */
-        result += ((bin[i] == '1') ? 1 : 0) * currentIndexValue; /* add to the result the value of the char times the value of the index */
-        currentIndexValue *= 2; /* update the index value variable */
+int decimal_length(unsigned int num, int min_digits){
+    int length = 1;
+
+    for (; num >= 10; num /= 10){
+        length++;
     }
 
-    return result; /* return the decimal number */
+    return (length > min_digits) ? length : min_digits;
 }
 
-/* Input: a decimal number.
- * Output: returns a char that represents the decimal number in hexadecimal base. If an invalid number was received, '0'
- * is returned.
+/* Input: an unsigned number, the least amount of digits to write and a destination of at least MAX_DECIMAL_DIGITS chars
+ * (or the least amount of digits, if it is larger).
+ * Output: returns a pointer to the char after the digits. Writes the number in decimal base to the destination.
  *
- * Algorithm: create an array of chars with the available hex digits. Then, check if the received number is in the valid range,
- * and if so return the matching char using the array. If the number wasn't appropriate, return '0'.
+ * Algorithm: write the number from its last digit backwards into a buffer, two digits at a time using the table of
+ * pairs, and a single digit for a number below 10. Pad the digits with zeros up to the least amount, and copy them to
+ * the destination - just like printf's "%0*u".
  */
-char decimal_to_hex(int dec){
-    char digits[HEX_DIGITS] = "0123456789ABCDEF";
+char *unsigned_to_decimal(unsigned int num, int min_digits, char *dest){
+    char digits[MAX_DECIMAL_DIGITS];
+    char *start = digits + MAX_DECIMAL_DIGITS; /* the first digit written so far */
+    int length;
+
+    while (num >= 100){ /* write two digits at a time */
+        start -= 2;
+        memcpy(start, decimal_pairs[num % 100], 2);
+        num /= 100;
+    }
+
+    if (num >= 10){
+        start -= 2;
+        memcpy(start, decimal_pairs[num], 2);
+    } else{
+        *--start = (char)('0' + num);
+    }
 
-    if (dec > 0 && dec < HEX_DIGITS){ /* ensure a valid decimal number was entered */
-        return digits[dec]; /* return the appropriate digit */
+    length = (int)(digits + MAX_DECIMAL_DIGITS - start);
+    for (; min_digits > length; min_digits--){ /* pad the number with zeros */
+        *dest++ = '0';
     }
 
-    return '0'; /* if an invalid decimal was entered, which a decimal not between 0 and 15, return 0 */
+    memcpy(dest, start, length);
+
+    return dest + length;
 }
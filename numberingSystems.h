@@ -1,37 +1,55 @@
+#include "generals.h"
+
+/* the amount of hexadecimal digits needed to write a word */
+#define HEX_WORD_LENGTH (WORD_SIZE / BIN_TO_HEX_CURRENCY)
+
+/* the most decimal digits an unsigned int takes */
+#define MAX_DECIMAL_DIGITS 10
+
+/* the shifts of the fields of a command word, as encode_command lays them out */
+#define DST_ADDR_METHOD_SHIFT 0
+#define SRC_ADDR_METHOD_SHIFT (DST_ADDR_METHOD_SHIFT + DST_ADDR_METHOD_LENGTH)
+#define FUNCT_SHIFT (SRC_ADDR_METHOD_SHIFT + SRC_ADDR_METHOD_LENGTH)
+#define OPCODE_SHIFT (FUNCT_SHIFT + FUNCT_LENGTH)
+
+/* the value of the field of a word at the received shift and length */
+#define WORD_FIELD(word, shift, length) (((unsigned int)(word) >> (shift)) & ((1 << (length)) - 1))
+
+/* the value of a word as a signed number - the word is in two's complement */
+#define SIGNED_WORD(word) ((int)((word) ^ (1 << (WORD_SIZE - 1))) - (1 << (WORD_SIZE - 1)))
+
 /* Input: an integer.
- * Output: returns the num in its binary representation as a string. If something failed, NULL is returned.
+ * Output: returns the num as a word - in two's complement, truncated to WORD_SIZE bits.
  *
- * This function converts a decimal number to a binary one, and returns it as a string.
+ * This function converts a decimal number to a word.
  */
-char *decimal_to_bin(int num);
+Word decimal_to_word(int num);
 
 /* Input: 4 integers representing the operation code, the funct, and the source & destination addressing methods.
- * Output: a string that represents the created word. If something failed, NULL is returned.
+ * Output: the created word.
  *
- * This function encodes the received command and its addressing methods to binary, and returns NULL in case of failure.
+ * This function encodes the received command and its addressing methods to a word.
  */
-char *encode_command(unsigned int opcode, unsigned int funct, unsigned int src_addr_method, unsigned int dst_addr_method);
+Word encode_command(unsigned int opcode, unsigned int funct, unsigned int src_addr_method, unsigned int dst_addr_method);
 
-/* Input: a string representing a binary number.
- * Output: returns the received number in hexadecimal base. If something failed, NULL is returned.
+/* Input: a word and a destination of at least HEX_WORD_LENGTH chars.
+ * Output: returns a pointer to the char after the digits. Writes the word in hexadecimal base to the destination.
  *
- * This function receives a binary number as a string and returns a string that represents this number in
- * hexadecimal base.
+ * This function receives a word and writes the HEX_WORD_LENGTH digits that represent it in hexadecimal base, looked up
+ * in a precomputed table. The digits are not terminated, so a whole image can be written into a single buffer.
  */
-char *bin_to_hex(char *bin);
+char *word_to_hex(Word word, char *hex);
 
-/* Input: a string that represents a binary number.
- * Output: returns the received binary number as decimal.
- *
- * This function receives a string that represents a binary number, and returns its decimal value.
+/* Input: an unsigned number and the least amount of digits to write.
+ * Output: returns the amount of chars unsigned_to_decimal writes for the number.
  */
-int bin_to_decimal(char *bin);
+int decimal_length(unsigned int num, int min_digits);
 
-/* Input: a decimal number.
- * Output: returns a char that represents the decimal number in hexadecimal base. If an invalid number was received, '0'
- * is returned.
+/* Input: an unsigned number, the least amount of digits to write and a destination of at least MAX_DECIMAL_DIGITS chars
+ * (or the least amount of digits, if it is larger).
+ * Output: returns a pointer to the char after the digits. Writes the number in decimal base to the destination.
  *
- * This function receives a number between 0 - 15 and returns a char that represents it in hexadecimal base.
- * If an out-of-range number was entered, the function returns '0'.
+ * This function writes the received number in decimal base, padded with zeros to the least amount of digits, just like
+ * printf's "%0*u". The digits are not terminated.
  */
-char decimal_to_hex(int dec);
\ No newline at end of file
+char *unsigned_to_decimal(unsigned int num, int min_digits, char *dest);
@@ -0,0 +1,53 @@
+#include <stdio.h>
+#include <string.h>
+#include "binaryObject.h"
+#include "imageTools.h"
+
+/* the option that converts binary object files back to the text files */
+#define TO_TEXT_OPTION "-t"
+
+#define USAGE "Usage: objectConverter [-t] file1 file2....\n"
+
+/* a converter between the text files of the assembler (.ob, .ent and .ext) and the binary object file (.obj). By
+ * default, the text files of every file are converted to a binary object file; with -t, the binary object file is
+ * converted back to the text files. The files are given without extensions, just like to the assembler. */
+int main(int argc, char *argv[]) {
+
+    int to_text = 0, first = 1, errors = 0, i; /* first is the index of the first filename in argv */
+    Arena arena = {NULL, NULL}; /* the names of the symbols, reused by all the files */
+    ObjectFile object;
+
+    if (first < argc && strcmp(argv[first], TO_TEXT_OPTION) == 0){
+        to_text = 1;
+        first++;
+    }
+
+    if (argc - first < 1){ /* check enough arguments were provided */
+        printf("Too few arguments!\n" USAGE); /* inform the user */
+        return MISSING_ARGS_ERROR;
+    }
+
+    for (i = first; i < argc; i++){
+        if ((to_text ? read_binary_object(&object, argv[i], &arena, stdout) :
+                       read_text_object(&object, argv[i], &arena, stdout)) != 0){
+            printf("Error converting file: %s\n", argv[i]);
+            errors = 1;
+            continue;
+        }
+
+        if ((to_text ? write_text_object(&object, argv[i], stdout) : write_binary_object(&object, argv[i], stdout)) != 0){
+            printf("Error converting file: %s\n", argv[i]);
+            errors = 1;
+        } else{
+            printf("Converted %s to %s\n", argv[i], to_text ? "text files" : BINARY_OBJ_EXTENSION);
+        }
+
+        free_image(&object.code);
+        free_image(&object.data);
+        reset_arena(&arena);
+    }
+
+    free_arena(&arena);
+
+    return errors;
+}
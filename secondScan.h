@@ -1,20 +1,23 @@
 #include <stdio.h>
 #include "inputHandlers.h"
+#include "diagnostics.h"
 
-/* Input:  an assembly file, the symbols table, and the binary code as a list of nodes.
+/* Input: the symbols table, the instructions image, the fix-up table, the .entry instructions of the file and the
+ * diagnostics of the file.
  * Output: returns 0 if no errors occurred, 1 otherwise.
  *
- * This function completes the compilation process, according to the second scan requirements. First, it locates the
- * .entry symbols. Then, it completes the encoding of the program, replacing the names of the symbols with their address,
- * or distance necessary to "jump".
+ * This function completes the compilation process, according to the second scan requirements - without reading the
+ * file again. First, it applies the .entry instructions recorded by the first scan. Then, it completes the encoding of
+ * the program, replacing the references in the fix-up table with the address of their symbol, or distance necessary
+ * to "jump". The errors are reported to the received diagnostics.
  */
-int secondScan(FILE *asmfile, Table *symbols_table, BinCodeNode *codeList);
+int secondScan(Table *symbols_table, Image *codeImage, FixupList *fixups, EntryList *entries, Diagnostics *diagnostics);
 
-/* Input: receive a symbol and an address in which it is used.
+/* Input: receive a symbol, an address in which it is used and the arena of the file.
  * Output: adds the address to the usages of the symbol. Returns 0 if succeeded, 1 otherwise.
  *
- * This function inserts the received address of usage to the received symbol, and returns 0 if insertion went properly,
- * else returns 1.
+ * This function inserts the received address of usage to the received symbol, allocating the usage out of the arena,
+ * and returns 0 if insertion went properly, else returns 1.
  */
-int addUsage(Symbol *symbol, unsigned int value);
+int addUsage(Symbol *symbol, unsigned int value, Arena *arena);
 
@@ -0,0 +1,423 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "binaryObject.h"
+#include "imageTools.h"
+
+/* the option that limits the amount of instructions a program may run */
+#define MAX_STEPS_OPTION "-n"
+
+/* the option that prints the registers once a program stopped */
+#define REGISTERS_OPTION "-r"
+
+#define USAGE "Usage: simulator [-n steps] [-r] file1 file2....\n"
+
+/* the amount of words in the memory - every address a word can hold */
+#define MEMORY_SIZE (1 << WORD_SIZE)
+
+/* the most subroutine calls (jsr) that may be active at once */
+#define CALL_STACK_SIZE 1024
+
+/* a simulator of the machine the assembler assembles for: a memory of MEMORY_SIZE words, NUM_OF_REGISTERS registers
+ * (r0-r7) and a zero flag. It runs the .ob file of every file - after it was linked, since it cannot have external
+ * words - from the first code word, until stop.
+ *
+ * The code is decoded once, before it runs: every command becomes an instruction whose operands point to their
+ * register, their word of the memory, or their immediate value, and whose jump is resolved to the instruction it goes
+ * to - so running a command is a single switch on its operation, with nothing left to decode. Since the code is
+ * only decoded once, a command that writes to a word of the code is an error, found while decoding.
+ *
+ * The commands: mov copies the source to the destination, and lea copies the address of the source. add and sub add
+ * the source to the destination or subtract it from it, and cmp sets the zero flag if both are equal. clr, not, inc
+ * and dec change the destination. jmp jumps to the destination, bne only if the zero flag is clear, and jsr calls it;
+ * rts returns from the call. red reads a char from the standard input (-1 at its end) to the destination, and prn
+ * prints the destination as a signed number. Relative operands (%LABEL) are the distance from their own word. */
+
+/* the operations of the instructions: the commands, in their opcode order (the indexes find_command_by_code returns),
+ * and the end of the code - an instruction after the last command, to stop a program that runs past it */
+enum operation {OP_MOV, OP_CMP, OP_ADD, OP_SUB, OP_LEA, OP_CLR, OP_NOT, OP_INC, OP_DEC, OP_JMP, OP_BNE, OP_JSR,
+                OP_RED, OP_PRN, OP_RTS, OP_STOP, OP_END};
+
+/* used by run() to stop the program with the reason x, at the current instruction */
+#define HALT(x) { \
+                    machine->steps = steps; \
+                    *stopped = pc; \
+                    return x; \
+                }
+
+/* the ways a program stops */
+enum stop_reason {STOPPED, RAN_PAST_END, STACK_OVERFLOW, STACK_UNDERFLOW, STEP_LIMIT};
+
+/* a decoded command */
+struct Instruction{
+    enum operation operation;
+    Word *src; /* the source operand - a register, a word of the memory, or one of the immediates */
+    Word *dst; /* the destination operand */
+    Word immediates[2]; /* the values of the immediate operands, and the address lea copies */
+    struct Instruction *next; /* the instruction after the command */
+    struct Instruction *target; /* the instruction a jump goes to */
+    unsigned int address; /* the address of the command */
+    unsigned int target_address; /* the address a jump goes to, until it is resolved to its instruction */
+    enum boolean isCommand; /* marks whether a command starts at the address */
+};
+
+/* the state of the machine, and the decoded code of its program */
+struct Machine{
+    Word memory[MEMORY_SIZE];
+    Word registers[NUM_OF_REGISTERS];
+    struct Instruction *instructions; /* the instruction of every word of the code by its index, and the end */
+    unsigned int load; /* the address of the first word of the code */
+    unsigned int size; /* the amount of words in the code */
+    unsigned long steps; /* the amount of instructions the program ran */
+};
+
+/* Input: the machine, the instruction of the operand, the operand to set, its slot of the immediates, its addressing
+ * method, its word, the methods valid for it and the stream to write errors to. Sets the address the operand refers to.
+ * Output: returns 0 if the operand was decoded, 1 otherwise.
+ *
+ * Algorithm: an immediate operand points to its slot, which holds the value of the word. A direct operand points to
+ * the word of the memory at the address in the word, and a relative one to the word at the distance in the word from
+ * the word itself. A register operand has a single bit set - the one of the register it points to. An external word
+ * was never linked, and has no address to refer to.
+ */
+static int decode_operand(struct Machine *machine, struct Instruction *instruction, Word **operand, int slot,
+                          unsigned int method, BinCodeNode *word, const char *valid_methods, unsigned int *address,
+                          FILE *log){
+    int reg;
+
+    if (valid_methods[method] != '1'){
+        fprintf(log, "Error at address %u: invalid addressing method %u\n", instruction->address, method);
+        return 1;
+    }
+
+    if (word->are == E){
+        fprintf(log, "Error at address %u: the external word was not linked\n", word->IC);
+        return 1;
+    }
+
+    switch (method){
+        case IMMEDIATE:
+            instruction->immediates[slot] = word->code;
+            *operand = &instruction->immediates[slot];
+            break;
+        case DIRECT:
+            *address = word->code & WORD_MASK;
+            *operand = &machine->memory[*address];
+            break;
+        case RELATIVE:
+            *address = (unsigned int)(word->IC + SIGNED_WORD(word->code & WORD_MASK)) & WORD_MASK;
+            *operand = &machine->memory[*address];
+            break;
+        default:
+            for (reg = 0; reg < NUM_OF_REGISTERS && word->code != (1 << reg); reg++)
+                ;
+
+            if (reg == NUM_OF_REGISTERS){
+                fprintf(log, "Error at address %u: invalid register word %03X\n", word->IC, word->code);
+                return 1;
+            }
+            *operand = &machine->registers[reg];
+    }
+
+    return 0;
+}
+
+/* Input: the machine, the code image and the stream to write errors to.
+ * Output: returns the amount of errors.
+ *
+ * Algorithm: go over the code image, a command after the other: find the command of the word by its operation code
+ * and funct, and decode the words of its operands that follow it - the source first. lea copies the address of its
+ * source, which is kept as an immediate; a jump keeps the address it goes to. Every command gets the instruction after
+ * its words as the next one, and the instruction after the last command ends the code. Then, resolve every jump to
+ * the instruction of the command it goes to - a jump to any other word is an error.
+ */
+static int decode_code(struct Machine *machine, Image *code, FILE *log){
+    struct Instruction *instruction;
+    const Command *command;
+    unsigned int i, length, src_method, dst_method, address, end = machine->load + machine->size;
+    int errors = 0, index;
+    BinCodeNode *word;
+
+    for (i = 0; i < machine->size; i += length){
+        instruction = &machine->instructions[i];
+        word = &code->words[i];
+        instruction->address = machine->load + i;
+        instruction->isCommand = true;
+        index = find_command_by_code(WORD_FIELD(word->code, OPCODE_SHIFT, OPCODE_LENGTH),
+                                     WORD_FIELD(word->code, FUNCT_SHIFT, FUNCT_LENGTH));
+
+        if (word->are != A || index < 0){
+            fprintf(log, "Error at address %u: %03X is not a command\n", instruction->address, word->code);
+            return errors + 1; /* the words that follow cannot be told apart */
+        }
+
+        command = get_command(index);
+        length = 1 + command->num_of_args;
+        src_method = WORD_FIELD(word->code, SRC_ADDR_METHOD_SHIFT, SRC_ADDR_METHOD_LENGTH);
+        dst_method = WORD_FIELD(word->code, DST_ADDR_METHOD_SHIFT, DST_ADDR_METHOD_LENGTH);
+        instruction->operation = (enum operation)index;
+
+        if (i + length > machine->size){
+            fprintf(log, "Error at address %u: the operands of %s are missing\n", instruction->address, command->name);
+            return errors + 1;
+        }
+
+        instruction->next = &machine->instructions[i + length];
+        address = 0;
+
+        if (command->num_of_args == 2){
+            errors += decode_operand(machine, instruction, &instruction->src, 0, src_method, word + 1,
+                                     command->valid_src_addr_methods, &address, log);
+            if (instruction->operation == OP_LEA){ /* the source is direct */
+                instruction->immediates[0] = (Word)address;
+                instruction->src = &instruction->immediates[0];
+            }
+        }
+
+        address = 0;
+        if (command->num_of_args > 0){
+            errors += decode_operand(machine, instruction, &instruction->dst, 1, dst_method, word + command->num_of_args,
+                                     command->valid_dst_addr_methods, &address, log);
+        }
+
+        instruction->target_address = address;
+        if (dst_method == DIRECT && address >= machine->load && address < end && instruction->operation != OP_CMP &&
+            instruction->operation != OP_PRN && instruction->operation != OP_JMP && instruction->operation != OP_BNE &&
+            instruction->operation != OP_JSR){
+            fprintf(log, "Error at address %u: %s writes to the code, at address %u\n", instruction->address,
+                    command->name, address);
+            errors++;
+        }
+    }
+
+    instruction = &machine->instructions[machine->size];
+    instruction->operation = OP_END;
+    instruction->address = end;
+    instruction->isCommand = true;
+
+    for (i = 0; i < machine->size; i++){ /* resolve the jumps */
+        instruction = &machine->instructions[i];
+        if (!instruction->isCommand || (instruction->operation != OP_JMP && instruction->operation != OP_BNE &&
+                                        instruction->operation != OP_JSR)){
+            continue;
+        }
+
+        address = instruction->target_address;
+        if (address < machine->load || address >= end || !machine->instructions[address - machine->load].isCommand){
+            fprintf(log, "Error at address %u: jumps to address %u, which is not a command\n", instruction->address,
+                    address);
+            errors++;
+            continue;
+        }
+
+        instruction->target = &machine->instructions[address - machine->load];
+    }
+
+    return errors;
+}
+
+/* Input: the machine, and the object of the program.
+ * Output: returns the amount of errors.
+ *
+ * Algorithm: the code starts at the address of its first word. Copy the words of both images to their addresses in the
+ * memory - if they all fit in it - and decode the code.
+ */
+static int load_program(struct Machine *machine, ObjectFile *object, FILE *log){
+    unsigned int i;
+
+    machine->load = (object->code.size > 0) ? object->code.words[0].IC : CODE_LOADING_ADDRESS;
+    machine->size = object->code.size;
+
+    if (machine->load + object->code.size + object->data.size > MEMORY_SIZE){
+        fprintf(log, "Error: the program takes %u words from address %u, which do not fit in the memory\n",
+                object->code.size + object->data.size, machine->load);
+        return 1;
+    }
+
+    for (i = 0; i < object->code.size; i++){
+        machine->memory[object->code.words[i].IC] = object->code.words[i].code & WORD_MASK;
+    }
+    for (i = 0; i < object->data.size; i++){
+        machine->memory[object->data.words[i].IC] = object->data.words[i].code & WORD_MASK;
+    }
+
+    machine->instructions = (struct Instruction *)counted_calloc(machine->size + 1, sizeof(struct Instruction));
+    RETURN_IF_MEMORY_ALLOC_ERROR(machine->instructions, 1)
+
+    return decode_code(machine, &object->code, log);
+}
+
+/* Input: the machine, the most instructions to run (0 for no limit), and the streams to read from and write to.
+ * Output: returns the reason the program stopped. Sets the amount of instructions it ran, and leaves the instruction it
+ * stopped at in the received pointer.
+ *
+ * Algorithm: run the instruction, and go on to the next one - unless it jumped. The operands were decoded into
+ * pointers, so every operation only reads and writes through them, and keeps the words in WORD_SIZE bits.
+ */
+static enum stop_reason run(struct Machine *machine, unsigned long max_steps, FILE *in, FILE *out,
+                            struct Instruction **stopped){
+    struct Instruction *pc = machine->instructions;
+    struct Instruction *calls[CALL_STACK_SIZE]; /* the instructions the active calls return to */
+    unsigned long steps = 0, limit = (max_steps == 0) ? (unsigned long)-1 : max_steps;
+    int depth = 0, zero = 0, c;
+
+    for (;;){
+        if (steps == limit){
+            HALT(STEP_LIMIT)
+        }
+        steps++;
+
+        switch (pc->operation){
+            case OP_MOV:
+            case OP_LEA:
+                *pc->dst = *pc->src;
+                break;
+            case OP_CMP:
+                zero = (*pc->src == *pc->dst);
+                break;
+            case OP_ADD:
+                *pc->dst = (Word)((*pc->dst + *pc->src) & WORD_MASK);
+                break;
+            case OP_SUB:
+                *pc->dst = (Word)((*pc->dst - *pc->src) & WORD_MASK);
+                break;
+            case OP_CLR:
+                *pc->dst = 0;
+                break;
+            case OP_NOT:
+                *pc->dst = (Word)(~*pc->dst & WORD_MASK);
+                break;
+            case OP_INC:
+                *pc->dst = (Word)((*pc->dst + 1) & WORD_MASK);
+                break;
+            case OP_DEC:
+                *pc->dst = (Word)((*pc->dst - 1) & WORD_MASK);
+                break;
+            case OP_JMP:
+                pc = pc->target;
+                continue;
+            case OP_BNE:
+                pc = zero ? pc->next : pc->target;
+                continue;
+            case OP_JSR:
+                if (depth == CALL_STACK_SIZE){
+                    HALT(STACK_OVERFLOW)
+                }
+                calls[depth++] = pc->next;
+                pc = pc->target;
+                continue;
+            case OP_RTS:
+                if (depth == 0){
+                    HALT(STACK_UNDERFLOW)
+                }
+                pc = calls[--depth];
+                continue;
+            case OP_RED:
+                c = getc(in);
+                *pc->dst = (Word)((unsigned int)((c == EOF) ? -1 : c) & WORD_MASK);
+                break;
+            case OP_PRN:
+                fprintf(out, "%d\n", SIGNED_WORD(*pc->dst));
+                break;
+            case OP_STOP:
+                HALT(STOPPED)
+            default:
+                steps--; /* the end of the code is not an instruction */
+                HALT(RAN_PAST_END)
+        }
+
+        pc = pc->next;
+    }
+}
+
+/* Input: the base filename of a program, the most instructions to run, whether to print the registers, and an arena.
+ * Output: returns 0 if the program ran until stop, 1 otherwise.
+ *
+ * Algorithm: read the .ob file of the program, load it and run it. Report the amount of instructions it ran and their
+ * rate - the time of running only, without the loading - and why it stopped, if not by stop.
+ */
+static int simulate(char *filename, unsigned long max_steps, int print_registers, Arena *arena){
+    static char *reasons[] = {"", "ran past the end of the code", "too many nested calls", "rts without a call",
+                              "reached the limit of instructions"};
+    struct Machine *machine;
+    struct Instruction *stopped;
+    enum stop_reason reason;
+    ObjectFile object;
+    double start, elapsed_ms;
+    int errors, i;
+
+    if (read_text_object(&object, filename, arena, stderr) != 0){
+        return 1;
+    }
+
+    machine = (struct Machine *)counted_calloc(1, sizeof(struct Machine));
+    errors = (machine == NULL) ? 1 : load_program(machine, &object, stderr);
+    free_image(&object.code);
+    free_image(&object.data);
+
+    if (errors != 0){
+        fprintf(stderr, "Error loading %s\n", filename);
+        if (machine != NULL){
+            free(machine->instructions);
+        }
+        free(machine);
+        return 1;
+    }
+
+    start = now_ms();
+    reason = run(machine, max_steps, stdin, stdout, &stopped);
+    elapsed_ms = now_ms() - start;
+    fflush(stdout);
+
+    if (reason != STOPPED){
+        fprintf(stderr, "Error in %s: %s, at address %u\n", filename, reasons[reason], stopped->address);
+    }
+
+    if (print_registers){
+        for (i = 0; i < NUM_OF_REGISTERS; i++){
+            printf("%sr%d=%d", (i > 0) ? " " : "", i, SIGNED_WORD(machine->registers[i]));
+        }
+        printf("\n");
+    }
+
+    fprintf(stderr, "%s: %lu instructions in %.3f ms (%.0f instructions/sec)\n", filename, machine->steps,
+            elapsed_ms, (elapsed_ms > 0) ? machine->steps / elapsed_ms * 1000 : 0.0);
+
+    free(machine->instructions);
+    free(machine);
+
+    return reason != STOPPED;
+}
+
+int main(int argc, char *argv[]) {
+
+    int print_registers = 0, first = 1, errors = 0, i; /* first is the index of the first filename in argv */
+    unsigned long max_steps = 0; /* no limit */
+    Arena arena = {NULL, NULL}; /* the names of the symbols, reused by all the files */
+
+    while (first < argc){
+        if (first + 1 < argc && strcmp(argv[first], MAX_STEPS_OPTION) == 0){
+            max_steps = strtoul(argv[first + 1], NULL, 10);
+            first += 2;
+        } else if (strcmp(argv[first], REGISTERS_OPTION) == 0){
+            print_registers = 1;
+            first++;
+        } else{
+            break;
+        }
+    }
+
+    if (argc - first < 1){ /* check enough arguments were provided */
+        printf("Too few arguments!\n" USAGE); /* inform the user */
+        return MISSING_ARGS_ERROR;
+    }
+
+    for (i = first; i < argc; i++){
+        errors |= simulate(argv[i], max_steps, print_registers, &arena);
+        reset_arena(&arena);
+    }
+
+    free_arena(&arena);
+
+    return errors;
+}
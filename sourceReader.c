@@ -0,0 +1,108 @@
+#define _POSIX_C_SOURCE 200809L /* for mmap, posix_madvise and fileno */
+
+#include "sourceReader.h"
+#include "assemblyStats.h"
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/* the amount of chars read at once from a file that cannot be mapped */
+#define READ_CHUNK_SIZE 4096
+
+/* Input: a source file to initialize, and an opened file.
+ * Output: returns 0 if succeeded, 1 otherwise.
+ *
+ * Algorithm: if the file is a regular, non-empty file, map it in read-only mode and advise the kernel it will be read
+ * sequentially. If it cannot be mapped, read the file in chunks into a buffer that doubles its size when full.
+ */
+int open_source(SourceFile *source, FILE *file){
+    struct stat info;
+    size_t capacity = 0, read;
+    char *data;
+
+    source->data = NULL;
+    source->size = 0;
+    source->position = 0;
+    source->isMapped = false;
+
+    if (fstat(fileno(file), &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0){ /* only a regular file can be mapped */
+        data = (char *)mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+
+        if (data != MAP_FAILED){
+            posix_madvise(data, (size_t)info.st_size, POSIX_MADV_SEQUENTIAL); /* only a hint, so the result is ignored */
+            source->data = data;
+            source->size = (size_t)info.st_size;
+            source->isMapped = true;
+            return 0;
+        }
+    }
+
+    do { /* read the file into memory */
+        if (source->size == capacity){ /* ensure there is room for another chunk */
+            capacity = (capacity == 0) ? READ_CHUNK_SIZE : capacity * 2;
+            data = (char *)counted_realloc(source->data, source->size, capacity);
+
+            if (data == NULL){
+                free(source->data);
+                source->data = NULL;
+                return 1;
+            }
+
+            source->data = data;
+        }
+
+        read = fread(source->data + source->size, 1, capacity - source->size, file);
+        source->size += read;
+    } while (read > 0);
+
+    return ferror(file) ? 1 : 0;
+}
+
+/* Input: a source file, and pointers to the start and the end of the line to set.
+ * Output: returns 1 if a line was read, 0 at the end of the file.
+ *
+ * Algorithm: if the whole file was read, return 0. Otherwise, search for the next '\n' among the next chars - no more
+ * than fgets would read into a buffer of MAX_LINE_LENGTH chars. The line ends after the '\n' if it was found, or after
+ * the chars searched. Set the pointers, and continue the next search after the line.
+ */
+int next_line(SourceFile *source, char **line, char **line_end){
+    size_t left = source->size - source->position; /* the amount of chars not read yet */
+    char *start = source->data + source->position;
+    char *newline;
+
+    if (left == 0){ /* the end of the file was reached */
+        return 0;
+    }
+
+    if (left > MAX_LINE_LENGTH - 1){ /* fgets reads at most MAX_LINE_LENGTH - 1 chars, leaving room for the '\0' */
+        left = MAX_LINE_LENGTH - 1;
+    }
+
+    newline = (char *)memchr(start, '\n', left);
+    if (newline != NULL){
+        left = newline - start + 1; /* include the '\n' in the line */
+    }
+
+    *line = start;
+    *line_end = start + left;
+    source->position += left;
+
+    return 1;
+}
+
+/* Input: a source file.
+ * Output: returns nothing.
+ *
+ * Algorithm: unmap the content if it was mapped, free it otherwise.
+ */
+void close_source(SourceFile *source){
+    if (source->isMapped == true){
+        munmap(source->data, source->size);
+    } else{
+        free(source->data);
+    }
+
+    source->data = NULL;
+    source->size = 0;
+}
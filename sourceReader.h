@@ -0,0 +1,41 @@
+#ifndef SOURCE_READER_H
+#define SOURCE_READER_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include "generals.h"
+
+/* an assembly source file, mapped into memory (or read into it, if it cannot be mapped) and scanned line by line in place */
+struct SourceFile{
+    char *data; /* the content of the file. It is not terminated, and must not be written to */
+    size_t size; /* the amount of chars in the file */
+    size_t position; /* the index of the first char of the next line */
+    enum boolean isMapped; /* marks whether data is mapped, or was allocated */
+};
+
+typedef struct SourceFile SourceFile;
+
+/* Input: a source file to initialize, and an opened file.
+ * Output: returns 0 if succeeded, 1 otherwise.
+ *
+ * This function makes the content of the received file available to scan. A regular file is mapped into memory, so
+ * reading it copies nothing. Otherwise (a pipe, for example), the file is read into memory.
+ */
+int open_source(SourceFile *source, FILE *file);
+
+/* Input: a source file, and pointers to the start and the end of the line to set.
+ * Output: returns 1 if a line was read, 0 at the end of the file.
+ *
+ * This function sets the received pointers to the next line of the file, including its '\n'. The line is not copied,
+ * and is valid until the source is closed. Like fgets with MAX_LINE_LENGTH chars, a longer line is read in parts.
+ */
+int next_line(SourceFile *source, char **line, char **line_end);
+
+/* Input: a source file.
+ * Output: returns nothing.
+ *
+ * This function unmaps or frees the content of the received source file.
+ */
+void close_source(SourceFile *source);
+
+#endif
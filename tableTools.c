@@ -1,75 +1,158 @@
 #include "tableTools.h"
 #include "generals.h"
+#include "assemblyStats.h"
 #include <string.h>
 #include <stdlib.h>
 
-#define RAND_HASH_NUM 31
+/* the constants of the 32-bit FNV-1a hash function */
+#define FNV_OFFSET_BASIS 2166136261u
+#define FNV_PRIME 16777619u
 
-/* Input: a pointer to a symbol.
- * Output: returns nothing.
+/* Input: a table and the new amount of slots.
+ * Output: returns 0 if succeeded, 1 otherwise.
  *
- * This function frees the dynamically allocated memory used by the received symbol.
+ * This function rebuilds the open-addressing index of the table with the received amount of slots.
  */
-void free_symbol(Symbol *symbol);
+int grow_slots(Table *table, unsigned int new_size);
 
 /* Input: a string.
  * Output: hashes the string and returns the hash value.
  *
- * Algorithm: iterate through the letters of the string, and using their numeric value generate a hash value.
- * Return the modulo of the generated value by the table size, so that the value would be in the right range.
+ * Algorithm: hash the chars of the string, up to its end.
  */
 unsigned int hash(char *s){
-    unsigned int hashval;
+    return hash_n(s, strlen(s));
+}
 
-    for (hashval = 0; *s != '\0'; s++){ /* iterate through the received string and determine the hash value */
-        hashval = *s + RAND_HASH_NUM * hashval;
+/* Input: a string that is not necessarily terminated, and its length.
+ * Output: hashes the string and returns the hash value.
+ *
+ * Algorithm: iterate through the first length letters of the string, and for each one mix its numeric value into the
+ * hash value using the FNV-1a method. The full value is returned - the table keeps it in the slot and masks it by its size.
+ */
+unsigned int hash_n(char *s, unsigned int length){
+    unsigned long hashval; /* unsigned long is at least 32 bits wide */
+    unsigned int i;
+
+    for (hashval = FNV_OFFSET_BASIS, i = 0; i < length; i++){ /* iterate through the received string and determine the hash value */
+        hashval = ((hashval ^ (unsigned char)s[i]) * FNV_PRIME) & 0xFFFFFFFFUL;
     }
 
-    return hashval % TABLE_SIZE; /* return the generated hash, in the right range */
+    return (unsigned int)hashval; /* return the generated hash */
 }
 
 /* Input: a table and a key to search in it.
  * Output: returns the value - the cell - of the received key. If there isn't such a cell, NULL is returned.
  *
- * Algorithm: First, hash the received string to determine the location in the array, in which the key might be. Then,
- * iterate over all the cells in the current location, and for each check if its key is the searched one. If so, return
- * the cell. If the key was not found, return NULL.
+ * Algorithm: search for the key made of the whole string, using lookup_n().
  */
 cell *lookup(char *s, Table *table) {
-    cell *ret; /* the value to be returned */
+    return lookup_n(s, strlen(s), table);
+}
+
+/* Input: a table, a key that is not necessarily terminated, and its length.
+ * Output: returns the cell of the key made of the first length chars of s. If there isn't such a cell, NULL is returned.
+ *
+ * Algorithm: hash the key, and search for it using lookup_hashed().
+ */
+cell *lookup_n(char *s, unsigned int length, Table *table){
+    return lookup_hashed(s, length, hash_n(s, length), table);
+}
+
+/* Input: a table, a key that is not necessarily terminated, its length and its hash value.
+ * Output: returns the cell of the key. If there isn't such a cell, NULL is returned.
+ *
+ * Algorithm: First, mask the hash value to determine the home slot of the key. Then, walk the slots from there on
+ * (wrapping around the end) until an empty slot is reached. For each occupied slot, compare the keys only if the stored
+ * hash value is equal to the searched one - the stored key must have the same chars and end right after them. If so,
+ * return the cell. If an empty slot was reached, return NULL.
+ */
+cell *lookup_hashed(char *s, unsigned int length, unsigned int hashval, Table *table){
+    unsigned int mask, i;
+    struct slot *cur;
+    char *key;
 
-    for (ret = table->storage[hash(s)]; ret != NULL; ret = ret->next){ /* iterate through different cells in the corresponding hash value */
-        if (strcmp(s, ret->key) == 0){ /* check if the right cell was reached */
-            return ret;
+    if (table->size == 0){ /* nothing was installed in the table yet */
+        return NULL;
+    }
+
+    mask = table->size - 1; /* the size is a power of 2, so masking is the same as modulo */
+
+    for (i = hashval & mask; (cur = &table->slots[i])->index != 0; i = (i + 1) & mask){ /* probe until an empty slot */
+        key = table->cells[cur->index - 1].key;
+        if (cur->hashval == hashval && strncmp(s, key, length) == 0 && key[length] == '\0'){ /* check if the right cell was reached */
+            return &table->cells[cur->index - 1];
         }
     }
 
     return NULL; /* in case the key s is not in the table */
+}
+
+/* Input: a key that isn't in the table, its hash value and the table.
+ * Output: returns the created cell, without a value, or NULL if memory allocation failed.
+ *
+ * Algorithm: grow the index if the load factor would be exceeded, and the cells array if it is full. Then, keep the key
+ * in the next free cell, and store the cell's index and the hash value in the first empty slot after the key's home
+ * slot.
+ */
+static cell *add_cell(char *key, unsigned int hashval, Table *table){
+    cell *ret; /* the cell of the table to be returned */
+    unsigned int mask, i;
+
+    /* ensure the index is big enough to hold another key */
+    if ((table->count + 1) * LOAD_DENOMINATOR > table->size * LOAD_NUMERATOR &&
+        grow_slots(table, (table->size == 0) ? TABLE_INITIAL_SIZE : table->size * 2) != 0){
+        return NULL;
+    }
+
+    if (table->count == table->cells_size){ /* ensure there is a free cell */
+        unsigned int new_size = (table->cells_size == 0) ? TABLE_INITIAL_SIZE : table->cells_size * 2;
+        cell *cells = (cell *)counted_realloc(table->cells, sizeof(cell) * table->cells_size, sizeof(cell) * new_size);
+        RETURN_IF_MEMORY_ALLOC_ERROR(cells, NULL)
+
+        table->cells = cells;
+        table->cells_size = new_size;
+    }
+
+    ret = &table->cells[table->count];
+    ret->key = key;
+    ret->value = NULL;
+
+    mask = table->size - 1;
+    for (i = hashval & mask; table->slots[i].index != 0; i = (i + 1) & mask); /* find the first empty slot */
+
+    table->slots[i].hashval = hashval;
+    table->slots[i].index = ++table->count; /* add the cell to the table */
 
+    return ret;
 }
 
 /* Input: a string as a key, a value, the table to which the row should be added.
  * Output: returns the created cell in the table.
  *
- * Algorithm: first, check if the value is already in the table. If it is, just update the value. If not,
- * allocate memory for the cell and edit its properties as needed. Before exiting, set the cell's value.
+ * Algorithm: first, check if the value is already in the table. If it is, just update the value. If not, copy the key
+ * (out of the arena of the table, if it has one) and add a cell for the copy. Before exiting, set the cell's value.
  * Returns NULL if something utterly failed, returns the created cell otherwise.
  */
 cell *install(char *key, void *value, Table *table){
     cell *ret; /* the cell of the table to be returned */
-    unsigned int hashval;
+    char *copy; /* the key, owned by the table */
 
     if ((ret = lookup(key, table)) == NULL) { /* if the key isn't yet in the table */
-        ret = (cell *) calloc(1, sizeof(cell)); /* allocate memory for the cell */
-        ret->key = (char *)malloc(sizeof(char)*10); /* allocate memory for the name - the key */
-        if (ret == NULL || (strcpy(ret->key, key)) == NULL){ /* if an allocation is failed */
+        /* allocate memory for the name - the key - out of the arena of the table, if it has one */
+        copy = (char *)((table->arena != NULL) ? arena_alloc(table->arena, sizeof(char) * (strlen(key) + 1))
+                                               : counted_malloc(sizeof(char) * (strlen(key) + 1)));
+        if (copy == NULL){ /* if the allocation is failed */
             return NULL; /* indicate an error */
         }
 
-        hashval = hash(key); /* hash the key to determine the right index in the array */
-        ret->next = table->storage[hashval]; /* keep the previous data */
-        table->storage[hashval] = ret; /* add the cell to the table */
-    } else { /* if the key is already in the table */
+        if ((ret = add_cell(strcpy(copy, key), hash(key), table)) == NULL){
+            if (table->arena == NULL){
+                free(copy);
+            }
+            return NULL;
+        }
+    } else if (table->arena == NULL){ /* if the key is already in a table that owns its values */
         free((void *) ret->value); /* free the previous value */
     }
 
@@ -80,60 +163,84 @@ cell *install(char *key, void *value, Table *table){
     return ret;
 }
 
-/* Input: a table and an integer indicating whether the table contains symbols.
- * Output: returns nothing. Frees all the memory used by the table.
+/* Input: a key that isn't in the table yet, its hash value, a value, and a table with an arena.
+ * Output: returns the created cell in the table, or NULL if memory allocation failed.
  *
- * Algorithm: iterate through every cell in the array of the table. For each cell, go through every row in the table, and
- * save the next one. If the table stores symbols, free its properties. Otherwise, free it right away. In any case,
- * free the name of the row, its key, and free the row itself.
+ * Algorithm: add a cell for the key itself, and set its value.
  */
-void free_table(Table *table, int is_symbol){
-    int i; /* used in the for loop */
-    cell *c; /* holds the current cell of the table */
-
-    for (i = 0; i < TABLE_SIZE; i++) { /* go through the cells of the table's array */
-        for (c = table->storage[i];  c != NULL ;) { /* iterate through every row */
-            /* these variables are used to go through the rows in the current cell */
-            cell *temp = c;
-            c = c->next;
-
-            if (is_symbol){ /* if the table stores symbols, use the special method to free it */
-                free_symbol((Symbol *)temp->value);
-            } else { /* else, free the value of the cell */
-                free(temp->value);
-            }
+cell *install_hashed(char *key, unsigned int hashval, void *value, Table *table){
+    cell *ret = add_cell(key, hashval, table);
+    RETURN_IF_MEMORY_ALLOC_ERROR(ret, NULL)
+
+    ret->value = value;
+
+    return ret;
+}
 
-            free(temp->key); /* free the name of the cell, its key */
-            free(temp); /* free the cell itself */
+/* Input: a table and the new amount of slots.
+ * Output: returns 0 if succeeded, 1 otherwise.
+ *
+ * Algorithm: allocate the new slots (all empty), and re-insert every occupied slot of the old index using the hash
+ * value stored in it - the keys themselves are not touched. Then, free the old index and replace it with the new one.
+ */
+int grow_slots(Table *table, unsigned int new_size){
+    struct slot *slots = (struct slot *)counted_calloc(new_size, sizeof(struct slot)); /* the new index */
+    unsigned int mask = new_size - 1;
+    unsigned int i, j;
+
+    RETURN_IF_MEMORY_ALLOC_ERROR(slots, 1)
+
+    for (i = 0; i < table->size; i++){ /* move every occupied slot to the new index */
+        if (table->slots[i].index != 0){
+            for (j = table->slots[i].hashval & mask; slots[j].index != 0; j = (j + 1) & mask);
+            slots[j] = table->slots[i];
         }
     }
+
+    free(table->slots);
+    table->slots = slots;
+    table->size = new_size;
+
+    return 0;
 }
 
-/* Input: a pointer to a symbol.
- * Output: returns nothing.
+/* Input: a table.
+ * Output: returns nothing. Frees all the memory used by the table.
  *
- * Algorithm: first, ensure the symbol is valid and no errors occurred during the program execution. Then, free its name.
- * If it is an .extern symbol, iterate through its usages to free them as well. In any case, free the symbol itself.
+ * Algorithm: if the keys and values of the table were allocated out of an arena, they are released with it. Otherwise,
+ * iterate through every cell of the table and free its key and its value. Then, free the cells and the index
+ * themselves and reset the table, so it may be used again - allocating out of the same arena.
  */
-void free_symbol(Symbol *symbol){
-    if (symbol == NULL || symbol->name == NULL){ /* ensure the properties were allocated successfully */
-        return;
+void free_table(Table *table){
+    Arena *arena = table->arena; /* kept for the next use of the table */
+    unsigned int i; /* used in the for loop */
+
+    for (i = 0; arena == NULL && i < table->count; i++) { /* go through the cells of a table that owns them */
+        free(table->cells[i].value);
+        free(table->cells[i].key); /* free the name of the cell, its key */
     }
 
-    free(symbol->name); /* free the name of the symbol */
+    free(table->cells);
+    free(table->slots);
+    memset(table, 0, sizeof(Table)); /* mark the table as empty */
+    table->arena = arena;
+}
 
-    /* if the symbol is a .extern one, iterate through its usages and free them all */
-    if (symbol->isExternal == true){
-        Usage *usage = symbol->usage; /* get the first usage */
-        Usage *curUsage = usage; /* a variable to be used to go through the usages */
+/* Input: a table.
+ * Output: returns the length of the longest probe sequence in the table.
+ *
+ * Algorithm: for every occupied slot, count the slots from the home slot of its key up to and including the slot
+ * itself - wrapping around the end of the index. Return the longest count.
+ */
+unsigned int max_probe_length(Table *table){
+    unsigned int i, length, longest = 0;
 
-        while (usage != NULL){ /* free all the usages */
-            curUsage = usage->next; /* hold the next usage */
-            free(usage); /* free the current usage */
-            usage = curUsage; /* proceed to the next usage */
+    for (i = 0; i < table->size; i++){
+        if (table->slots[i].index != 0){
+            length = ((i - table->slots[i].hashval) & (table->size - 1)) + 1; /* the distance from the home slot */
+            longest = (length > longest) ? length : longest;
         }
     }
 
-    free(symbol); /* free the symbol itself */
+    return longest;
 }
-
@@ -1,20 +1,41 @@
-/* acknowledgment: the functions are profoundly inspired by section 6.6 in the book "The C programming language"
- * by Dennis M. Ritchie and Brian W. Kernighan */
+/* acknowledgment: the functions are inspired by section 6.6 in the book "The C programming language"
+ * by Dennis M. Ritchie and Brian W. Kernighan. The chained buckets of the book were replaced with open addressing
+ * (linear probing), so that a lookup stays O(1) no matter how many symbols a program defines. */
 
-#define TABLE_SIZE 50
+#include "arena.h"
+
+/* the amount of slots allocated for a table on its first insertion - must be a power of 2 */
+#define TABLE_INITIAL_SIZE 64
+
+/* the table grows (doubles its slots) when more than LOAD_NUMERATOR/LOAD_DENOMINATOR of the slots are occupied */
+#define LOAD_NUMERATOR 7
+#define LOAD_DENOMINATOR 10
 
 /* a cell in the table */
 struct cell{
-    struct cell *next; /* to hold the next cell in case of duplicate items with the same hash value */
     char *key; /* the key of the cell, to be searched by */
     void *value; /* to hold the value of the key - it will be a struct */
 };
 
 typedef struct cell cell;
 
-/* the table - an array of cells */
+/* a slot of the open-addressing index. It stores the full hash value of its key, so that probing compares keys
+ * only when the hash values are equal */
+struct slot{
+    unsigned int hashval; /* the full hash value of the key stored in the slot */
+    unsigned int index; /* the index of the cell in the cells array plus 1. 0 marks an empty slot */
+};
+
+/* the table - a dense array of cells, in the order they were installed, and an open-addressing index into it.
+ * A table filled with zeros is a valid empty table, which owns its keys and values. A table with an arena allocates
+ * its keys out of the arena, and leaves them and its values to be released with it */
 struct Table{
-    cell *storage[TABLE_SIZE];
+    cell *cells; /* the cells of the table, in order of insertion */
+    unsigned int count; /* the amount of cells in the table */
+    unsigned int cells_size; /* the amount of cells allocated */
+    struct slot *slots; /* the open-addressing index */
+    unsigned int size; /* the amount of slots - always 0 or a power of 2 */
+    Arena *arena; /* the arena of the keys and values, or NULL if the table owns them */
 };
 
 typedef struct Table Table;
@@ -22,18 +43,41 @@ typedef struct Table Table;
 /* Input: a string.
  * Output: hashes the string and returns the hash value.
  *
- * This function hashes a received string based on the hash size to store it in a table.
+ * This function hashes a received string and returns the full hash value. The table reduces it to its size.
  */
 unsigned int hash(char *s);
 
+/* Input: a string that is not necessarily terminated, and its length.
+ * Output: hashes the string and returns the hash value.
+ *
+ * This function hashes the first length chars of the received string, the same way hash() hashes a whole string.
+ */
+unsigned int hash_n(char *s, unsigned int length);
+
 /* Input: a table and a key to search in it.
  * Output: returns the value - the cell - of the received key. If there isn't such a cell, NULL is returned.
  *
  * This function receives a table and a key to search in it, and returns the corresponding cell. If the key is not
- * found, NULL is returned.
+ * found, NULL is returned. The returned cell is valid until the next insertion to the table.
  */
 cell *lookup(char *s, Table *table);
 
+/* Input: a table, a key that is not necessarily terminated, and its length.
+ * Output: returns the cell of the key made of the first length chars of s. If there isn't such a cell, NULL is returned.
+ *
+ * This function searches the table like lookup(), for a key that is a part of a longer string - such as a token read
+ * in place from a line of the source file. The returned cell is valid until the next insertion to the table.
+ */
+cell *lookup_n(char *s, unsigned int length, Table *table);
+
+/* Input: a table, a key that is not necessarily terminated, its length and its hash value, as hash_n returns it.
+ * Output: returns the cell of the key. If there isn't such a cell, NULL is returned.
+ *
+ * This function searches the table like lookup_n(), with a hash value computed by the caller - who may use it again to
+ * install the key.
+ */
+cell *lookup_hashed(char *s, unsigned int length, unsigned int hashval, Table *table);
+
 /* Input: a string as a key, a value, the table to which the row should be added.
  * Output: returns the created cell in the table.
  *
@@ -41,9 +85,26 @@ cell *lookup(char *s, Table *table);
  */
 cell *install(char *key, void *value, Table *table);
 
-/* Input: a table and an integer indicating whether the table contains symbols.
+/* Input: a key that isn't in the table yet, its hash value as hash() returns it, a value, and a table with an arena.
+ * Output: returns the created cell in the table, or NULL if memory allocation failed.
+ *
+ * This function adds a cell to the table like install(), without searching the table or hashing the key again. The
+ * key itself is kept in the cell - not copied - so it must be allocated out of the arena of the table.
+ */
+cell *install_hashed(char *key, unsigned int hashval, void *value, Table *table);
+
+/* Input: a table.
+ * Output: returns the length of the longest probe sequence in the table.
+ *
+ * This function returns the most slots a successful lookup in the table goes over - the open-addressing counterpart
+ * of the longest chain of a chained table. 0 is returned for an empty table.
+ */
+unsigned int max_probe_length(Table *table);
+
+/* Input: a table.
  * Output: returns nothing. Frees all the memory used by the table.
  *
- * This function receives a table and free all the dynamically-allocated memory it uses.
+ * This function receives a table and free all the dynamically-allocated memory it uses - but not the keys and values
+ * of a table with an arena. The table is left empty, ready to be used again.
  */
-void free_table(Table *table, int is_symbol);
\ No newline at end of file
+void free_table(Table *table);
\ No newline at end of file